@@ -0,0 +1,270 @@
+#include "bench_report.hpp"
+#include "bench_scene.hpp"
+#include "render/render.hpp"
+#include "model/model.hpp"
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+
+// lunar_bench: 摄像机沿场景描述中的样条飞行固定的帧数, 统计CPU与GPU帧时间, 绘制数量与三角形数,
+// 结果写成JSON, 可以与之前的结果比较. 默认使用无头的EGL上下文, 不需要显示器
+namespace {
+
+struct BenchOptions {
+    std::string scene_path{"../modules/config/bench.yaml"};
+    std::string output_path{"bench.json"};
+    std::string compare_path;
+    std::string backend;
+    std::string capture_directory;
+    int frames{0};
+    int warmup_frames{-1};
+    float threshold{-1.0f};
+};
+
+void printUsage() {
+    std::cerr << "usage: lunar_bench [scene.yaml] [options]\n"
+                 "  --output <path>        write the JSON report here (default bench.json)\n"
+                 "  --compare <path>       compare against a baseline report, exit 1 on regression\n"
+                 "  --threshold <ratio>    allowed relative increase for every timing metric\n"
+                 "  --frames <n>           measured frames, overrides the scene\n"
+                 "  --warmup <n>           warmup frames, overrides the scene\n"
+                 "  --backend <name>       egl (default), osmesa or window\n"
+                 "  --capture <directory>  save every measured frame as PNG, adds one readback per frame\n";
+}
+
+bool parseArguments(int argc, char** argv, BenchOptions& options) {
+    for (int i = 1; i < argc; i++) {
+        const std::string argument = argv[i];
+        const auto value = [&]() -> const char* {
+            return i + 1 < argc ? argv[++i] : nullptr;
+        };
+        const char* next = nullptr;
+        if (argument == "--help" || argument == "-h") {
+            return false;
+        } else if (argument == "--output") {
+            if (!(next = value())) return false;
+            options.output_path = next;
+        } else if (argument == "--compare") {
+            if (!(next = value())) return false;
+            options.compare_path = next;
+        } else if (argument == "--threshold") {
+            if (!(next = value())) return false;
+            options.threshold = std::stof(next);
+        } else if (argument == "--frames") {
+            if (!(next = value())) return false;
+            options.frames = std::stoi(next);
+        } else if (argument == "--warmup") {
+            if (!(next = value())) return false;
+            options.warmup_frames = std::stoi(next);
+        } else if (argument == "--backend") {
+            if (!(next = value())) return false;
+            options.backend = next;
+        } else if (argument == "--capture") {
+            if (!(next = value())) return false;
+            options.capture_directory = next;
+        } else if (!argument.empty() && argument[0] != '-') {
+            options.scene_path = argument;
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+const char* getBackendName(lunar::WindowBackend backend) {
+    switch (backend) {
+        case lunar::WindowBackend::HeadlessEGL:    return "egl";
+        case lunar::WindowBackend::HeadlessOSMesa: return "osmesa";
+        default:                                   return "window";
+    }
+}
+
+uint64_t getCounterDelta(const lunar::FrameCounters::Snapshot& before, const lunar::FrameCounters::Snapshot& after,
+                         lunar::FrameCounter counter) {
+    const size_t index = static_cast<size_t>(counter);
+    return after[index] - before[index];
+}
+
+}
+
+int main(int argc, char** argv) {
+    BenchOptions options;
+    try {
+        if (!parseArguments(argc, argv, options)) {
+            printUsage();
+            return 2;
+        }
+    } catch (const std::exception&) {
+        printUsage();
+        return 2;
+    }
+
+    lunar::BenchScene scene;
+    auto& window = lunar::Window::getInstance();
+    auto& settings = lunar::RenderSettings::getInstance();
+    try {
+        scene = lunar::BenchScene::load(options.scene_path);
+        if (options.frames > 0) scene.frames = options.frames;
+        if (options.warmup_frames >= 0) scene.warmup_frames = options.warmup_frames;
+        window.setBackend(options.backend.empty() ? lunar::WindowBackend::HeadlessEGL : lunar::Window::parseBackend(options.backend));
+        window.init(scene.width, scene.height, "lunar bench");
+        settings.load(scene.config_path);
+    } catch (const std::exception& e) {
+        std::cerr << "Failed to initialize benchmark, error: " << e.what() << std::endl;
+        return 2;
+    }
+    // 窗口模式下也不等垂直同步
+    glfwSwapInterval(0);
+
+    glEnable(GL_DEPTH_TEST);
+    glEnable(GL_CULL_FACE);
+
+    // 动态分辨率会让不同次运行的工作量不同, 基准测试中始终关闭
+    lunar::PostProcesser postprocesser(settings.compute_blur ? lunar::BlurMode::Compute : lunar::BlurMode::Fragment);
+    postprocesser.configure(settings.post_process);
+    postprocesser.setAntiAliasing(settings.anti_aliasing);
+    // 与主程序相同的着色器, 光源与按渲染设置开启的功能
+    lunar::SceneRenderer scene_renderer(postprocesser);
+    std::vector<std::unique_ptr<lunar::Model>> models;
+    try {
+        for (const std::string& path : scene.models) {
+            models.push_back(std::make_unique<lunar::Model>(path));
+            scene_renderer.addModel(*models.back());
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Failed to load benchmark scene, error: " << e.what() << std::endl;
+        return 2;
+    }
+    lunar::RenderGraph frame_graph;
+    lunar::GpuFrameTimer gpu_timer;
+    lunar::Camera camera(glm::vec3(0.0f));
+    std::unique_ptr<lunar::FrameCapture> frame_capture;
+    if (!options.capture_directory.empty()) {
+        frame_capture = std::make_unique<lunar::FrameCapture>();
+        frame_capture->setOutput(options.capture_directory, lunar::CaptureFormat::PNG, scene.name);
+    }
+
+    const int total_frames = scene.warmup_frames + scene.frames;
+    std::vector<float> cpu_ms, frame_ms, gpu_ms, draw_calls, triangles;
+    cpu_ms.reserve(scene.frames);
+    frame_ms.reserve(scene.frames);
+    gpu_ms.reserve(scene.frames);
+    draw_calls.reserve(scene.frames);
+    triangles.reserve(scene.frames);
+    // GPU结果按发出的顺序读回, 第n个结果属于第n帧
+    int gpu_results = 0;
+    const auto collectGpuTime = [&](float milliseconds) {
+        if (gpu_results++ >= scene.warmup_frames) gpu_ms.push_back(milliseconds);
+    };
+
+    std::cout << "Running " << scene.name << ": " << scene.warmup_frames << " warmup + " << scene.frames
+              << " frames at " << window.getWidth() << "x" << window.getHeight()
+              << " (" << getBackendName(window.getBackend()) << ", "
+              << reinterpret_cast<const char*>(glGetString(GL_RENDERER)) << ")" << std::endl;
+
+    for (int frame = 0; frame < total_frames && !window.shouldClose(); frame++) {
+        const auto frame_begin = std::chrono::steady_clock::now();
+        const lunar::FrameCounters::Snapshot counters_before = lunar::FrameCounters::snapshot();
+        float milliseconds;
+        while (gpu_timer.poll(milliseconds)) collectGpuTime(milliseconds);
+        // 最多ring_size帧在途, 与交换链对CPU的限制类似; 无头模式下没有交换链, 否则CPU会无限超前
+        while (gpu_timer.getPendingCount() == lunar::GpuFrameTimer::ring_size) {
+            if (gpu_timer.poll(milliseconds)) collectGpuTime(milliseconds);
+        }
+        gpu_timer.begin();
+
+        // 预热时停在路径起点
+        const int measured = std::max(frame - scene.warmup_frames, 0);
+        const float t = scene.frames > 1 ? static_cast<float>(measured) / static_cast<float>(scene.frames - 1) : 0.0f;
+        scene.camera_path.apply(camera, t);
+        const float time = static_cast<float>(frame) * scene.time_step;
+
+        frame_graph.reset();
+        const lunar::RenderResource backbuffer = frame_graph.importFramebuffer("backbuffer", window.getFramebuffer(),
+            {GL_RGBA8, window.getWidth(), window.getHeight()});
+        // lookAt直接放置摄像机, 没有需要插值的上一位置
+        scene_renderer.addPasses(frame_graph, camera, 1.0f, time, backbuffer);
+
+        frame_graph.compile();
+        frame_graph.execute();
+        if (frame_capture && frame >= scene.warmup_frames) frame_capture->capture();
+        gpu_timer.end();
+        const auto cpu_end = std::chrono::steady_clock::now();
+        window.swapBuffers();
+        window.pollEvents();
+        const auto frame_end = std::chrono::steady_clock::now();
+        const lunar::FrameCounters::Snapshot counters_after = lunar::FrameCounters::snapshot();
+
+        if (frame < scene.warmup_frames) continue;
+        cpu_ms.push_back(std::chrono::duration<float, std::milli>(cpu_end - frame_begin).count());
+        frame_ms.push_back(std::chrono::duration<float, std::milli>(frame_end - frame_begin).count());
+        draw_calls.push_back(static_cast<float>(getCounterDelta(counters_before, counters_after, lunar::FrameCounter::DrawCalls)));
+        triangles.push_back(static_cast<float>(getCounterDelta(counters_before, counters_after, lunar::FrameCounter::Triangles)));
+    }
+    // 等最后几帧的GPU计时
+    glFinish();
+    float milliseconds;
+    while (gpu_timer.poll(milliseconds)) collectGpuTime(milliseconds);
+    if (frame_capture) {
+        frame_capture->flush();
+        std::cout << "Captured " << frame_capture->getEncodedCount() << " frames to " << options.capture_directory;
+        if (frame_capture->getDroppedCount()) std::cout << ", dropped " << frame_capture->getDroppedCount();
+        std::cout << std::endl;
+    }
+    if (const GLenum error = glGetError(); error != GL_NO_ERROR) {
+        std::cerr << "OpenGL error during benchmark: 0x" << std::hex << error << std::dec << std::endl;
+    }
+
+    lunar::BenchReport report;
+    report.setInfo("scene", scene.name);
+    report.setInfo("backend", getBackendName(window.getBackend()));
+    report.setInfo("renderer", reinterpret_cast<const char*>(glGetString(GL_RENDERER)));
+    report.setInfo("gl_version", reinterpret_cast<const char*>(glGetString(GL_VERSION)));
+    report.setInfo("width", window.getWidth());
+    report.setInfo("height", window.getHeight());
+    report.setInfo("warmup_frames", scene.warmup_frames);
+    report.setInfo("frames", static_cast<double>(cpu_ms.size()));
+    report.addMetric("cpu_ms", lunar::BenchStats::compute(cpu_ms));
+    report.addMetric("gpu_ms", lunar::BenchStats::compute(gpu_ms));
+    report.addMetric("frame_ms", lunar::BenchStats::compute(frame_ms));
+#if LUNAR_PROFILING
+    report.addMetric("draw_calls", lunar::BenchStats::compute(draw_calls));
+    report.addMetric("triangles", lunar::BenchStats::compute(triangles));
+#else
+    // 计数只在LUNAR_PROFILING打开时累加
+    std::cerr << "LUNAR_PROFILING is off, draw calls and triangles are not reported" << std::endl;
+#endif
+    std::cout << report.getSummary();
+
+    std::ofstream output(options.output_path);
+    report.writeJSON(output);
+    if (!output) {
+        std::cerr << "Failed to write benchmark report: " << options.output_path << std::endl;
+        return 2;
+    }
+    std::cout << "Report written to " << options.output_path << std::endl;
+
+    if (options.compare_path.empty()) return 0;
+    std::vector<lunar::BenchThreshold> thresholds = scene.thresholds;
+    if (options.threshold >= 0.0f) {
+        for (auto& threshold : thresholds) {
+            if (threshold.metric.size() > 3 && threshold.metric.compare(threshold.metric.size() - 3, 3, "_ms") == 0) {
+                threshold.max_increase = options.threshold;
+            }
+        }
+    }
+    std::vector<lunar::BenchComparison> comparisons;
+    try {
+        comparisons = report.compare(lunar::BenchReport::load(options.compare_path), thresholds);
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return 2;
+    }
+    std::cout << "Compared with " << options.compare_path << ":\n" << lunar::BenchReport::getComparisonSummary(comparisons);
+    const bool regressed = std::any_of(comparisons.begin(), comparisons.end(),
+                                       [](const lunar::BenchComparison& comparison) { return comparison.regressed; });
+    return regressed ? 1 : 0;
+}
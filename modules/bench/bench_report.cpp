@@ -0,0 +1,211 @@
+#include "bench_report.hpp"
+#include "profile/chrome_trace.hpp"
+#include <yaml-cpp/yaml.h>
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+
+namespace lunar {
+
+static float percentileOfSorted(const std::vector<float>& sorted, float p) {
+    const auto rank = static_cast<size_t>(std::ceil(p / 100.0f * static_cast<float>(sorted.size())));
+    return sorted[std::clamp<size_t>(rank, 1, sorted.size()) - 1];
+}
+
+BenchStats BenchStats::compute(std::vector<float> samples) {
+    BenchStats stats;
+    if (samples.empty()) return stats;
+    std::sort(samples.begin(), samples.end());
+    double sum = 0.0;
+    for (float sample : samples) sum += sample;
+    stats.count = samples.size();
+    stats.mean = static_cast<float>(sum / static_cast<double>(samples.size()));
+    stats.p50 = percentileOfSorted(samples, 50.0f);
+    stats.p95 = percentileOfSorted(samples, 95.0f);
+    stats.p99 = percentileOfSorted(samples, 99.0f);
+    stats.max = samples.back();
+    return stats;
+}
+
+float BenchStats::get(const std::string& stat) const {
+    if (stat == "p50") return p50;
+    if (stat == "p95") return p95;
+    if (stat == "p99") return p99;
+    if (stat == "max") return max;
+    if (stat == "mean") return mean;
+    throw std::runtime_error("Unknown benchmark statistic: " + stat);
+}
+
+static std::string quoteJSON(const std::string& text) {
+    std::ostringstream out;
+    writeJSONString(out, text);
+    return out.str();
+}
+
+static std::string formatNumber(double value) {
+    std::ostringstream out;
+    out << std::setprecision(6) << value;
+    return out.str();
+}
+
+static void setPair(std::vector<std::pair<std::string, std::string>>& pairs, const std::string& key, std::string value) {
+    for (auto& pair : pairs) {
+        if (pair.first == key) {
+            pair.second = std::move(value);
+            return;
+        }
+    }
+    pairs.emplace_back(key, std::move(value));
+}
+
+void BenchReport::setInfo(const std::string& key, const std::string& value) {
+    setPair(info, key, quoteJSON(value));
+}
+
+void BenchReport::setInfo(const std::string& key, double value) {
+    setPair(info, key, formatNumber(value));
+}
+
+void BenchReport::addMetric(const std::string& name, const BenchStats& stats) {
+    for (auto& metric : metrics) {
+        if (metric.first == name) {
+            metric.second = stats;
+            return;
+        }
+    }
+    metrics.emplace_back(name, stats);
+}
+
+const BenchStats* BenchReport::findMetric(const std::string& name) const {
+    for (const auto& metric : metrics) {
+        if (metric.first == name) return &metric.second;
+    }
+    return nullptr;
+}
+
+void BenchReport::writeJSON(std::ostream& out) const {
+    out << "{\n  \"info\": {";
+    for (size_t i = 0; i < info.size(); i++) {
+        out << (i ? ",\n    " : "\n    ") << quoteJSON(info[i].first) << ": " << info[i].second;
+    }
+    out << (info.empty() ? "},\n" : "\n  },\n") << "  \"metrics\": {";
+    for (size_t i = 0; i < metrics.size(); i++) {
+        const BenchStats& stats = metrics[i].second;
+        out << (i ? ",\n    " : "\n    ") << quoteJSON(metrics[i].first) << ": {"
+            << "\"count\": " << stats.count
+            << ", \"mean\": " << formatNumber(stats.mean)
+            << ", \"p50\": " << formatNumber(stats.p50)
+            << ", \"p95\": " << formatNumber(stats.p95)
+            << ", \"p99\": " << formatNumber(stats.p99)
+            << ", \"max\": " << formatNumber(stats.max) << "}";
+    }
+    out << (metrics.empty() ? "}\n" : "\n  }\n") << "}\n";
+}
+
+BenchReport BenchReport::load(const std::string& path) {
+    // JSON是YAML的子集, 直接用yaml-cpp读取
+    YAML::Node root;
+    try {
+        root = YAML::LoadFile(path);
+    } catch (const YAML::Exception& e) {
+        throw std::runtime_error("Failed to read benchmark report " + path + ": " + e.what());
+    }
+    BenchReport report;
+    if (const YAML::Node info = root["info"]) {
+        for (const auto& item : info) {
+            const std::string value = item.second.as<std::string>("");
+            double number;
+            if (YAML::convert<double>::decode(item.second, number)) report.setInfo(item.first.as<std::string>(), number);
+            else report.setInfo(item.first.as<std::string>(), value);
+        }
+    }
+    const YAML::Node metrics = root["metrics"];
+    if (!metrics || !metrics.IsMap()) {
+        throw std::runtime_error("Benchmark report has no metrics: " + path);
+    }
+    for (const auto& item : metrics) {
+        const YAML::Node node = item.second;
+        BenchStats stats;
+        stats.count = node["count"].as<size_t>(0);
+        stats.mean = node["mean"].as<float>(0.0f);
+        stats.p50 = node["p50"].as<float>(0.0f);
+        stats.p95 = node["p95"].as<float>(0.0f);
+        stats.p99 = node["p99"].as<float>(0.0f);
+        stats.max = node["max"].as<float>(0.0f);
+        report.addMetric(item.first.as<std::string>(), stats);
+    }
+    return report;
+}
+
+std::vector<BenchComparison> BenchReport::compare(const BenchReport& baseline,
+                                                  const std::vector<BenchThreshold>& thresholds) const {
+    std::vector<BenchComparison> comparisons;
+    for (const BenchThreshold& threshold : thresholds) {
+        BenchComparison comparison;
+        comparison.threshold = threshold;
+        const BenchStats* current_stats = findMetric(threshold.metric);
+        const BenchStats* baseline_stats = baseline.findMetric(threshold.metric);
+        if (!current_stats || !baseline_stats) {
+            comparison.missing = true;
+            comparisons.push_back(comparison);
+            continue;
+        }
+        comparison.current = current_stats->get(threshold.stat);
+        comparison.baseline = baseline_stats->get(threshold.stat);
+        comparison.regressed = comparison.current > comparison.baseline * (1.0f + threshold.max_increase)
+            && comparison.current - comparison.baseline > threshold.min_delta;
+        comparisons.push_back(comparison);
+    }
+    return comparisons;
+}
+
+std::string BenchReport::getSummary() const {
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(3);
+    out << std::left << std::setw(14) << "metric" << std::right
+        << std::setw(12) << "mean" << std::setw(12) << "p50" << std::setw(12) << "p95"
+        << std::setw(12) << "p99" << std::setw(12) << "max" << "\n";
+    for (const auto& [name, stats] : metrics) {
+        out << std::left << std::setw(14) << name << std::right
+            << std::setw(12) << stats.mean << std::setw(12) << stats.p50 << std::setw(12) << stats.p95
+            << std::setw(12) << stats.p99 << std::setw(12) << stats.max << "\n";
+    }
+    return out.str();
+}
+
+std::string BenchReport::getComparisonSummary(const std::vector<BenchComparison>& comparisons) {
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(3);
+    for (const BenchComparison& comparison : comparisons) {
+        const BenchThreshold& threshold = comparison.threshold;
+        out << (comparison.missing ? "SKIP " : comparison.regressed ? "FAIL " : "ok   ")
+            << threshold.metric << "." << threshold.stat;
+        if (comparison.missing) {
+            out << ": missing\n";
+            continue;
+        }
+        const float change = comparison.baseline != 0.0f ? (comparison.current / comparison.baseline - 1.0f) * 100.0f : 0.0f;
+        out << ": " << comparison.baseline << " -> " << comparison.current
+            << " (" << std::showpos << change << std::noshowpos << "%, limit +"
+            << threshold.max_increase * 100.0f << "%)\n";
+    }
+    return out.str();
+}
+
+std::vector<BenchThreshold> BenchReport::getDefaultThresholds() {
+    // 尾部的百分位抖动更大, 允许的涨幅也更大; 绘制数量与三角形数是确定的, 不允许增加
+    return {
+        {"cpu_ms", "p50", 0.10f, 0.05f},
+        {"cpu_ms", "p95", 0.15f, 0.10f},
+        {"cpu_ms", "p99", 0.25f, 0.20f},
+        {"gpu_ms", "p50", 0.10f, 0.05f},
+        {"gpu_ms", "p95", 0.15f, 0.10f},
+        {"gpu_ms", "p99", 0.25f, 0.20f},
+        {"draw_calls", "max", 0.0f, 0.0f},
+        {"triangles", "max", 0.0f, 0.0f},
+    };
+}
+
+}
@@ -0,0 +1,64 @@
+#pragma once
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace lunar {
+
+// 一组样本的分布, 百分位用最近邻排名法(与TimingHistory相同)
+struct BenchStats {
+    size_t count{0};
+    float mean{0.0f};
+    float p50{0.0f}, p95{0.0f}, p99{0.0f};
+    float max{0.0f};
+
+    static BenchStats compute(std::vector<float> samples);
+    // "p50", "p95", "p99", "max", "mean"; 未知的名字抛出异常
+    [[nodiscard]] float get(const std::string& stat) const;
+};
+
+// 回归判定: 当前值超过基线的(1 + max_increase)倍, 且绝对差超过min_delta时视为回归.
+// min_delta避免极短的耗时因为抖动被误判
+struct BenchThreshold {
+    std::string metric;
+    std::string stat{"p95"};
+    float max_increase{0.1f};
+    float min_delta{0.0f};
+};
+
+struct BenchComparison {
+    BenchThreshold threshold;
+    float baseline{0.0f}, current{0.0f};
+    bool regressed{false};
+    bool missing{false};  // 基线中没有这一项, 不参与判定
+};
+
+// 基准测试结果: 描述运行环境的键值与各项指标的分布, 写成JSON供脚本读取, 也可以读回作为基线比较
+class BenchReport {
+public:
+    void setInfo(const std::string& key, const std::string& value);
+    void setInfo(const std::string& key, double value);
+    void addMetric(const std::string& name, const BenchStats& stats);
+
+    [[nodiscard]] const BenchStats* findMetric(const std::string& name) const;
+    [[nodiscard]] const std::vector<std::pair<std::string, BenchStats>>& getMetrics() const { return metrics; }
+
+    void writeJSON(std::ostream& out) const;
+    // 读回writeJSON写出的文件, 失败时抛出异常
+    static BenchReport load(const std::string& path);
+
+    [[nodiscard]] std::vector<BenchComparison> compare(const BenchReport& baseline,
+                                                       const std::vector<BenchThreshold>& thresholds) const;
+    // 人类可读的统计表与比较结果
+    [[nodiscard]] std::string getSummary() const;
+    static std::string getComparisonSummary(const std::vector<BenchComparison>& comparisons);
+    static std::vector<BenchThreshold> getDefaultThresholds();
+
+private:
+    // 值已经是JSON字面量(带引号的字符串或数字)
+    std::vector<std::pair<std::string, std::string>> info;
+    std::vector<std::pair<std::string, BenchStats>> metrics;
+};
+
+}
@@ -0,0 +1,65 @@
+#include "bench_scene.hpp"
+#include <yaml-cpp/yaml.h>
+#include <stdexcept>
+
+namespace lunar {
+
+static glm::vec3 readVec3(const YAML::Node& node, const std::string& what) {
+    if (!node || !node.IsSequence() || node.size() != 3) {
+        throw std::runtime_error("Benchmark scene: " + what + " must be [x, y, z]");
+    }
+    return glm::vec3(node[0].as<float>(), node[1].as<float>(), node[2].as<float>());
+}
+
+BenchScene BenchScene::load(const std::string& path) {
+    YAML::Node root;
+    try {
+        root = YAML::LoadFile(path);
+    } catch (const YAML::Exception& e) {
+        throw std::runtime_error("Failed to read benchmark scene " + path + ": " + e.what());
+    }
+    const YAML::Node bench = root["bench"];
+    if (!bench) {
+        throw std::runtime_error("Benchmark scene has no bench section: " + path);
+    }
+
+    BenchScene scene;
+    scene.name = bench["name"].as<std::string>(scene.name);
+    scene.config_path = bench["config"].as<std::string>(scene.config_path);
+    scene.width = bench["width"].as<int>(scene.width);
+    scene.height = bench["height"].as<int>(scene.height);
+    scene.warmup_frames = bench["warmup_frames"].as<int>(scene.warmup_frames);
+    scene.frames = bench["frames"].as<int>(scene.frames);
+    scene.time_step = bench["time_step"].as<float>(scene.time_step);
+    for (const auto& model : bench["models"]) {
+        scene.models.push_back(model.as<std::string>());
+    }
+    if (scene.models.empty()) {
+        throw std::runtime_error("Benchmark scene has no models: " + path);
+    }
+
+    const YAML::Node camera = bench["camera_path"];
+    scene.camera_path.setLoop(camera["loop"].as<bool>(false));
+    for (const auto& keyframe : camera["keyframes"]) {
+        scene.camera_path.addKeyframe({readVec3(keyframe["position"], "keyframe position"),
+                                       readVec3(keyframe["target"], "keyframe target")});
+    }
+    if (scene.camera_path.empty()) {
+        throw std::runtime_error("Benchmark scene has no camera keyframes: " + path);
+    }
+
+    if (const YAML::Node thresholds = bench["thresholds"]) {
+        scene.thresholds.clear();
+        for (const auto& item : thresholds) {
+            BenchThreshold threshold;
+            threshold.metric = item["metric"].as<std::string>();
+            threshold.stat = item["stat"].as<std::string>(threshold.stat);
+            threshold.max_increase = item["max_increase"].as<float>(threshold.max_increase);
+            threshold.min_delta = item["min_delta"].as<float>(threshold.min_delta);
+            scene.thresholds.push_back(threshold);
+        }
+    }
+    return scene;
+}
+
+}
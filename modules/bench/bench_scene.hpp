@@ -0,0 +1,28 @@
+#pragma once
+#include "bench_report.hpp"
+#include "render/camera_path.hpp"
+#include <string>
+#include <vector>
+
+namespace lunar {
+
+// 基准测试的场景描述, 见modules/config/bench.yaml
+struct BenchScene {
+    std::string name{"bench"};
+    // 渲染设置(render_settings)从这个文件读取
+    std::string config_path{"../modules/config/interface.yaml"};
+    std::vector<std::string> models;
+    int width{1280}, height{720};
+    // 预热的帧不计入统计, 着色器编译, 纹理上传等只发生在最初几帧
+    int warmup_frames{30};
+    int frames{600};
+    // 场景动画(光源等)按固定步长推进, 与实际帧时间无关
+    float time_step{1.0f / 60.0f};
+    CameraPath camera_path;
+    std::vector<BenchThreshold> thresholds{BenchReport::getDefaultThresholds()};
+
+    // 失败时抛出异常
+    static BenchScene load(const std::string& path);
+};
+
+}
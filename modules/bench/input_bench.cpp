@@ -0,0 +1,113 @@
+#include "interface/interface.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <iterator>
+#include <iostream>
+#include <map>
+#include <string>
+
+// lunar_input_bench: 每个输入事件的分发开销. 与原来的做法(std::map查找两次, 拷贝
+// std::pair<std::function, mods>再调用std::bind)对比, 不需要窗口与GL上下文
+namespace {
+
+struct Counter {
+    uint64_t value{0};
+    void onEvent(const lunar::Event& event) { value += event.data.key.action; }
+};
+
+lunar::Event makeKeyEvent(uint64_t index) {
+    // 轮流使用几个绑定了回调的按键与一个没有绑定的按键
+    static constexpr unsigned short keys[] = {GLFW_KEY_W, GLFW_KEY_A, GLFW_KEY_S, GLFW_KEY_D, GLFW_KEY_X};
+    const unsigned short key = keys[index % std::size(keys)];
+    return {.type = lunar::EventType::KEY, .mods = 0, .data = {.key = {.key = key, .scancode = 0, .action = GLFW_PRESS, .mods = 0}}};
+}
+
+template <typename Function>
+double measureNanoseconds(uint64_t count, Function&& function) {
+    const auto begin = std::chrono::steady_clock::now();
+    function();
+    const auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(end - begin).count() / static_cast<double>(count);
+}
+
+struct QueueTiming {
+    double push_ns{0.0}, dispatch_ns{0.0};
+};
+
+// 成批推入再分发, 推入(含取时间戳)与分发分别计时
+template <typename MakeEvent>
+QueueTiming measureQueue(lunar::Interface& interface, uint64_t count, MakeEvent&& make_event) {
+    using clock = std::chrono::steady_clock;
+    clock::duration push{}, dispatch{};
+    for (uint64_t i = 0; i < count;) {
+        const uint64_t end = std::min(i + lunar::Interface::event_queue_capacity, count);
+        const auto begin = clock::now();
+        for (; i < end; i++) interface.pushEvent(make_event(i));
+        const auto pushed = clock::now();
+        interface.dispatchEvents();
+        dispatch += clock::now() - pushed;
+        push += pushed - begin;
+    }
+    const auto toNanoseconds = [count](clock::duration duration) {
+        return std::chrono::duration<double, std::nano>(duration).count() / static_cast<double>(count);
+    };
+    return {toNanoseconds(push), toNanoseconds(dispatch)};
+}
+
+}
+
+int main(int argc, char** argv) {
+    const uint64_t event_count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 10000000;
+    if (event_count == 0) {
+        std::cerr << "usage: lunar_input_bench [event count]" << std::endl;
+        return 2;
+    }
+    constexpr unsigned short bound_keys[] = {GLFW_KEY_W, GLFW_KEY_A, GLFW_KEY_S, GLFW_KEY_D};
+
+    // 原来的分发方式
+    Counter map_counter;
+    std::map<unsigned short, std::pair<std::function<void(const lunar::Event&)>, unsigned short>> map_callbacks;
+    for (const unsigned short key : bound_keys) {
+        map_callbacks[key] = std::make_pair(std::bind(&Counter::onEvent, &map_counter, std::placeholders::_1), 0);
+    }
+    const double map_ns = measureNanoseconds(event_count, [&] {
+        for (uint64_t i = 0; i < event_count; i++) {
+            const lunar::Event event = makeKeyEvent(i);
+            if (map_callbacks.find(event.data.key.key) != map_callbacks.end()) {
+                auto callback_with_mod = map_callbacks[event.data.key.key];
+                if ((callback_with_mod.second & event.data.key.mods) == callback_with_mod.second) callback_with_mod.first(event);
+            }
+        }
+    });
+
+    // 现在的分发表
+    Counter table_counter;
+    auto& interface = lunar::Interface::getInstance();
+    for (const unsigned short key : bound_keys) {
+        interface.bindCallback(key, lunar::EventCallbackFunction::fromMethod<&Counter::onEvent>(&table_counter));
+    }
+    const QueueTiming table = measureQueue(interface, event_count, makeKeyEvent);
+
+    // 同一个按键上挂四个回调
+    Counter multi_counter;
+    interface.clearCallbacks();
+    for (int priority = 0; priority < 4; priority++) {
+        interface.bindCallback(GLFW_KEY_W, lunar::EventCallbackFunction::fromMethod<&Counter::onEvent>(&multi_counter), 0, priority);
+    }
+    const QueueTiming multi = measureQueue(interface, event_count, [](uint64_t) { return makeKeyEvent(0); });
+    interface.clearCallbacks();
+
+    if (map_counter.value != table_counter.value || interface.getDroppedEventCount() != 0) {
+        std::cerr << "Dispatch results differ: " << map_counter.value << " vs " << table_counter.value
+                  << ", dropped " << interface.getDroppedEventCount() << std::endl;
+        return 1;
+    }
+    std::cout << event_count << " key events, 4 of 5 keys bound\n"
+              << "  std::map + std::function copy:  " << map_ns << " ns/event\n"
+              << "  dense dispatch table:           " << table.dispatch_ns << " ns/event\n"
+              << "  4 listeners on one key:         " << multi.dispatch_ns << " ns/event (" << multi_counter.value << " calls)\n"
+              << "  queue push with timestamp:      " << table.push_ns << " ns/event\n";
+    return 0;
+}
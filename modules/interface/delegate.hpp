@@ -0,0 +1,81 @@
+#pragma once
+#include <cstddef>
+#include <cstring>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace lunar {
+
+template <typename Signature, size_t BufferSize = 32>
+class Delegate;
+
+// 不分配内存的可调用对象: 函数对象就地存放在buffer_size字节的缓冲里, 放不下时编译失败.
+// 调用只经过一次函数指针, 没有std::function的类型擦除开销与堆分配
+template <typename Result, typename... Args, size_t BufferSize>
+class Delegate<Result(Args...), BufferSize> {
+public:
+    static constexpr size_t buffer_size = BufferSize;
+
+    Delegate() = default;
+    Delegate(std::nullptr_t) {}
+
+    template <typename Function, typename = std::enable_if_t<!std::is_same_v<std::decay_t<Function>, Delegate> &&
+                                                             std::is_invocable_v<std::decay_t<Function>&, Args...>>>
+    Delegate(Function&& function) {
+        using Stored = std::decay_t<Function>;
+        static_assert(sizeof(Stored) <= buffer_size, "callable is too large for the delegate buffer");
+        static_assert(alignof(Stored) <= alignof(std::max_align_t), "callable is over-aligned");
+        new (buffer) Stored(std::forward<Function>(function));
+        invoker = [](const void* storage, Args... args) -> Result {
+            return std::invoke(*static_cast<Stored*>(const_cast<void*>(storage)), std::forward<Args>(args)...);
+        };
+        if constexpr (!std::is_trivially_copyable_v<Stored> || !std::is_trivially_destructible_v<Stored>) {
+            manager = [](void* destination, const void* source) {
+                if (source) new (destination) Stored(*static_cast<const Stored*>(source));
+                else static_cast<Stored*>(destination)->~Stored();
+            };
+        }
+    }
+
+    // 绑定成员函数, 只保存对象指针: Delegate<void(const Event&)>::fromMethod<&Camera::rotate>(&camera)
+    template <auto Method, typename Object>
+    static Delegate fromMethod(Object* object) {
+        return Delegate([object](Args... args) -> Result { return (object->*Method)(std::forward<Args>(args)...); });
+    }
+
+    Delegate(const Delegate& other) { copyFrom(other); }
+    Delegate& operator=(const Delegate& other) {
+        if (this != &other) {
+            reset();
+            copyFrom(other);
+        }
+        return *this;
+    }
+    ~Delegate() { reset(); }
+
+    Result operator()(Args... args) const { return invoker(buffer, std::forward<Args>(args)...); }
+    explicit operator bool() const { return invoker != nullptr; }
+
+    void reset() {
+        if (manager) manager(buffer, nullptr);
+        invoker = nullptr;
+        manager = nullptr;
+    }
+
+private:
+    void copyFrom(const Delegate& other) {
+        invoker = other.invoker;
+        manager = other.manager;
+        if (manager) manager(buffer, other.buffer);
+        else if (invoker) std::memcpy(buffer, other.buffer, buffer_size);
+    }
+
+    alignas(std::max_align_t) unsigned char buffer[buffer_size]{};
+    Result (*invoker)(const void*, Args...){nullptr};
+    // source为空时析构destination, 否则拷贝构造; 可平凡拷贝的函数对象为空
+    void (*manager)(void* destination, const void* source){nullptr};
+};
+
+}
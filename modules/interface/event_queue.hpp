@@ -0,0 +1,56 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace lunar {
+
+// 单生产者单消费者的无锁环形队列, 生产者为GLFW回调所在的线程, 消费者为游戏或模拟线程.
+// 写满时丢弃新的元素并计数, 两端都不加锁也不分配内存. capacity必须是2的幂
+template <typename T, size_t Capacity>
+class SpscQueue {
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "capacity must be a power of two");
+public:
+    static constexpr size_t capacity = Capacity;
+
+    // 只能由生产者调用
+    bool push(const T& value) {
+        const uint64_t write = head.load(std::memory_order_relaxed);
+        if (write - cached_tail >= capacity) {
+            cached_tail = tail.load(std::memory_order_acquire);
+            if (write - cached_tail >= capacity) {
+                dropped.store(dropped.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+                return false;
+            }
+        }
+        items[write & (capacity - 1)] = value;
+        head.store(write + 1, std::memory_order_release);
+        return true;
+    }
+    // 只能由消费者调用, 最多取出max_count个到out, 返回取出的数量
+    size_t pop(T* out, size_t max_count) {
+        const uint64_t read = tail.load(std::memory_order_relaxed);
+        const uint64_t write = head.load(std::memory_order_acquire);
+        size_t count = static_cast<size_t>(write - read);
+        if (count > max_count) count = max_count;
+        for (size_t i = 0; i < count; i++) out[i] = items[(read + i) & (capacity - 1)];
+        tail.store(read + count, std::memory_order_release);
+        return count;
+    }
+
+    [[nodiscard]] size_t size() const {
+        return static_cast<size_t>(head.load(std::memory_order_acquire) - tail.load(std::memory_order_acquire));
+    }
+    [[nodiscard]] bool empty() const { return size() == 0; }
+    [[nodiscard]] uint64_t getDroppedCount() const { return dropped.load(std::memory_order_relaxed); }
+
+private:
+    // 生产者与消费者的计数各占一条缓存行, 避免伪共享
+    alignas(64) std::atomic<uint64_t> head{0};
+    uint64_t cached_tail{0};
+    std::atomic<uint64_t> dropped{0};
+    alignas(64) std::atomic<uint64_t> tail{0};
+    alignas(64) T items[capacity];
+};
+
+}
@@ -1,7 +1,12 @@
 #include "interface.hpp"
 #include "fmt/format.h"
+#include "profile/clock.hpp"
+#include "profile/profile_scope.hpp"
 #include <yaml-cpp/yaml.h>
+#include <algorithm>
 #include <iostream>
+#include <iterator>
+#include <set>
 #include <utility>
 
 namespace lunar {
@@ -13,13 +18,13 @@ namespace lunar {
                                 data.key.key,data.key.action,data.key.scancode,data.key.mods);
     case EventType::MOUSE_CLICK:
         return fmt::format("<mouse click: button:{}, x:{}, y:{}>",
-                                data.mouse_click.button,data.mouse_click.xpos,data.mouse_click.ypos);
+                                +data.mouse_click.button,+data.mouse_click.xpos,+data.mouse_click.ypos);
     case EventType::MOUSE_MOVE:
-        return fmt::format("<mouse move: x:{}, y:{}, xoffset:{}, yoffset:{}>",
-                                data.mouse_move.xpos,data.mouse_move.ypos,data.mouse_move.xoffset,data.mouse_move.yoffset);
+        return fmt::format("<mouse move: buttons:{}, xoffset:{}, yoffset:{}>",
+                                +data.mouse_move.mouse_button_state,+data.mouse_move.xoffset,+data.mouse_move.yoffset);
     case EventType::MOUSE_SCROLL:
         return fmt::format("<mouse scroll: x:{}, y:{}>",
-                                data.mouse_scroll.xoffset,data.mouse_scroll.yoffset);
+                                +data.mouse_scroll.xoffset,+data.mouse_scroll.yoffset);
     default: return "<unknown event>";
     }
 }
@@ -29,6 +34,7 @@ void Interface::bindAllCallbacks(const std::string& config_path, GLFWwindow* win
         YAML::Node config = YAML::LoadFile(config_path);
         
         if (config["keyboard_and_mouse_bindings"]) {
+            std::set<std::pair<EventIdentifier, std::string>> bound_names;
             for (const auto& binding : config["keyboard_and_mouse_bindings"]) {
                 std::string key_name = binding["key"].as<std::string>();
                 std::string callback_name = binding["callback"].as<std::string>();
@@ -40,38 +46,102 @@ void Interface::bindAllCallbacks(const std::string& config_path, GLFWwindow* win
                     throw std::runtime_error("Callback not found: " + callback_name);
                 }
                 const EventIdentifier event_identifier = convertKeyNameToEventIndetifier(key_name);
-                if (registered_callbacks.find(event_identifier) != registered_callbacks.end()){
+                if (!bound_names.insert({event_identifier, callback_name}).second){
                     throw std::runtime_error("Callback already registered: " + callback_name + " for key: " + key_name);
                 }
 
+                unsigned short mod_value = 0;
                 if (binding["mod"].IsDefined()){
-                    unsigned short mod_value = 0;
                     for (const auto& mod : binding["mod"]){
                         mod_value |= convertKeyNameToEventIndetifier(mod.as<std::string>());
                     }
-                    registered_callbacks[event_identifier] = std::make_pair(all_callbacks[callback_name], mod_value);
-                }else{
-                    registered_callbacks[event_identifier] = std::make_pair(all_callbacks[callback_name], 0);
                 }
+                const int priority = binding["priority"].IsDefined() ? binding["priority"].as<int>() : 0;
+                bindCallback(event_identifier, all_callbacks[callback_name], mod_value, priority);
             }
         }
         
+        if (config["keyboard_and_mouse_axes"]) {
+            // 每个方向可以是一个键名或一组键名
+            const auto readKeys = [](const YAML::Node& node) {
+                std::vector<EventIdentifier> keys;
+                if (!node.IsDefined()) return keys;
+                if (node.IsSequence()) {
+                    for (const auto& key : node) keys.push_back(convertKeyNameToEventIndetifier(key.as<std::string>()));
+                } else {
+                    keys.push_back(convertKeyNameToEventIndetifier(node.as<std::string>()));
+                }
+                return keys;
+            };
+            for (const auto& axis : config["keyboard_and_mouse_axes"]) {
+                addAxis(axis["axis"].as<std::string>(), readKeys(axis["positive"]), readKeys(axis["negative"]));
+            }
+        }
+
         if (config["keyboard_and_mouse_settings"]){
             YAML::Node settings = config["keyboard_and_mouse_settings"];
             reset_mouse_position_upon_enter_window = settings["reset_mouse_position_upon_enter_window"].as<bool>(); 
+            raw_mouse_motion = settings["raw_mouse_motion"].IsDefined() && settings["raw_mouse_motion"].as<bool>();
         }
     } catch (const YAML::Exception& e) {
         std::cerr << "Error loading control config: " << e.what() << std::endl;
     }
+    this->window = window;
     glfwGetCursorPos(window, &mouse_x_pos, &mouse_y_pos);
+    held_modifier_keys = pollModifierKeys(window);
+    mouse_button_state = pollMouseButtonState(window);
     glfwSetKeyCallback(window, keyCallback);
     glfwSetMouseButtonCallback(window, mouseButtonCallback);
     glfwSetScrollCallback(window, mouseScrollCallback);
     glfwSetCursorPosCallback(window, mouseMoveCallback);
     glfwSetCursorEnterCallback(window, mouseEnterCallback);
+    if (raw_mouse_motion && !setRawMouseMotion(true)) {
+        std::cerr << "Raw mouse motion is not supported on this platform" << std::endl;
+    }
     bound = true;
 }
 
+void Interface::flushMouseMotion() {
+    if (!motion_pending) return;
+    Event event = {.type = EventType::MOUSE_MOVE, .mods = getModifierState(), .data = {.mouse_move = {.xoffset = (float)pending_x_offset, .yoffset = (float)pending_y_offset, .mouse_button_state = mouse_button_state}}};
+    pushEvent(event);
+    pending_x_offset = pending_y_offset = 0.0;
+    motion_pending = false;
+}
+
+bool Interface::setRawMouseMotion(bool enabled) {
+    if (!window || (enabled && !glfwRawMouseMotionSupported())) return false;
+    glfwSetInputMode(window, GLFW_RAW_MOUSE_MOTION, enabled ? GLFW_TRUE : GLFW_FALSE);
+    return true;
+}
+
+void Interface::bindCallback(EventIdentifier identifier, EventCallbackFunction callback, unsigned short mods, int priority) {
+    const int index = getDispatchIndex(identifier);
+    if (index < 0) {
+        throw std::runtime_error("Cannot bind callback to event " + std::to_string(identifier));
+    }
+    auto& slot = listeners[index];
+    // 插在第一个优先级更低的回调之前, 分发时直接按顺序调用
+    auto position = slot.begin();
+    while (position != slot.end() && position->priority >= priority) ++position;
+    slot.insert(position, EventListener{std::move(callback), mods, priority});
+}
+
+const std::vector<EventListener>& Interface::getListeners(EventIdentifier identifier) const {
+    static const std::vector<EventListener> empty;
+    const int index = getDispatchIndex(identifier);
+    return index < 0 ? empty : listeners[index];
+}
+
+int Interface::getDispatchIndex(EventIdentifier identifier) {
+    if (identifier <= GLFW_KEY_LAST) return identifier;
+    if (identifier >= static_cast<EventIdentifier>(LUNAR_EVENT::LUNAR_MOUSE_SCROLL) &&
+        identifier <= static_cast<EventIdentifier>(LUNAR_EVENT::LUNAR_MOUSE_MOVE)) {
+        return GLFW_KEY_LAST + 1 + (identifier - static_cast<EventIdentifier>(LUNAR_EVENT::LUNAR_MOUSE_SCROLL));
+    }
+    return -1;
+}
+
 void Interface::registerCallback(const std::string& name, EventCallbackFunction callback) {
     if (all_callbacks.find(name) != all_callbacks.end()){
         throw std::runtime_error("Callback already registered: " + name);
@@ -80,83 +150,152 @@ void Interface::registerCallback(const std::string& name, EventCallbackFunction
     registered = true;
 }
 
-void Interface::keyCallback(GLFWwindow* window, int key, int scancode, int action, int mods) {
-    auto& instance = Interface::getInstance();
-    Event event = {.type = EventType::KEY, .data = {.key = {.key = (unsigned short)key, .scancode = (unsigned short)scancode, .action = (unsigned short)action, .mods = (unsigned short)mods}}};
-    if (instance.registered_callbacks.find(key) != instance.registered_callbacks.end()) {
-        EventCallbackFuncWithMod callback_with_mod = instance.registered_callbacks[key];
-        if ((callback_with_mod.second & mods) == callback_with_mod.second){
-            callback_with_mod.first(event);
+size_t Interface::dispatchEvents() {
+    LUNAR_PROFILE_SCOPE("dispatch events");
+    size_t dispatched = 0;
+    if (replaying) {
+        dispatched = dispatchReplayFrame();
+    } else {
+        // 每次最多取出一批, 回调中新推入的事件留到下一次
+        Event batch[64];
+        size_t remaining = event_queue.size();
+        while (remaining > 0) {
+            const size_t count = event_queue.pop(batch, std::min(remaining, std::size(batch)));
+            if (count == 0) break;
+            for (size_t i = 0; i < count; i++) {
+                if (record_file.is_open()) recordEvent(batch[i]);
+                dispatch(batch[i]);
+            }
+            dispatched += count;
+            remaining -= count;
         }
     }
+    if (record_file.is_open()) record_frame++;
+    frame_index++;
+    return dispatched;
 }
 
-void Interface::mouseButtonCallback(GLFWwindow* window, int button, int action, int mods) {
-    auto& instance = Interface::getInstance();
-    double xpos, ypos;
-    glfwGetCursorPos(window, &xpos, &ypos);
-    Event event = {.type = EventType::MOUSE_CLICK, .data = {.mouse_click = {.button = (unsigned short)button, .action = (unsigned short)action, .mods = (unsigned short)mods, .xpos = (unsigned short)xpos, .ypos = (unsigned short)ypos}}};
-    if (instance.registered_callbacks.find(button) != instance.registered_callbacks.end()) {
-        EventCallbackFuncWithMod callback_with_mod = instance.registered_callbacks[button];
-        if ((callback_with_mod.second & mods) == callback_with_mod.second){
-            callback_with_mod.first(event);
-        }
+bool Interface::pushEvent(Event event) {
+    event.timestamp = static_cast<uint32_t>(static_cast<uint64_t>(getProfileTimeMicroseconds()));
+    return event_queue.push(event);
+}
+
+void Interface::addAxis(const std::string& name, std::vector<EventIdentifier> positive, std::vector<EventIdentifier> negative) {
+    InputAxis axis{name, std::move(positive), std::move(negative)};
+    const auto found = std::find_if(axes.begin(), axes.end(), [&name](const InputAxis& existing) { return existing.name == name; });
+    if (found != axes.end()) *found = std::move(axis);
+    else axes.push_back(std::move(axis));
+}
+
+float Interface::getAxis(std::string_view name) const {
+    for (const InputAxis& axis : axes) {
+        if (axis.name != name) continue;
+        const auto anyDown = [this](const std::vector<EventIdentifier>& keys) {
+            return std::any_of(keys.begin(), keys.end(), [this](EventIdentifier key) { return isKeyDown(key); });
+        };
+        return (anyDown(axis.positive) ? 1.0f : 0.0f) - (anyDown(axis.negative) ? 1.0f : 0.0f);
     }
+    return 0.0f;
 }
 
-void Interface::mouseScrollCallback(GLFWwindow* window, double xoffset, double yoffset){
-    auto& instance = Interface::getInstance();
-    Event event = {.type = EventType::MOUSE_SCROLL, .data = {.mouse_scroll = {.xoffset = (short)xoffset, .yoffset = (short)yoffset}}};
-    static unsigned short scroll_ident = static_cast<EventIdentifier>(LUNAR_EVENT::LUNAR_MOUSE_SCROLL);
-    unsigned short mods = getModifier(window);
-    if (instance.registered_callbacks.find(scroll_ident) != instance.registered_callbacks.end()) {
-        EventCallbackFuncWithMod callback_with_mod = instance.registered_callbacks[scroll_ident];
-        if ((callback_with_mod.second & mods) == callback_with_mod.second){
-            callback_with_mod.first(event);
+void Interface::dispatch(const Event& event) {
+    if (event.type == EventType::KEY || event.type == EventType::MOUSE_CLICK) {
+        const bool key = event.type == EventType::KEY;
+        const size_t code = key ? event.data.key.key : event.data.mouse_click.button;
+        const unsigned short action = key ? event.data.key.action : event.data.mouse_click.action;
+        // GLFW_KEY_UNKNOWN转换后超出范围, 忽略; 重复不改变状态
+        if (code < keys_down.size() && action != GLFW_REPEAT) keys_down.set(code, action == GLFW_PRESS);
+    }
+    EventIdentifier identifier;
+    switch (event.type) {
+        case EventType::KEY:          identifier = event.data.key.key; break;
+        case EventType::MOUSE_CLICK:  identifier = event.data.mouse_click.button; break;
+        case EventType::MOUSE_MOVE:   identifier = static_cast<EventIdentifier>(LUNAR_EVENT::LUNAR_MOUSE_MOVE); break;
+        case EventType::MOUSE_SCROLL: identifier = static_cast<EventIdentifier>(LUNAR_EVENT::LUNAR_MOUSE_SCROLL); break;
+        default: return;
+    }
+    const int index = getDispatchIndex(identifier);
+    if (index < 0) return;
+    for (const EventListener& listener : listeners[index]) {
+        if ((listener.mods & event.mods) == listener.mods){
+            listener.callback(event);
         }
     }
 }
 
-void Interface::mouseMoveCallback(GLFWwindow* window, double xpos, double ypos){
+// 按键, 按钮与滚轮事件之前先放入已经累积的移动, 保持事件的先后顺序与当时的修饰键状态
+void Interface::keyCallback(GLFWwindow*, int key, int scancode, int action, int mods) {
+    LUNAR_PROFILE_SCOPE("event key");
     auto& instance = Interface::getInstance();
-    static unsigned short move_ident = static_cast<EventIdentifier>(LUNAR_EVENT::LUNAR_MOUSE_MOVE);
-    unsigned short mouse_button_state = getMouseButtonState(window);
-
-    Event event = {.type = EventType::MOUSE_MOVE, .data = {.mouse_move = {.mouse_button_state = mouse_button_state, .xpos = (unsigned short)xpos, .ypos = (unsigned short)ypos, .xoffset = (short)(xpos-instance.mouse_x_pos), .yoffset = (short)(ypos-instance.mouse_y_pos)}}};
-    unsigned short mods = getModifier(window);
-    if (instance.registered_callbacks.find(move_ident) != instance.registered_callbacks.end()) {
-        EventCallbackFuncWithMod callback_with_mod = instance.registered_callbacks[move_ident];
-        if ((callback_with_mod.second & mods) == callback_with_mod.second){
-            callback_with_mod.first(event);
-        }
-    }
+    if (instance.replaying) return;
+    instance.flushMouseMotion();
+    instance.updateModifierKeys(key, action);
+    Event event = {.type = EventType::KEY, .mods = (uint8_t)mods, .data = {.key = {.key = (unsigned short)key, .scancode = (unsigned short)scancode, .action = (unsigned short)action, .mods = (unsigned short)mods}}};
+    instance.pushEvent(event);
+}
+
+void Interface::mouseButtonCallback(GLFWwindow*, int button, int action, int mods) {
+    LUNAR_PROFILE_SCOPE("event mouse button");
+    auto& instance = Interface::getInstance();
+    if (instance.replaying) return;
+    instance.flushMouseMotion();
+    instance.updateMouseButtons(button, action);
+    Event event = {.type = EventType::MOUSE_CLICK, .mods = (uint8_t)mods, .data = {.mouse_click = {.button = (unsigned char)button, .action = (unsigned char)action, .xpos = (float)instance.mouse_x_pos, .ypos = (float)instance.mouse_y_pos}}};
+    instance.pushEvent(event);
+}
+
+void Interface::mouseScrollCallback(GLFWwindow*, double xoffset, double yoffset){
+    LUNAR_PROFILE_SCOPE("event mouse scroll");
+    auto& instance = Interface::getInstance();
+    if (instance.replaying) return;
+    instance.flushMouseMotion();
+    Event event = {.type = EventType::MOUSE_SCROLL, .mods = instance.getModifierState(), .data = {.mouse_scroll = {.xoffset = (float)xoffset, .yoffset = (float)yoffset}}};
+    instance.pushEvent(event);
+}
+
+// 只累积, 由flushMouseMotion合并成一个事件; 高回报率的鼠标每秒上千次移动, 每帧只需要处理一次
+void Interface::mouseMoveCallback(GLFWwindow*, double xpos, double ypos){
+    auto& instance = Interface::getInstance();
+    if (instance.replaying) return;
+    instance.pending_x_offset += xpos - instance.mouse_x_pos;
+    instance.pending_y_offset += ypos - instance.mouse_y_pos;
+    instance.motion_pending = true;
     instance.mouse_x_pos = xpos;
     instance.mouse_y_pos = ypos;
 }
 
 void Interface::mouseEnterCallback(GLFWwindow* window, int entered){
     auto& instance = Interface::getInstance();
-    if (entered){
+    if (entered && !instance.replaying){
         if (instance.reset_mouse_position_upon_enter_window){
             glfwGetCursorPos(window, &instance.mouse_x_pos, &instance.mouse_y_pos);
         }
     }
 }
 
-unsigned short Interface::getModifier(GLFWwindow* window){
-    unsigned short mods = 0;
-    if (glfwGetKey(window, GLFW_KEY_LEFT_SHIFT) == GLFW_PRESS || glfwGetKey(window, GLFW_KEY_RIGHT_SHIFT) == GLFW_PRESS)
-        mods |= GLFW_MOD_SHIFT;
-    if (glfwGetKey(window, GLFW_KEY_LEFT_CONTROL) == GLFW_PRESS || glfwGetKey(window, GLFW_KEY_RIGHT_CONTROL) == GLFW_PRESS)
-        mods |= GLFW_MOD_CONTROL;
-    if (glfwGetKey(window, GLFW_KEY_LEFT_ALT) == GLFW_PRESS || glfwGetKey(window, GLFW_KEY_RIGHT_ALT) == GLFW_PRESS)
-        mods |= GLFW_MOD_ALT;
-    if (glfwGetKey(window, GLFW_KEY_LEFT_SUPER) == GLFW_PRESS || glfwGetKey(window, GLFW_KEY_RIGHT_SUPER) == GLFW_PRESS)
-        mods |= GLFW_MOD_SUPER;
-    return mods;
+void Interface::updateModifierKeys(int key, int action) {
+    if (key < GLFW_KEY_LEFT_SHIFT || key > GLFW_KEY_RIGHT_SUPER || action == GLFW_REPEAT) return;
+    const uint8_t bit = static_cast<uint8_t>(1u << (key - GLFW_KEY_LEFT_SHIFT));
+    if (action == GLFW_PRESS) held_modifier_keys |= bit;
+    else held_modifier_keys &= static_cast<uint8_t>(~bit);
+}
+
+void Interface::updateMouseButtons(int button, int action) {
+    static const unsigned short button_bits[] = {1, 2, 4};  // 左, 右, 中, 与pollMouseButtonState一致
+    if (button < 0 || button >= 3) return;
+    if (action == GLFW_PRESS) mouse_button_state |= button_bits[button];
+    else mouse_button_state &= static_cast<unsigned short>(~button_bits[button]);
+}
+
+uint8_t Interface::pollModifierKeys(GLFWwindow* window){
+    uint8_t keys = 0;
+    for (int key = GLFW_KEY_LEFT_SHIFT; key <= GLFW_KEY_RIGHT_SUPER; key++) {
+        if (glfwGetKey(window, key) == GLFW_PRESS) keys |= static_cast<uint8_t>(1u << (key - GLFW_KEY_LEFT_SHIFT));
+    }
+    return keys;
 }
 
-unsigned short Interface::getMouseButtonState(GLFWwindow* window){
+unsigned short Interface::pollMouseButtonState(GLFWwindow* window){
     unsigned short mouse_button_state = 0;
     if (glfwGetMouseButton(window, GLFW_MOUSE_BUTTON_LEFT) == GLFW_PRESS)
         mouse_button_state |= 1;
@@ -172,7 +311,8 @@ void Interface::debugCallback(const Event& event){
 }
 
 Interface::~Interface() {
-    registered_callbacks.clear();
+    stopRecording();
+    for (auto& slot : listeners) slot.clear();
     all_callbacks.clear();
 }
 
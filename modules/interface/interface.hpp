@@ -1,11 +1,19 @@
 #pragma once
+#include <array>
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
 #include <map>
 #include <string>
-#include <functional>
+#include <string_view>
+#include <vector>
 #include "GLFW/glfw3.h"
+#include "delegate.hpp"
+#include "event_queue.hpp"
 
 namespace lunar {
-enum class EventType {
+enum class EventType : uint8_t {
     KEY = 0,
     MOUSE_CLICK = 1,
     MOUSE_MOVE = 2,
@@ -20,6 +28,9 @@ enum class LUNAR_EVENT{
 struct Event {// 16 bytes
     //data size was compressed for faster tranferring.
     EventType type;
+    uint8_t mods;  // 事件发生时按下的修饰键, GLFW_MOD_*
+    // 按2字节对齐, 鼠标的float坐标才能放进10字节; 读取这些成员时按值读取, 不要取引用
+#pragma pack(push, 2)
     union {
         struct {
             unsigned short key;
@@ -28,36 +39,62 @@ struct Event {// 16 bytes
             unsigned short mods;
         } key;
         struct {
-            unsigned short button;
-            unsigned short action;
-            unsigned short mods;
-            unsigned short xpos;
-            unsigned short ypos;
+            unsigned char button;
+            unsigned char action;
+            float xpos;
+            float ypos;
         } mouse_click;
+        // 一次pollEvents中的所有移动合并为一个事件, 偏移与mouse_scroll的位置相同.
+        // 绝对位置由Interface::getMousePosition取得
         struct {
+            float xoffset;
+            float yoffset;
             unsigned short mouse_button_state;
-            unsigned short xpos;
-            unsigned short ypos;
-            short xoffset;
-            short yoffset;
         } mouse_move;
         struct {
-            short xoffset;
-            short yoffset;
+            float xoffset;
+            float yoffset;
         } mouse_scroll;
     } data;
+#pragma pack(pop)
+    // 进入队列时的getProfileTimeMicroseconds, 约71分钟回绕一次, 用无符号减法求间隔;
+    // 录制文件的InputRecord::timestamp保存不回绕的64位时间
+    uint32_t timestamp{0};
     [[nodiscard]] std::string what() const;
 };
+static_assert(sizeof(Event) == 16, "Event should stay 16 bytes");
+// 摄像机的移动回调把鼠标移动与滚轮的偏移当作同样的数据读取
+static_assert(offsetof(Event, data.mouse_move.yoffset) == offsetof(Event, data.mouse_scroll.yoffset));
+
+// 输入录制文件中的一条记录, 文件头之后依次存放
+struct InputRecord {
+    uint32_t frame;      // 开始录制之后第几次dispatchEvents, 从0开始
+    uint32_t reserved;   // 对齐用, 总是0
+    uint64_t timestamp;  // 事件进入队列时距开始录制的微秒数, 不回绕
+    Event event;
+};
+static_assert(sizeof(InputRecord) == 32, "InputRecord should stay 32 bytes");
 
 using EventIdentifier = unsigned short;
-using EventCallbackFunction = std::function<void(const Event&)>;
-using EventCallbackFuncWithMod = std::pair<EventCallbackFunction, unsigned short>;
+// lambda, std::bind或Delegate::fromMethod都可以, 函数对象不超过32字节, 不分配内存
+using EventCallbackFunction = Delegate<void(const Event&)>;
 
+struct EventListener {
+    EventCallbackFunction callback;
+    unsigned short mods{0};  // 这些修饰键都按下时才调用
+    int priority{0};  // 同一个按键上的回调按priority从高到低调用, 相同时按绑定的顺序
+};
+
+// GLFW回调只把带时间戳的Event放进单生产者单消费者队列, 不调用任何注册的回调;
+// 消费者(主循环或模拟线程)在循环中固定的位置调用dispatchEvents, 按顺序成批分发.
 class Interface {
 public:
+    static constexpr size_t event_queue_capacity = 1024;
+    // 按键与鼠标按钮直接用GLFW的编号作为下标, LUNAR_EVENT排在GLFW_KEY_LAST之后
+    static constexpr size_t dispatch_table_size = GLFW_KEY_LAST + 1 + 2;
+
     ~Interface();
     std::map<std::string, EventCallbackFunction> all_callbacks;
-    std::map<EventIdentifier, EventCallbackFuncWithMod> registered_callbacks;
 
     static Interface& getInstance() {
         static Interface instance;
@@ -65,10 +102,63 @@ public:
     }
     void bindAllCallbacks(const std::string& path, GLFWwindow* window);
     void registerCallback(const std::string& name, EventCallbackFunction callback);
+    // 不经过配置文件直接绑定; 同一个按键可以绑定多个回调. 不能在分发的回调中调用
+    void bindCallback(EventIdentifier identifier, EventCallbackFunction callback, unsigned short mods = 0, int priority = 0);
+    [[nodiscard]] const std::vector<EventListener>& getListeners(EventIdentifier identifier) const;
+    // 取出队列中的所有事件并调用对应的回调, 返回分发的事件数; 只能由一个消费者线程调用
+    size_t dispatchEvents();
+    // dispatchEvents被调用的次数, 即输入的帧序号
+    [[nodiscard]] uint64_t getFrameIndex() const { return frame_index; }
+    // 由生产者线程调用, 队列已满时丢弃; 也可以用来注入合成的事件
+    bool pushEvent(Event event);
+    [[nodiscard]] size_t getPendingEventCount() const { return event_queue.size(); }
+    [[nodiscard]] uint64_t getDroppedEventCount() const { return event_queue.getDroppedCount(); }
+    // 由生产者线程在glfwPollEvents之后调用(Window::pollEvents), 把这次累积的鼠标移动作为一个事件放入队列
+    void flushMouseMotion();
+    // 原始的鼠标移动, 不经过系统的加速与缩放; GLFW只在光标被禁用(GLFW_CURSOR_DISABLED)时使用. 平台不支持时返回false
+    bool setRawMouseMotion(bool enabled);
+
+    // 以下状态由生产者线程根据事件维护; 回放期间不再跟随实际的设备, 而是由回放的事件重建
+    void getMousePosition(double& xpos, double& ypos) const {
+        xpos = mouse_x_pos;
+        ypos = mouse_y_pos;
+    }
+    [[nodiscard]] uint8_t getModifierState() const {
+        // 左右两侧的同一种修饰键合并, 依次为GLFW_MOD_SHIFT, CONTROL, ALT, SUPER
+        return static_cast<uint8_t>((held_modifier_keys | (held_modifier_keys >> 4)) & 0x0f);
+    }
+    [[nodiscard]] unsigned short getMouseButtonState() const { return mouse_button_state; }
+
+    // 以下状态由dispatchEvents根据事件维护, 在消费者线程上每帧查询, 不依赖按键重复的频率
+    // 按键或鼠标按钮当前是否按下
+    [[nodiscard]] bool isKeyDown(EventIdentifier identifier) const {
+        return identifier < keys_down.size() && keys_down.test(identifier);
+    }
+    // interface.yaml中声明的轴: 正向的键按下为1, 反向的键按下为-1, 都按下或都没有按下为0; 未声明的轴为0
+    [[nodiscard]] float getAxis(std::string_view name) const;
+    // 与配置文件中的keyboard_and_mouse_axes相同, 同名的轴被替换
+    void addAxis(const std::string& name, std::vector<EventIdentifier> positive, std::vector<EventIdentifier> negative);
     
+    // 录制: 之后分发的每个事件连同帧序号与时间戳写入二进制文件, 开始时已经按下的键记为第0帧的按下事件.
+    // 回放: 忽略实际的输入, 第n次dispatchEvents分发录制时第n帧的事件, 经过与实际输入相同的分发路径,
+    // 放完录制的帧数后自动结束. 调用方在回放时应使用固定的帧时间, 结果才与录制时无关.
+    // 回放期间GLFW的输入回调不做任何事, 鼠标位置, 修饰键与鼠标按钮从录制开始时的状态按回放的事件更新
+    // 文件无法打开或格式不对时抛出异常
+    void startRecording(const std::string& path);
+    void stopRecording();
+    void startReplay(const std::string& path);
+    void stopReplay();
+    [[nodiscard]] bool isRecording() const { return record_file.is_open(); }
+    [[nodiscard]] bool isReplaying() const { return replaying; }
+    // 录制文件中的帧数, 用于显示回放进度
+    [[nodiscard]] uint32_t getReplayFrameCount() const { return replay_frame_count; }
+    [[nodiscard]] uint32_t getReplayFrame() const { return replay_frame; }
+
     void clearCallbacks() {
-        registered_callbacks.clear();
+        for (auto& slot : listeners) slot.clear();
         all_callbacks.clear();
+        axes.clear();
+        keys_down.reset();
         registered = false;
         bound = false;
     }
@@ -77,18 +167,57 @@ public:
     inline static bool registered = false;
 
 private:
+    struct InputAxis {
+        std::string name;
+        std::vector<EventIdentifier> positive, negative;
+    };
+
     Interface() = default;
     static EventIdentifier convertKeyNameToEventIndetifier(const std::string& key_name);
+    // 不在表中的标识返回-1
+    static int getDispatchIndex(EventIdentifier identifier);
     static void debugCallback(const Event& event);
     static void keyCallback(GLFWwindow* window, int key, int scancode, int action, int mods);
     static void mouseButtonCallback(GLFWwindow* window, int button, int action, int mods);
     static void mouseScrollCallback(GLFWwindow* window, double xoffset, double yoffset);
     static void mouseMoveCallback(GLFWwindow* window, double xpos, double ypos);
     static void mouseEnterCallback(GLFWwindow* window, int entered);
-    static unsigned short getModifier(GLFWwindow* window);
-    static unsigned short getMouseButtonState(GLFWwindow* window);
+    // 只在绑定时查询一次GLFW, 之后由事件增量更新
+    static uint8_t pollModifierKeys(GLFWwindow* window);
+    static unsigned short pollMouseButtonState(GLFWwindow* window);
+    void updateModifierKeys(int key, int action);
+    void updateMouseButtons(int button, int action);
+    // 回放的事件对生产者一侧状态的影响, 与GLFW回调中的更新相同
+    void applyReplayedEvent(const Event& event);
+    void dispatch(const Event& event);
+    void recordEvent(const Event& event);
+    // 回放时代替队列中的事件, 返回分发的事件数
+    size_t dispatchReplayFrame();
 
-    double mouse_x_pos, mouse_y_pos;
+    double mouse_x_pos{0.0}, mouse_y_pos{0.0};
+    // 还没有放入队列的鼠标移动
+    double pending_x_offset{0.0}, pending_y_offset{0.0};
+    bool motion_pending{false};
+    // GLFW_KEY_LEFT_SHIFT到GLFW_KEY_RIGHT_SUPER这8个键各一位
+    uint8_t held_modifier_keys{0};
+    unsigned short mouse_button_state{0};
+    GLFWwindow* window{nullptr};
     bool reset_mouse_position_upon_enter_window = false;
+    bool raw_mouse_motion = false;
+    SpscQueue<Event, event_queue_capacity> event_queue;
+    std::array<std::vector<EventListener>, dispatch_table_size> listeners;
+    std::vector<InputAxis> axes;
+    // 按键与鼠标按钮共用GLFW的编号, 与分发表相同
+    std::bitset<GLFW_KEY_LAST + 1> keys_down;
+
+    uint64_t frame_index{0};
+    std::ofstream record_file;
+    uint32_t record_frame{0};
+    uint64_t record_start{0};  // 开始录制时的getProfileTimeMicroseconds
+    std::vector<InputRecord> replay_records;
+    size_t replay_next{0};
+    uint32_t replay_frame{0};
+    uint32_t replay_frame_count{0};
+    bool replaying{false};
 };
 }
\ No newline at end of file
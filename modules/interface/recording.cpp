@@ -0,0 +1,166 @@
+#include "interface/interface.hpp"
+#include "profile/clock.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <iterator>
+#include <iostream>
+#include <stdexcept>
+
+namespace lunar {
+
+// 文件头: 魔数, 版本, 每条记录的字节数, 录制的帧数(停止录制时写入), 开始时的鼠标位置. 按本机字节序存放
+static constexpr char record_magic[4] = {'L', 'N', 'I', 'R'};
+static constexpr uint32_t record_version = 3;
+
+struct InputRecordHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t record_size;
+    uint32_t frame_count;
+    double mouse_x, mouse_y;
+};
+
+void Interface::startRecording(const std::string& path) {
+    stopRecording();
+    record_file.open(path, std::ios::binary | std::ios::trunc);
+    if (!record_file) {
+        throw std::runtime_error("Failed to open input recording: " + path);
+    }
+    InputRecordHeader header{};
+    std::memcpy(header.magic, record_magic, sizeof(record_magic));
+    header.version = record_version;
+    header.record_size = sizeof(InputRecord);
+    header.mouse_x = mouse_x_pos;
+    header.mouse_y = mouse_y_pos;
+    record_file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    record_frame = 0;
+    record_start = static_cast<uint64_t>(getProfileTimeMicroseconds());
+    // 开始时已经按下的键, 回放时同样从按下开始
+    for (size_t code = 0; code < keys_down.size(); code++) {
+        if (!keys_down.test(code)) continue;
+        Event event{};
+        event.timestamp = static_cast<uint32_t>(record_start);
+        if (code <= GLFW_MOUSE_BUTTON_LAST) {
+            event.type = EventType::MOUSE_CLICK;
+            event.data.mouse_click.button = static_cast<unsigned char>(code);
+            event.data.mouse_click.action = GLFW_PRESS;
+        } else {
+            event.type = EventType::KEY;
+            event.data.key.key = static_cast<unsigned short>(code);
+            event.data.key.action = GLFW_PRESS;
+        }
+        recordEvent(event);
+    }
+}
+
+void Interface::stopRecording() {
+    if (!record_file.is_open()) return;
+    record_file.seekp(offsetof(InputRecordHeader, frame_count));
+    record_file.write(reinterpret_cast<const char*>(&record_frame), sizeof(record_frame));
+    record_file.close();
+}
+
+void Interface::recordEvent(const Event& event) {
+    // Event只保存时间的低32位; 事件在进入队列之后的同一帧内就被取出, 与当前时间的差远小于回绕周期,
+    // 用无符号减法求出这段差即可恢复完整的时间
+    const uint64_t now = static_cast<uint64_t>(getProfileTimeMicroseconds());
+    const uint64_t pushed = now - static_cast<uint32_t>(static_cast<uint32_t>(now) - event.timestamp);
+    const InputRecord record{record_frame, 0, pushed > record_start ? pushed - record_start : 0, event};
+    record_file.write(reinterpret_cast<const char*>(&record), sizeof(record));
+}
+
+void Interface::startReplay(const std::string& path) {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file) {
+        throw std::runtime_error("Failed to open input recording: " + path);
+    }
+    const auto size = static_cast<size_t>(file.tellg());
+    file.seekg(0);
+    InputRecordHeader header{};
+    if (size < sizeof(header) || !file.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+        std::memcmp(header.magic, record_magic, sizeof(record_magic)) != 0) {
+        throw std::runtime_error("Not an input recording: " + path);
+    }
+    if (header.version != record_version || header.record_size != sizeof(InputRecord)) {
+        throw std::runtime_error("Unsupported input recording version: " + path);
+    }
+    std::vector<InputRecord> records((size - sizeof(header)) / sizeof(InputRecord));
+    file.read(reinterpret_cast<char*>(records.data()), static_cast<std::streamsize>(records.size() * sizeof(InputRecord)));
+    if (!file) {
+        throw std::runtime_error("Failed to read input recording: " + path);
+    }
+    replay_records = std::move(records);
+    // 录制没有正常结束时帧数为0, 放到最后一个事件为止
+    replay_frame_count = header.frame_count;
+    if (!replay_records.empty()) replay_frame_count = std::max(replay_frame_count, replay_records.back().frame + 1);
+    replay_next = 0;
+    replay_frame = 0;
+    // 从没有按键按下的状态开始, 与录制时的起点一致; 开始时按下的键是第0帧的事件
+    keys_down.reset();
+    held_modifier_keys = 0;
+    mouse_button_state = 0;
+    mouse_x_pos = header.mouse_x;
+    mouse_y_pos = header.mouse_y;
+    pending_x_offset = pending_y_offset = 0.0;
+    motion_pending = false;
+    replaying = true;
+}
+
+void Interface::stopReplay() {
+    replaying = false;
+    replay_records.clear();
+    replay_records.shrink_to_fit();
+    keys_down.reset();
+    // 回放期间没有跟随实际的设备, 重新查询一次
+    held_modifier_keys = 0;
+    mouse_button_state = 0;
+    if (window) {
+        glfwGetCursorPos(window, &mouse_x_pos, &mouse_y_pos);
+        held_modifier_keys = pollModifierKeys(window);
+        mouse_button_state = pollMouseButtonState(window);
+    }
+}
+
+void Interface::applyReplayedEvent(const Event& event) {
+    switch (event.type) {
+        case EventType::KEY:
+            updateModifierKeys(event.data.key.key, event.data.key.action);
+            break;
+        case EventType::MOUSE_CLICK:
+            updateMouseButtons(event.data.mouse_click.button, event.data.mouse_click.action);
+            break;
+        case EventType::MOUSE_MOVE:
+            mouse_x_pos += event.data.mouse_move.xoffset;
+            mouse_y_pos += event.data.mouse_move.yoffset;
+            mouse_button_state = event.data.mouse_move.mouse_button_state;
+            break;
+        default:
+            break;
+    }
+}
+
+size_t Interface::dispatchReplayFrame() {
+    // 回放期间实际的输入不分发, 只是取出, 避免队列写满
+    Event discarded[64];
+    while (event_queue.pop(discarded, std::size(discarded)) > 0) {}
+
+    size_t dispatched = 0;
+    const auto now = static_cast<uint32_t>(static_cast<uint64_t>(getProfileTimeMicroseconds()));
+    for (; replay_next < replay_records.size() && replay_records[replay_next].frame <= replay_frame; replay_next++) {
+        // 录制时的时间属于另一次运行, 按这一帧进入队列处理
+        Event event = replay_records[replay_next].event;
+        event.timestamp = now;
+        if (record_file.is_open()) recordEvent(event);
+        applyReplayedEvent(event);
+        dispatch(event);
+        dispatched++;
+    }
+    if (++replay_frame >= replay_frame_count) {
+        std::cout << "Input replay finished after " << replay_frame << " frames" << std::endl;
+        stopReplay();
+    }
+    return dispatched;
+}
+
+}
@@ -0,0 +1,34 @@
+R"(
+#version 430 core
+
+struct Material {
+    sampler2D diffuse;
+    sampler2D specular;
+    float shininess;
+};
+
+in vec3 normal;
+in vec3 fragPos;
+in vec2 TexCoords;
+
+out vec4 fragColor;
+
+uniform vec3 viewPos;
+uniform Material material;
+
+void main()
+{
+    vec3 viewDir = normalize(viewPos - fragPos);
+    vec3 diffuseColor = vec3(texture(material.diffuse, TexCoords));
+    vec3 specularColor = vec3(texture(material.specular, TexCoords));
+
+    vec3 result = computeClusteredLighting(fragPos, normalize(normal), viewDir, diffuseColor, specularColor, material.shininess);
+#ifdef LUNAR_SHADOWS
+    result += computeSunLighting(fragPos, normalize(normal), viewDir, diffuseColor, specularColor, material.shininess);
+#endif
+
+    // 应用三渲二效果
+    result = color_thinning(result, 2.0);
+    fragColor = vec4(result, 1.0);
+}
+)"
@@ -101,6 +101,11 @@ void main()
 
         // 基础光照结果
         vec3 result = ambient + diffuse + specular;
+#ifdef LUNAR_SHADOWS
+        // 带级联阴影的平行光
+        result += computeSunLighting(fragPos, normalize(normal), viewDir, vec3(texture(material.diffuse, TexCoords)),
+                                     vec3(texture(material.specular, TexCoords)), material.shininess);
+#endif
         
         // 应用三渲二效果
         result = color_thinning(result, 2.0);
@@ -3,8 +3,11 @@
 #include "model/model.hpp"
 #include <iostream>
 #include <functional>
+#include <algorithm>
 #include <chrono>
-#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <memory>
 
 int main() {
     auto& window = lunar::Window::getInstance();
@@ -14,78 +17,13 @@ int main() {
         std::cerr << "Failed to initialize window, error: " << e.what() << std::endl;
         return -1;
     }
-
-    // 创建箱子和光源的着色器程序
-    const std::string box_vertex_shader_code = 
-    #include "GLSL/box-vs.glsl"
-    ;
-    const std::string box_fragment_shader_code = 
-    #include "GLSL/box-fs.glsl"
-    ;
-    const std::string light_vertex_shader_code = 
-    #include "GLSL/light-vs.glsl"
-    ;
-    const std::string light_fragment_shader_code = 
-    #include "GLSL/light-fs.glsl"
-    ;
-
-    lunar::ShaderProgram box_shader_program(box_vertex_shader_code, box_fragment_shader_code);
-    lunar::ShaderProgram light_shader_program(light_vertex_shader_code, light_fragment_shader_code);
-
-    // 设置顶点属性
-    box_shader_program.setVertexDataProperty({"position", "normal", "TexCoords"}, {3, 3, 2});
-    light_shader_program.setVertexDataProperty({"position"}, {3});
-
-    // 设置立方体顶点数据
-    std::vector<lunar::VertexData<3>> light_vertices = {
-        {-0.5f, -0.5f, -0.5f}, 
-        { 0.5f, -0.5f, -0.5f},  
-        { 0.5f,  0.5f, -0.5f},  
-        { 0.5f,  0.5f, -0.5f},  
-        {-0.5f,  0.5f, -0.5f}, 
-        {-0.5f, -0.5f, -0.5f}, 
-
-        {-0.5f, -0.5f,  0.5f}, 
-        { 0.5f, -0.5f,  0.5f},  
-        { 0.5f,  0.5f,  0.5f},  
-        { 0.5f,  0.5f,  0.5f},  
-        {-0.5f,  0.5f,  0.5f}, 
-        {-0.5f, -0.5f,  0.5f}, 
-
-        {-0.5f,  0.5f,  0.5f}, 
-        {-0.5f,  0.5f, -0.5f}, 
-        {-0.5f, -0.5f, -0.5f}, 
-        {-0.5f, -0.5f, -0.5f}, 
-        {-0.5f, -0.5f,  0.5f}, 
-        {-0.5f,  0.5f,  0.5f}, 
-
-        { 0.5f,  0.5f,  0.5f},  
-        { 0.5f,  0.5f, -0.5f},  
-        { 0.5f, -0.5f, -0.5f},  
-        { 0.5f, -0.5f, -0.5f},  
-        { 0.5f, -0.5f,  0.5f},  
-        { 0.5f,  0.5f,  0.5f},  
-
-        {-0.5f, -0.5f, -0.5f}, 
-        { 0.5f, -0.5f, -0.5f},  
-        { 0.5f, -0.5f,  0.5f},  
-        { 0.5f, -0.5f,  0.5f},  
-        {-0.5f, -0.5f,  0.5f}, 
-        {-0.5f, -0.5f, -0.5f}, 
-
-        {-0.5f,  0.5f, -0.5f}, 
-        { 0.5f,  0.5f, -0.5f},  
-        { 0.5f,  0.5f,  0.5f},  
-        { 0.5f,  0.5f,  0.5f},  
-        {-0.5f,  0.5f,  0.5f}, 
-        {-0.5f,  0.5f, -0.5f}, 
-    };
-
-
-    light_shader_program.setVertices<3>(light_vertices);
-
-    box_shader_program.setSequentialIndices();
-    light_shader_program.setSequentialIndices();
+    auto& settings = lunar::RenderSettings::getInstance();
+    settings.load("../modules/config/interface.yaml");
+#if LUNAR_PROFILING
+    // 收集线程在后台取出各线程记录的区间, 退出时与GPU计时一起写出; 卡顿记录也需要这些区间
+    if (settings.profiling.cpu_tracer || settings.profiling.hitch_threshold > 0.0f) lunar::CpuTracer::getInstance().start();
+    LUNAR_PROFILE_THREAD("main thread");
+#endif
 
     lunar::Camera camera(glm::vec3(0.0f, -1.0f, 5.0f));
 
@@ -95,10 +33,26 @@ int main() {
     interface.registerCallback("window_close", std::bind(&lunar::Window::close, &window, std::placeholders::_1));
     interface.registerCallback("window_fullscreen", std::bind(&lunar::Window::fullscreen, &window, std::placeholders::_1));
     interface.registerCallback("window_windowed", std::bind(&lunar::Window::windowed, &window, std::placeholders::_1));
+    // 调试线框的缓冲区在第一次打开时才创建
+    auto& debug_draw = lunar::DebugDraw::getInstance();
+    if (settings.debug_draw) debug_draw.init();
+    interface.registerCallback("debug_draw_toggle", [&debug_draw](const lunar::Event& event) {
+        if (event.data.key.action != GLFW_PRESS) return;
+        if (!debug_draw.isInitialized()) debug_draw.init();
+        else debug_draw.setEnabled(!debug_draw.isEnabled());
+    });
     
 
     camera.registerCallback(interface);
     interface.bindAllCallbacks("../modules/config/interface.yaml", window.getHandle());
+    // 录制输入, 或者回放之前录制的输入以复现性能问题; 回放时帧时间固定, 摄像机的轨迹与录制时的帧率无关
+    if (const char* path = std::getenv("LUNAR_REPLAY_INPUT")) {
+        interface.startReplay(path);
+        std::cout << "Replaying input from " << path << ", " << interface.getReplayFrameCount() << " frames" << std::endl;
+    } else if (const char* path = std::getenv("LUNAR_RECORD_INPUT")) {
+        interface.startRecording(path);
+        std::cout << "Recording input to " << path << std::endl;
+    }
 
 
     // 创建纹理材质
@@ -108,73 +62,86 @@ int main() {
         .shininess = 32.0f
     };
 
-    lunar::StrongPointLight light{
-        .position = glm::vec3(0.0f),
-        .color = glm::vec3(1.0f, 1.0f, 1.0f),
-        .ambient = glm::vec3(0.2f, 0.2f, 0.2f),
-        .diffuse = glm::vec3(0.5f, 0.5f, 0.5f),
-        .specular = glm::vec3(1.0f, 1.0f, 1.0f)
-    };
+    glEnable(GL_DEPTH_TEST);
+    glEnable(GL_CULL_FACE);
 
-    // 加载纹理
-    
-    box_shader_program.use();
+    lunar::PostProcesser postprocesser(settings.compute_blur ? lunar::BlurMode::Compute : lunar::BlurMode::Fragment);
+    postprocesser.configure(settings.post_process);
+    postprocesser.setAntiAliasing(settings.anti_aliasing);
+    // 着色器, 光源与各个按开关创建的渲染功能与lunar_bench共用
+    lunar::SceneRenderer scene(postprocesser);
     lunar::Model ourModel("../assets/The_Boss.fbx");
-    
+    scene.addModel(ourModel);
+
+    lunar::RenderGraph frame_graph;
+    lunar::DynamicResolutionController resolution_controller(settings.dynamic_resolution.target_ms,
+        settings.dynamic_resolution.min_scale, settings.dynamic_resolution.max_scale);
+    lunar::GpuFrameTimer gpu_timer;
+    postprocesser.getUpscaler().setSharpness(settings.dynamic_resolution.sharpness);
+    std::unique_ptr<lunar::GpuProfiler> gpu_profiler;
+    if (settings.profiling.gpu_profiler) gpu_profiler = std::make_unique<lunar::GpuProfiler>();
+    frame_graph.setProfiler(gpu_profiler.get());
+    std::unique_ptr<lunar::HitchRecorder> hitch_recorder;
+    if (settings.profiling.hitch_threshold > 0.0f) {
+        hitch_recorder = std::make_unique<lunar::HitchRecorder>();
+        hitch_recorder->setThreshold(settings.profiling.hitch_threshold, settings.profiling.hitch_min_ms);
+        hitch_recorder->setOutputDirectory(settings.profiling.hitch_directory);
+        hitch_recorder->setGpuProfiler(gpu_profiler.get());
+    }
+    auto last_report = std::chrono::steady_clock::now();
+    // 模拟以固定的60Hz推进, 渲染按帧率进行; 回放时帧时间也固定, 摄像机的轨迹与录制时的帧率无关
+    lunar::Engine engine(60.0);
+    if (interface.isReplaying()) engine.setFixedFrameTime(1.0 / 60.0);
+
+    // 帧首, 在处理事件之前
+    engine.addHook(lunar::FramePhase::Input, [&](const lunar::FrameContext&) {
+        if (gpu_profiler) gpu_profiler->beginFrame();
+        if (hitch_recorder) hitch_recorder->beginFrame();
+    }, lunar::Engine::builtin_priority + 1);
+
+    engine.addHook(lunar::FramePhase::Update, [&](const lunar::FrameContext& context) {
+        camera.update(interface, static_cast<float>(context.fixed_delta));
+    });
+
+    engine.addHook(lunar::FramePhase::Render, [&](const lunar::FrameContext& context) {
+        // 窗口尺寸变化时渲染目标按需跟随, 再按几帧前的GPU时间调整渲染分辨率
+        scene.resize(window.getWidth(), window.getHeight());
+        float gpu_ms;
+        while (gpu_timer.poll(gpu_ms)) {
+            if (settings.dynamic_resolution.enabled) postprocesser.setRenderScale(resolution_controller.update(gpu_ms));
+        }
+        gpu_timer.begin();
 
-    box_shader_program.setUniformStruct("light", light);
-    glEnable(GL_DEPTH_TEST);
-    glEnable(GL_CULL_FACE);
+        // 每帧重新声明帧图, 结构不变时直接复用上一帧的编译结果; 光源位置只取决于模拟时间
+        frame_graph.reset();
+        const lunar::RenderResource backbuffer = frame_graph.importFramebuffer("backbuffer", window.getFramebuffer(), {GL_RGBA8, window.getWidth(), window.getHeight()});
+        scene.addPasses(frame_graph, camera, context.alpha, static_cast<float>(context.getRenderTime()), backbuffer);
 
-    lunar::PostProcesser postprocesser;
-
-    GLenum error;
-    while (!window.shouldClose()) {
-        auto start = std::chrono::high_resolution_clock::now();
-        postprocesser.tobeDrawn();
-
-        // 计算光源位置
-        float time = static_cast<float>(glfwGetTime());
-        glm::vec3 lightPos(
-            2.0f * cos(time),  // x坐标
-            2.0f,             // y坐标保持不变
-            4.0f * sin(time)  // z坐标
-        );
-        glm::mat4 light_model = glm::mat4(1.0f);
-        light_model = glm::translate(light_model, lightPos);
-        light_model = glm::scale(light_model, glm::vec3(0.2f));
-
-        // 更新光源模型矩阵
-        glm::mat4 view = camera.computeViewMatrix();
-        glm::mat4 projection = camera.computeProjectionMatrix();
-        
-        // 渲染箱子
-        box_shader_program.use();
-        box_shader_program.setVec3("light.position", lightPos);  // 使用更新后的光源位置
-        box_shader_program.setVec3("viewPos", camera.getPosition());
-
-        
-        
-        box_shader_program.setMat4("view", view);
-        box_shader_program.setMat4("projection", projection);
-        
-
-        ourModel.Draw(box_shader_program);
-
-        // 渲染光源立方体
-        light_shader_program.use();
-        
-        light_shader_program.setMat4("model", light_model);
-        light_shader_program.setMat4("view", view);
-        light_shader_program.setMat4("projection", projection);
-        light_shader_program.draw();
-
-        postprocesser.toDraw();
-        postprocesser.draw();
-        window.swapBuffers();
-        window.pollEvents();
-        auto end = std::chrono::high_resolution_clock::now();
-        //std::cout << "Time taken: " << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << "ms" << std::endl;
+        {
+            LUNAR_PROFILE_SCOPE("frame graph");
+            frame_graph.execute();
+        }
+        gpu_timer.end();
+    });
+
+    // 交换缓冲区时CPU在等待GPU或垂直同步, 不计入CPU忙碌时间
+    engine.addHook(lunar::FramePhase::Present, [&](const lunar::FrameContext&) {
+        if (gpu_profiler) gpu_profiler->beginPass("swap", true);
+    }, lunar::Engine::builtin_priority + 1);
+    engine.addHook(lunar::FramePhase::Present, [&](const lunar::FrameContext&) {
+        if (gpu_profiler) {
+            gpu_profiler->endPass();
+            gpu_profiler->endFrame();
+            auto now = std::chrono::steady_clock::now();
+            if (settings.profiling.report_interval > 0.0f &&
+                std::chrono::duration<float>(now - last_report).count() >= settings.profiling.report_interval) {
+                std::cout << gpu_profiler->getReport() << frame_graph.getReport();
+                last_report = now;
+            }
+        }
+        // 在GpuProfiler读回之后结束, 写出的卡顿记录才包含卡顿那一帧的GPU pass
+        if (hitch_recorder) hitch_recorder->endFrame();
+        GLenum error;
         if ((error = glGetError()) != GL_NO_ERROR) {
             std::string errorMsg;
             switch (error) {
@@ -186,7 +153,31 @@ int main() {
             }
             std::cout << "OpenGL错误 : " << errorMsg << std::endl;
         }
+    }, lunar::Engine::builtin_priority - 1);
+
+    engine.run();
+
+    debug_draw.release();
+#if LUNAR_PROFILING
+    const bool cpu_trace = settings.profiling.cpu_tracer;
+    if (cpu_trace) lunar::CpuTracer::getInstance().stop();
+#else
+    const bool cpu_trace = false;
+#endif
+    if ((gpu_profiler || cpu_trace) && !settings.profiling.trace_path.empty()) {
+        // GPU的pass与CPU的区间写到同一个文件, 共用一条时间轴
+        std::ofstream trace_file(settings.profiling.trace_path);
+        {
+            lunar::ChromeTraceWriter writer(trace_file);
+            writer.setProcessName(1, "lunar");
+            if (gpu_profiler) gpu_profiler->writeChromeTrace(writer, 1);
+#if LUNAR_PROFILING
+            if (cpu_trace) lunar::CpuTracer::getInstance().writeChromeTrace(writer, 1);
+#endif
+        }
+        if (!trace_file) {
+            std::cerr << "Failed to write trace: " << settings.profiling.trace_path << std::endl;
+        }
     }
-
     return 0;
 }
\ No newline at end of file
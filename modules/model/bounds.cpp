@@ -0,0 +1,66 @@
+#include "bounds.hpp"
+
+namespace lunar {
+
+void AABB::expand(const glm::vec3& point) {
+    min = glm::min(min, point);
+    max = glm::max(max, point);
+}
+
+void AABB::expand(const AABB& other) {
+    if (!other.isValid()) return;
+    min = glm::min(min, other.min);
+    max = glm::max(max, other.max);
+}
+
+AABB AABB::transform(const glm::mat4& matrix) const {
+    if (!isValid()) return *this;
+    // Arvo的方法: 按矩阵列分别累加最小/最大分量，避免变换8个角点
+    AABB result;
+    result.min = result.max = glm::vec3(matrix[3]);
+    for (int i = 0; i < 3; i++) {
+        glm::vec3 axis = glm::vec3(matrix[i]);
+        glm::vec3 a = axis * min[i];
+        glm::vec3 b = axis * max[i];
+        result.min += glm::min(a, b);
+        result.max += glm::max(a, b);
+    }
+    return result;
+}
+
+Frustum Frustum::fromMatrix(const glm::mat4& matrix) {
+    auto row = [&matrix](int i) {
+        return glm::vec4(matrix[0][i], matrix[1][i], matrix[2][i], matrix[3][i]);
+    };
+    Frustum frustum;
+    frustum.planes[0] = row(3) + row(0);
+    frustum.planes[1] = row(3) - row(0);
+    frustum.planes[2] = row(3) + row(1);
+    frustum.planes[3] = row(3) - row(1);
+    frustum.planes[4] = row(3) + row(2);
+    frustum.planes[5] = row(3) - row(2);
+    for (auto& plane : frustum.planes) {
+        plane /= glm::length(glm::vec3(plane));
+    }
+    return frustum;
+}
+
+bool Frustum::intersects(const AABB& box) const {
+    for (const auto& plane : planes) {
+        // 取包围盒在平面法线方向上最远的顶点
+        glm::vec3 positive(plane.x >= 0.0f ? box.max.x : box.min.x,
+                           plane.y >= 0.0f ? box.max.y : box.min.y,
+                           plane.z >= 0.0f ? box.max.z : box.min.z);
+        if (glm::dot(glm::vec3(plane), positive) + plane.w < 0.0f) return false;
+    }
+    return true;
+}
+
+bool Frustum::intersects(const glm::vec3& center, float radius) const {
+    for (const auto& plane : planes) {
+        if (glm::dot(glm::vec3(plane), center) + plane.w < -radius) return false;
+    }
+    return true;
+}
+
+}
@@ -0,0 +1,31 @@
+#pragma once
+#include <glm/glm.hpp>
+#include <limits>
+
+namespace lunar {
+
+// 轴对齐包围盒，默认构造为空盒
+struct AABB {
+    glm::vec3 min{std::numeric_limits<float>::max()};
+    glm::vec3 max{-std::numeric_limits<float>::max()};
+
+    void expand(const glm::vec3& point);
+    void expand(const AABB& other);
+    [[nodiscard]] bool isValid() const { return min.x <= max.x && min.y <= max.y && min.z <= max.z; }
+    [[nodiscard]] glm::vec3 getCenter() const { return (min + max) * 0.5f; }
+    [[nodiscard]] glm::vec3 getExtent() const { return (max - min) * 0.5f; }
+    // 变换到另一坐标系后重新求包围盒
+    [[nodiscard]] AABB transform(const glm::mat4& matrix) const;
+};
+
+// 视锥体的6个平面(法线朝内), 顺序为左右下上近远
+struct Frustum {
+    glm::vec4 planes[6];
+
+    // 从投影(或视图投影)矩阵提取平面, Gribb-Hartmann方法
+    static Frustum fromMatrix(const glm::mat4& matrix);
+    [[nodiscard]] bool intersects(const AABB& box) const;
+    [[nodiscard]] bool intersects(const glm::vec3& center, float radius) const;
+};
+
+}
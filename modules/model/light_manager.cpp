@@ -0,0 +1,166 @@
+#include "light_manager.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace lunar {
+
+// 半径超过此值的光源不放入网格, 每次查询都单独检查
+static constexpr float max_grid_radius = 1000.0f;
+// 网格每个方向最多的格子数, 超出时加大格子尺寸
+static constexpr int max_grid_dim = 64;
+
+template<typename Light>
+static float maxIntensity(const Light& light) {
+    glm::vec3 peak = light.color * glm::max(light.diffuse, light.specular);
+    return std::max(peak.x, std::max(peak.y, peak.z));
+}
+
+static float distanceToBounds(const glm::vec3& point, const AABB& bounds) {
+    glm::vec3 closest = glm::clamp(point, bounds.min, bounds.max);
+    return glm::length(closest - point);
+}
+
+LightManager::LightManager(unsigned int max_lights_per_object, float cell_size):
+    max_lights_per_object(max_lights_per_object), cell_size(cell_size) {}
+
+void LightManager::setLights(const std::vector<PointLight>& point_lights, const std::vector<SpotLight>& spot_lights) {
+    lights.clear();
+    lights.reserve(point_lights.size() + spot_lights.size());
+    auto add = [this](const auto& light) {
+        float intensity = maxIntensity(light);
+        lights.push_back({
+            .position = light.position,
+            .radius = General::getLightRadius(light.constant, light.linear, light.quadratic, intensity),
+            .intensity = intensity,
+            .constant = light.constant,
+            .linear = light.linear,
+            .quadratic = light.quadratic
+        });
+    };
+    for (const auto& light : point_lights) add(light);
+    for (const auto& light : spot_lights) add(light);
+    point_light_count = static_cast<unsigned int>(point_lights.size());
+    last_query.assign(lights.size(), 0);
+    query_stamp = 0;
+}
+
+void LightManager::update(const Frustum& camera_frustum) {
+    visible_lights.clear();
+    AABB extent;
+    for (unsigned int i = 0; i < lights.size(); i++) {
+        const LightInfo& light = lights[i];
+        if (light.radius <= 0.0f || light.intensity <= 0.0f) continue;
+        if (!camera_frustum.intersects(light.position, light.radius)) continue;
+        visible_lights.push_back(i);
+        if (light.radius <= max_grid_radius) {
+            extent.expand(light.position - glm::vec3(light.radius));
+            extent.expand(light.position + glm::vec3(light.radius));
+        }
+    }
+
+    cell_start.clear();
+    cell_lights.clear();
+    grid_dims[0] = grid_dims[1] = grid_dims[2] = 0;
+    if (!extent.isValid()) return;
+
+    glm::vec3 size = extent.max - extent.min;
+    float largest = std::max(size.x, std::max(size.y, size.z));
+    grid_cell_size = std::max(cell_size, largest / static_cast<float>(max_grid_dim));
+    grid_origin = extent.min;
+    for (int axis = 0; axis < 3; axis++) {
+        grid_dims[axis] = std::clamp(static_cast<int>(std::ceil(size[axis] / grid_cell_size)), 1, max_grid_dim);
+    }
+
+    auto cellRange = [this](const glm::vec3& low, const glm::vec3& high, int* first, int* last) {
+        for (int axis = 0; axis < 3; axis++) {
+            first[axis] = std::clamp(static_cast<int>(std::floor((low[axis] - grid_origin[axis]) / grid_cell_size)), 0, grid_dims[axis] - 1);
+            last[axis] = std::clamp(static_cast<int>(std::floor((high[axis] - grid_origin[axis]) / grid_cell_size)), 0, grid_dims[axis] - 1);
+        }
+    };
+    auto forEachCell = [this](const int* first, const int* last, auto&& callback) {
+        for (int z = first[2]; z <= last[2]; z++)
+            for (int y = first[1]; y <= last[1]; y++)
+                for (int x = first[0]; x <= last[0]; x++)
+                    callback(static_cast<size_t>((z * grid_dims[1] + y) * grid_dims[0] + x));
+    };
+
+    // 两遍计数排序: 先统计每格光源数, 前缀和后再填入
+    const size_t cell_count = static_cast<size_t>(grid_dims[0]) * grid_dims[1] * grid_dims[2];
+    cell_start.assign(cell_count + 1, 0);
+    int first[3], last[3];
+    for (unsigned int index : visible_lights) {
+        const LightInfo& light = lights[index];
+        if (light.radius > max_grid_radius) continue;
+        cellRange(light.position - glm::vec3(light.radius), light.position + glm::vec3(light.radius), first, last);
+        forEachCell(first, last, [this](size_t cell) { cell_start[cell + 1]++; });
+    }
+    for (size_t i = 0; i < cell_count; i++) cell_start[i + 1] += cell_start[i];
+    cell_lights.resize(cell_start[cell_count]);
+    std::vector<unsigned int> cursor(cell_start.begin(), cell_start.end() - 1);
+    for (unsigned int index : visible_lights) {
+        const LightInfo& light = lights[index];
+        if (light.radius > max_grid_radius) continue;
+        cellRange(light.position - glm::vec3(light.radius), light.position + glm::vec3(light.radius), first, last);
+        forEachCell(first, last, [this, &cursor, index](size_t cell) { cell_lights[cursor[cell]++] = index; });
+    }
+}
+
+float LightManager::contribution(const LightInfo& light, const AABB& bounds) const {
+    float distance = distanceToBounds(light.position, bounds);
+    if (distance > light.radius) return 0.0f;
+    return light.intensity / (light.constant + light.linear * distance + light.quadratic * distance * distance);
+}
+
+void LightManager::assignLights(const AABB& object_bounds, std::vector<unsigned int>& result) const {
+    result.clear();
+    if (visible_lights.empty() || !object_bounds.isValid()) return;
+
+    candidates.clear();
+    if (++query_stamp == 0) {
+        std::fill(last_query.begin(), last_query.end(), 0);
+        query_stamp = 1;
+    }
+    auto consider = [&](unsigned int index) {
+        if (last_query[index] == query_stamp) return;
+        last_query[index] = query_stamp;
+        float score = contribution(lights[index], object_bounds);
+        if (score > 0.0f) candidates.emplace_back(score, index);
+    };
+
+    for (unsigned int index : visible_lights) {
+        if (lights[index].radius > max_grid_radius) consider(index);
+    }
+    if (grid_dims[0] > 0) {
+        int first[3], last[3];
+        bool overlaps = true;
+        for (int axis = 0; axis < 3; axis++) {
+            float grid_max = grid_origin[axis] + grid_dims[axis] * grid_cell_size;
+            if (object_bounds.max[axis] < grid_origin[axis] || object_bounds.min[axis] > grid_max) overlaps = false;
+            first[axis] = std::clamp(static_cast<int>(std::floor((object_bounds.min[axis] - grid_origin[axis]) / grid_cell_size)), 0, grid_dims[axis] - 1);
+            last[axis] = std::clamp(static_cast<int>(std::floor((object_bounds.max[axis] - grid_origin[axis]) / grid_cell_size)), 0, grid_dims[axis] - 1);
+        }
+        if (overlaps) {
+            for (int z = first[2]; z <= last[2]; z++)
+                for (int y = first[1]; y <= last[1]; y++)
+                    for (int x = first[0]; x <= last[0]; x++) {
+                        size_t cell = static_cast<size_t>((z * grid_dims[1] + y) * grid_dims[0] + x);
+                        for (unsigned int i = cell_start[cell]; i < cell_start[cell + 1]; i++) consider(cell_lights[i]);
+                    }
+        }
+    }
+
+    size_t count = std::min<size_t>(candidates.size(), max_lights_per_object);
+    std::partial_sort(candidates.begin(), candidates.begin() + count, candidates.end(),
+                      [](const auto& a, const auto& b) { return a.first > b.first; });
+    for (size_t i = 0; i < count; i++) result.push_back(candidates[i].second);
+}
+
+std::vector<std::vector<unsigned int>> LightManager::assignLights(const std::vector<AABB>& objects) const {
+    std::vector<std::vector<unsigned int>> result(objects.size());
+    for (size_t i = 0; i < objects.size(); i++) {
+        assignLights(objects[i], result[i]);
+    }
+    return result;
+}
+
+}
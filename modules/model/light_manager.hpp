@@ -0,0 +1,57 @@
+#pragma once
+#include "material.hpp"
+#include "bounds.hpp"
+#include <glm/glm.hpp>
+#include <vector>
+
+namespace lunar {
+
+// CPU端的光源管理: 由衰减系数推导每个光源的影响半径, 用相机视锥剔除光源,
+// 再通过均匀网格为每个物体挑选贡献最大的若干个光源.
+// 光源编号: 点光源在前 [0, 点光源数), 聚光灯在后.
+class LightManager {
+public:
+    explicit LightManager(unsigned int max_lights_per_object = 8, float cell_size = 4.0f);
+
+    void setLights(const std::vector<PointLight>& point_lights, const std::vector<SpotLight>& spot_lights);
+    // 每帧相机或光源移动后调用, 重新剔除并重建网格
+    void update(const Frustum& camera_frustum);
+
+    // 按贡献从大到小写入result, 最多max_lights_per_object个
+    void assignLights(const AABB& object_bounds, std::vector<unsigned int>& result) const;
+    [[nodiscard]] std::vector<std::vector<unsigned int>> assignLights(const std::vector<AABB>& objects) const;
+
+    [[nodiscard]] const std::vector<unsigned int>& getVisibleLights() const { return visible_lights; }
+    [[nodiscard]] float getRadius(unsigned int light) const { return lights[light].radius; }
+    [[nodiscard]] unsigned int getLightCount() const { return static_cast<unsigned int>(lights.size()); }
+    [[nodiscard]] unsigned int getPointLightCount() const { return point_light_count; }
+
+private:
+    struct LightInfo {
+        glm::vec3 position;
+        float radius;
+        float intensity;
+        float constant, linear, quadratic;
+    };
+
+    [[nodiscard]] float contribution(const LightInfo& light, const AABB& bounds) const;
+
+    unsigned int max_lights_per_object;
+    float cell_size;
+    unsigned int point_light_count{0};
+    std::vector<LightInfo> lights;
+    std::vector<unsigned int> visible_lights;
+
+    // 覆盖所有可见光源的均匀网格, 以压缩行(CSR)形式存储每个格子里的光源
+    glm::vec3 grid_origin{0.0f};
+    float grid_cell_size{1.0f};
+    int grid_dims[3]{0, 0, 0};
+    std::vector<unsigned int> cell_start;
+    std::vector<unsigned int> cell_lights;
+    // 查询时用来去重, 同一光源可能出现在多个格子里
+    mutable std::vector<unsigned int> last_query;
+    mutable unsigned int query_stamp{0};
+    mutable std::vector<std::pair<float, unsigned int>> candidates;
+};
+
+}
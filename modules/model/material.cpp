@@ -1,4 +1,7 @@
 #include "material.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
 
 namespace lunar {
 
@@ -6,6 +9,16 @@ glm::mat3 General::getNormalMatrix(glm::mat4 model) {
     return glm::mat3(glm::transpose(glm::inverse(model)));
 }
 
+float General::getLightRadius(float constant, float linear, float quadratic, float max_intensity, float threshold) {
+    // 解 max_intensity / (constant + linear * d + quadratic * d^2) = threshold
+    float c = constant - max_intensity / threshold;
+    if (quadratic <= 0.0f) {
+        return linear > 0.0f ? std::max(0.0f, -c / linear) : std::numeric_limits<float>::infinity();
+    }
+    float discriminant = linear * linear - 4.0f * quadratic * c;
+    return std::max(0.0f, (-linear + std::sqrt(std::max(discriminant, 0.0f))) / (2.0f * quadratic));
+}
+
 //from http://devernay.free.fr/cours/opengl/materials.html
 std::map<std::string, Material> General::materials = {
     {"emerald", {
@@ -154,50 +167,29 @@ std::map<std::string, Material> General::materials = {
     }}
 };
 
-std::map<float, std::pair<double, double>> General::point_attenuation_factors = {
-    {3250, {0.0014, 0.000007}},
-    {600, {0.007, 0.0002}},
-    {325, {0.014, 0.0007}},
-    {200, {0.022, 0.0019}},
-    {160, {0.027, 0.0028}},
-    {100, {0.045, 0.0075}},
-    {65, {0.07, 0.017}},
-    {50, {0.09, 0.032}},
-    {32, {0.14, 0.07}},
-    {20, {0.22, 0.20}},
-    {13, {0.35, 0.44}},
-    {7, {0.7, 1.8}},
-    {0.1, {400, 4500}}
-};
-
-std::pair<double, double> General::getPointAttenuationFactor(float distance) {
-    auto it = point_attenuation_factors.lower_bound(distance);
+std::pair<float, float> General::getPointAttenuationFactor(float distance) {
+    float linear, quadratic;
+    getPointAttenuationFactors(&distance, &linear, &quadratic, 1);
+    return {linear, quadratic};
+}
 
-    if (it == point_attenuation_factors.end()) {
-        auto last = point_attenuation_factors.rbegin();
-        auto second_last = std::next(point_attenuation_factors.rbegin());
-        
-        float t = (distance - last->first) / (last->first - second_last->first);
-        
-        return {
-            last->second.first + (last->second.first - second_last->second.first) * t,
-            last->second.second + (last->second.second - second_last->second.second) * t
-        };
+void General::getPointAttenuationFactors(const float* distances, float* linear, float* quadratic, size_t count) {
+    constexpr const AttenuationEntry* table = point_attenuation_table;
+    constexpr size_t last_segment = point_attenuation_table_size - 2;
+    for (size_t i = 0; i < count; i++) {
+        const float distance = distances[i];
+        // 区间下标等于"不大于distance的内部节点数", 用比较结果求和代替查找
+        size_t segment = 0;
+        for (size_t k = 1; k <= last_segment; k++) {
+            segment += static_cast<size_t>(distance >= table[k].distance);
+        }
+        const AttenuationEntry& low = table[segment];
+        const AttenuationEntry& high = table[segment + 1];
+        // 只需截断下界: 中间区间t本就不小于0, 最后一段允许t大于1以外推
+        const float t = std::max((distance - low.distance) / (high.distance - low.distance), 0.0f);
+        linear[i] = low.linear + (high.linear - low.linear) * t;
+        quadratic[i] = low.quadratic + (high.quadratic - low.quadratic) * t;
     }
-    
-    if (it == point_attenuation_factors.begin()) {
-        return it->second;
-    }
-    
-    auto high = it;
-    auto low = std::prev(it);
-    
-    float t = (distance - low->first) / (high->first - low->first);
-    
-    return {
-        low->second.first * (1 - t) + high->second.first * t,
-        low->second.second * (1 - t) + high->second.second * t
-    };
 }
 
-}
\ No newline at end of file
+}
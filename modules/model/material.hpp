@@ -2,6 +2,8 @@
 #include <glm/glm.hpp>
 #include <map>
 #include <string>
+#include <utility>
+#include <cstddef>
 
 namespace lunar {
 
@@ -43,6 +45,9 @@ struct SpotLight {
     float constant;
     float linear;
     float quadratic;
+
+    float cutoff;       // 内锥角的余弦
+    float outer_cutoff; // 外锥角的余弦
 };
 
 struct ParallelLight {
@@ -59,11 +64,39 @@ struct MaterialTexture {
     float shininess;
 };
 
+// 点光源衰减系数表: 覆盖距离 -> (一次项, 二次项), 按距离升序排列
+struct AttenuationEntry {
+    float distance;
+    float linear;
+    float quadratic;
+};
+
 class General {
     public:
-    static std::pair<double, double> getPointAttenuationFactor(float distance);
+    static constexpr AttenuationEntry point_attenuation_table[] = {
+        {0.1f, 400.0f, 4500.0f},
+        {7.0f, 0.7f, 1.8f},
+        {13.0f, 0.35f, 0.44f},
+        {20.0f, 0.22f, 0.20f},
+        {32.0f, 0.14f, 0.07f},
+        {50.0f, 0.09f, 0.032f},
+        {65.0f, 0.07f, 0.017f},
+        {100.0f, 0.045f, 0.0075f},
+        {160.0f, 0.027f, 0.0028f},
+        {200.0f, 0.022f, 0.0019f},
+        {325.0f, 0.014f, 0.0007f},
+        {600.0f, 0.007f, 0.0002f},
+        {3250.0f, 0.0014f, 0.000007f},
+    };
+    static constexpr size_t point_attenuation_table_size = sizeof(point_attenuation_table) / sizeof(AttenuationEntry);
+
+    // 在表中线性插值, 小于最小距离时取第一项, 大于最大距离时按最后两项外推
+    static std::pair<float, float> getPointAttenuationFactor(float distance);
+    // 批量版本, 循环内没有分支, 便于编译器向量化
+    static void getPointAttenuationFactors(const float* distances, float* linear, float* quadratic, size_t count);
     static glm::mat3 getNormalMatrix(glm::mat4 model);
+    // 衰减后亮度降到threshold以下的距离, 超出此距离的光照可以忽略
+    static float getLightRadius(float constant, float linear, float quadratic, float max_intensity, float threshold = 5.0f / 256.0f);
     static std::map<std::string, Material> materials;
-    static std::map<float, std::pair<double, double>> point_attenuation_factors;
 };
 }
\ No newline at end of file
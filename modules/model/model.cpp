@@ -1,5 +1,6 @@
 #include "model.hpp"
 #include "render/shader.hpp"
+#include "profile/profile_scope.hpp"
 #include <stdexcept>
 #include <iostream>
 #include <algorithm>
@@ -27,10 +28,16 @@ void Mesh::Draw(ShaderProgram &shader) {
     // 绘制网格
     glBindVertexArray(VAO);
     glDrawElements(GL_TRIANGLES, indices.size(), GL_UNSIGNED_INT, 0);
+    LUNAR_PROFILE_COUNT(DrawCalls, 1);
+    LUNAR_PROFILE_COUNT(Triangles, indices.size() / 3);
     glBindVertexArray(0);
 }
 
 void Mesh::init(){
+    for (const auto& vertex : vertices) {
+        bounds.expand(vertex.position);
+    }
+
     glGenVertexArrays(1, &VAO);
     glGenBuffers(1, &VBO);
     glGenBuffers(1, &EBO);
@@ -85,11 +92,15 @@ unsigned int ModelLoader::processFBXFlags() const {
 }
 
 std::vector<Mesh> ModelLoader::loadModel(const std::string& path) {
+    LUNAR_PROFILE_SCOPE("model load");
     Assimp::Importer import;
     unsigned int flags = isFBX(path) ? processFBXFlags() : 
         (aiProcess_Triangulate | aiProcess_FlipUVs | aiProcess_GenNormals);
     
-    scene = import.ReadFile(path, flags);
+    {
+        LUNAR_PROFILE_SCOPE("model import");
+        scene = import.ReadFile(path, flags);
+    }
 
     if(!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode) {
         throw std::runtime_error(std::string("Model Import Error: ASSIMP::") + import.GetErrorString());
@@ -133,6 +144,7 @@ std::vector<Mesh> ModelLoader::processNode(aiNode *node, const aiScene *scene) {
 }
 
 Mesh ModelLoader::processMesh(aiMesh *mesh, const aiScene *scene) {
+    LUNAR_PROFILE_SCOPE("model process mesh");
     std::vector<Vertex> vertices;
     std::vector<unsigned int> indices;
     std::vector<Texture> textures;
@@ -165,6 +177,7 @@ Mesh ModelLoader::processMesh(aiMesh *mesh, const aiScene *scene) {
 }
 
 void ModelLoader::loadMaterialTextures(std::vector<Texture>& textures, aiMaterial *mat, aiTextureType type) {
+    LUNAR_PROFILE_SCOPE("model load textures");
     TextureType texture_type = TextureType::Diffuse;
     if (type == aiTextureType_DIFFUSE) {
         texture_type = TextureType::Diffuse;
@@ -260,4 +273,22 @@ void Model::Draw(ShaderProgram &shader) {
     }
 }
 
+void Model::Draw(ShaderProgram &shader, const std::vector<unsigned char>& mesh_visibility) {
+    shader.setMat3("normalMatrix", normal_matrix);
+    shader.setMat4("model", model);
+    for(size_t i = 0; i < meshes.size(); i++) {
+        if (i < mesh_visibility.size() && !mesh_visibility[i]) continue;
+        meshes[i].Draw(shader);
+    }
+}
+
+std::vector<AABB> Model::getMeshBounds() const {
+    std::vector<AABB> bounds;
+    bounds.reserve(meshes.size());
+    for (const auto& mesh : meshes) {
+        bounds.push_back(mesh.getBounds().transform(model));
+    }
+    return bounds;
+}
+
 } // namespace lunar
\ No newline at end of file
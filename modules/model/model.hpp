@@ -2,6 +2,7 @@
 #include "glm/glm.hpp"
 #include "texture.hpp"
 #include "material.hpp"
+#include "bounds.hpp"
 #include <assimp/Importer.hpp>
 #include <assimp/scene.h>
 #include <assimp/postprocess.h>
@@ -26,8 +27,11 @@ public:
     std::vector<Texture> textures;
     Mesh(std::vector<Vertex> vertices, std::vector<unsigned int> indices, std::vector<Texture> textures, float shininess=32.0f);
     void Draw(ShaderProgram &shader);
+    [[nodiscard]] const AABB& getBounds() const { return bounds; }
+    [[nodiscard]] float getShininess() const { return shininess; }
 private:
     float shininess;
+    AABB bounds;
     unsigned int VAO, VBO, EBO;
     void init();
 };
@@ -36,6 +40,11 @@ class Model {
 public:
     explicit Model(std::string path);
     void Draw(ShaderProgram &shader);   
+    // mesh_visibility[i]为0的网格会被跳过，超出范围的网格视为可见
+    void Draw(ShaderProgram &shader, const std::vector<unsigned char>& mesh_visibility);
+    // 世界空间下每个网格的包围盒，顺序与Draw中的网格顺序一致
+    [[nodiscard]] std::vector<AABB> getMeshBounds() const;
+    [[nodiscard]] const std::vector<Mesh>& getMeshes() const { return meshes; }
 private:
     std::vector<Mesh> meshes;
     glm::mat4 model;
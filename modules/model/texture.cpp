@@ -3,6 +3,7 @@
 #include <iostream>
 #include <algorithm>
 #include <stb_image/stb_image.h>
+#include "profile/profile_scope.hpp"
 
 namespace lunar{
 
@@ -38,6 +39,10 @@ Texture::Texture(const std::string &filename,
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, filter_param_min);
     if (data) {
         glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
+        LUNAR_PROFILE_COUNT(Allocations, 1);
+        LUNAR_PROFILE_COUNT(AllocatedBytes, static_cast<uint64_t>(width) * height * channels);
+        LUNAR_PROFILE_COUNT(Uploads, 1);
+        LUNAR_PROFILE_COUNT(UploadBytes, static_cast<uint64_t>(width) * height * channels);
         if (generate_mitmap){
             glGenerateMipmap(GL_TEXTURE_2D);
         }
@@ -80,6 +85,10 @@ Texture::Texture(const std::string &name,
 
     if (data) {
         glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
+        LUNAR_PROFILE_COUNT(Allocations, 1);
+        LUNAR_PROFILE_COUNT(AllocatedBytes, static_cast<uint64_t>(width) * height * channels);
+        LUNAR_PROFILE_COUNT(Uploads, 1);
+        LUNAR_PROFILE_COUNT(UploadBytes, static_cast<uint64_t>(width) * height * channels);
         if (generate_mitmap){
             glGenerateMipmap(GL_TEXTURE_2D);
         }
@@ -0,0 +1,99 @@
+#include "chrome_trace.hpp"
+#include <cstdio>
+
+namespace lunar {
+
+void writeJSONString(std::ostream& out, std::string_view text) {
+    out << '"';
+    for (char c : text) {
+        switch (c) {
+            case '"':  out << "\\\""; break;
+            case '\\': out << "\\\\"; break;
+            case '\n': out << "\\n"; break;
+            case '\t': out << "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    char escaped[8];
+                    std::snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+                    out << escaped;
+                } else {
+                    out << c;
+                }
+        }
+    }
+    out << '"';
+}
+
+ChromeTraceWriter::ChromeTraceWriter(std::ostream& out): out(out) {
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+}
+
+ChromeTraceWriter::~ChromeTraceWriter() {
+    finish();
+}
+
+void ChromeTraceWriter::finish() {
+    if (finished) return;
+    out << "\n]}\n";
+    out.flush();
+    finished = true;
+}
+
+void ChromeTraceWriter::beginEvent() {
+    out << (first ? "\n" : ",\n");
+    first = false;
+}
+
+void ChromeTraceWriter::writeNumber(double value) {
+    // 微秒保留到纳秒, 不使用流的格式状态以免长时间戳变成科学计数法
+    char text[32];
+    std::snprintf(text, sizeof(text), "%.3f", value);
+    out << text;
+}
+
+void ChromeTraceWriter::setProcessName(uint32_t pid, std::string_view name) {
+    beginEvent();
+    out << "{\"ph\":\"M\",\"name\":\"process_name\",\"pid\":" << pid << ",\"args\":{\"name\":";
+    writeJSONString(out, name);
+    out << "}}";
+}
+
+void ChromeTraceWriter::setThreadName(uint32_t pid, uint32_t tid, std::string_view name) {
+    beginEvent();
+    out << "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":" << pid << ",\"tid\":" << tid << ",\"args\":{\"name\":";
+    writeJSONString(out, name);
+    out << "}}";
+}
+
+void ChromeTraceWriter::addComplete(std::string_view name, uint32_t pid, uint32_t tid, double begin_us, double duration_us) {
+    beginEvent();
+    out << "{\"ph\":\"X\",\"name\":";
+    writeJSONString(out, name);
+    out << ",\"pid\":" << pid << ",\"tid\":" << tid << ",\"ts\":";
+    writeNumber(begin_us);
+    out << ",\"dur\":";
+    writeNumber(duration_us);
+    out << "}";
+}
+
+void ChromeTraceWriter::addInstant(std::string_view name, uint32_t pid, uint32_t tid, double time_us) {
+    beginEvent();
+    out << "{\"ph\":\"i\",\"s\":\"g\",\"name\":";
+    writeJSONString(out, name);
+    out << ",\"pid\":" << pid << ",\"tid\":" << tid << ",\"ts\":";
+    writeNumber(time_us);
+    out << "}";
+}
+
+void ChromeTraceWriter::addCounter(std::string_view name, uint32_t pid, double time_us, double value) {
+    beginEvent();
+    out << "{\"ph\":\"C\",\"name\":";
+    writeJSONString(out, name);
+    out << ",\"pid\":" << pid << ",\"ts\":";
+    writeNumber(time_us);
+    out << ",\"args\":{\"value\":";
+    writeNumber(value);
+    out << "}}";
+}
+
+}
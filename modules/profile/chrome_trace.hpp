@@ -0,0 +1,38 @@
+#pragma once
+#include <cstdint>
+#include <ostream>
+#include <string_view>
+
+namespace lunar {
+
+// 按JSON的规则转义并加上引号写出, 控制字符写成unicode转义
+void writeJSONString(std::ostream& out, std::string_view text);
+
+// 按Chrome trace event格式(chrome://tracing, Perfetto均可打开)流式写出事件, 时间单位为微秒
+class ChromeTraceWriter {
+public:
+    explicit ChromeTraceWriter(std::ostream& out);
+    ~ChromeTraceWriter();
+    ChromeTraceWriter(const ChromeTraceWriter&) = delete;
+    ChromeTraceWriter& operator=(const ChromeTraceWriter&) = delete;
+
+    void setProcessName(uint32_t pid, std::string_view name);
+    void setThreadName(uint32_t pid, uint32_t tid, std::string_view name);
+    // 有起止时间的区间事件
+    void addComplete(std::string_view name, uint32_t pid, uint32_t tid, double begin_us, double duration_us);
+    // 瞬时事件, 例如标记卡顿的帧
+    void addInstant(std::string_view name, uint32_t pid, uint32_t tid, double time_us);
+    void addCounter(std::string_view name, uint32_t pid, double time_us, double value);
+    // 析构时自动调用
+    void finish();
+
+private:
+    void beginEvent();
+    void writeNumber(double value);
+
+    std::ostream& out;
+    bool first{true};
+    bool finished{false};
+};
+
+}
@@ -0,0 +1,12 @@
+#include "clock.hpp"
+#include <chrono>
+
+namespace lunar {
+
+static const std::chrono::steady_clock::time_point profile_epoch = std::chrono::steady_clock::now();
+
+double getProfileTimeMicroseconds() {
+    return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - profile_epoch).count();
+}
+
+}
@@ -0,0 +1,8 @@
+#pragma once
+
+namespace lunar {
+
+// 各个分析工具共用的时间基准: 进程内第一次调用时为零点, 单位微秒, 基于steady_clock
+double getProfileTimeMicroseconds();
+
+}
@@ -0,0 +1,213 @@
+#include "cpu_tracer.hpp"
+#include "chrome_trace.hpp"
+#include "clock.hpp"
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+
+namespace lunar {
+
+size_t CpuScopeRing::drain(std::vector<CpuScopeEvent>& out) {
+    const uint64_t read = tail.load(std::memory_order_relaxed);
+    const uint64_t write = head.load(std::memory_order_acquire);
+    for (uint64_t i = read; i != write; i++) {
+        out.push_back(events[i & (capacity - 1)]);
+    }
+    tail.store(write, std::memory_order_release);
+    return static_cast<size_t>(write - read);
+}
+
+CpuTracer::CpuTracer() {
+    base_ticks = now();
+    base_us = getProfileTimeMicroseconds();
+#if !LUNAR_PROFILE_RDTSC
+    using period = std::chrono::steady_clock::period;
+    ticks_per_us = static_cast<double>(period::den) / (static_cast<double>(period::num) * 1e6);
+#endif
+}
+
+CpuTracer::~CpuTracer() {
+    stop();
+}
+
+CpuScopeRing* CpuTracer::registerThread() {
+    // 线程退出时标记缓冲, 由收集线程取空后释放
+    struct ThreadExit {
+        ~ThreadExit() {
+            if (thread_ring) thread_ring->retire();
+            thread_ring = nullptr;
+        }
+    };
+    thread_local ThreadExit thread_exit;
+
+    CpuTracer& tracer = getInstance();
+    std::lock_guard lock(tracer.mutex);
+    const auto thread = static_cast<uint32_t>(tracer.thread_names.size());
+    tracer.thread_names.push_back("thread " + std::to_string(thread));
+    tracer.threads.push_back({std::make_unique<CpuScopeRing>(), thread});
+    thread_ring = tracer.threads.back().ring.get();
+    return thread_ring;
+}
+
+void CpuTracer::setThreadName(const std::string& name) {
+    CpuScopeRing* ring = thread_ring ? thread_ring : registerThread();
+    CpuTracer& tracer = getInstance();
+    std::lock_guard lock(tracer.mutex);
+    for (const ThreadSlot& slot : tracer.threads) {
+        if (slot.ring.get() == ring) {
+            tracer.thread_names[slot.thread] = name;
+            return;
+        }
+    }
+}
+
+void CpuTracer::start(const std::string& trace_path, std::chrono::milliseconds drain_interval) {
+    stop();
+    std::lock_guard lock(mutex);
+    this->trace_path = trace_path;
+    stopping = false;
+    running = true;
+    collector = std::thread(&CpuTracer::run, this, drain_interval);
+}
+
+void CpuTracer::stop() {
+    {
+        std::lock_guard lock(mutex);
+        if (!running) return;
+        stopping = true;
+    }
+    wake.notify_all();
+    collector.join();
+
+    std::string path;
+    {
+        std::lock_guard lock(mutex);
+        running = false;
+        collectLocked();
+        path = trace_path;
+    }
+    if (!path.empty() && !writeChromeTrace(path)) {
+        std::cerr << "Failed to write CPU trace to " << path << std::endl;
+    }
+}
+
+void CpuTracer::run(std::chrono::milliseconds drain_interval) {
+    std::unique_lock lock(mutex);
+    while (!stopping) {
+        wake.wait_for(lock, drain_interval, [this] { return stopping; });
+        collectLocked();
+    }
+}
+
+void CpuTracer::collect() {
+    std::lock_guard lock(mutex);
+    collectLocked();
+}
+
+void CpuTracer::collectLocked() {
+    for (size_t i = 0; i < threads.size();) {
+        ThreadSlot& slot = threads[i];
+        // 先读退出标记再取, 保证释放前线程的最后一批事件已经取出
+        const bool retired = slot.ring->isRetired();
+        scratch.clear();
+        slot.ring->drain(scratch);
+        for (const CpuScopeEvent& event : scratch) {
+            if (collected.size() < event_capacity) {
+                collected.push_back({event, slot.thread});
+            } else {
+                collected[collected_next] = {event, slot.thread};
+                collected_next = (collected_next + 1) % event_capacity;
+            }
+        }
+        if (retired) {
+            retired_dropped += slot.ring->getDroppedCount();
+            threads.erase(threads.begin() + static_cast<std::ptrdiff_t>(i));
+        } else {
+            i++;
+        }
+    }
+    calibrate();
+}
+
+void CpuTracer::calibrate() {
+#if LUNAR_PROFILE_RDTSC
+    // 假定TSC恒定频率, 与基准点相隔越久斜率越准; 刚启动时最多等待1毫秒
+    uint64_t ticks = now();
+    double us = getProfileTimeMicroseconds();
+    while (us - base_us < 1000.0) {
+        ticks = now();
+        us = getProfileTimeMicroseconds();
+    }
+    ticks_per_us = static_cast<double>(ticks - base_ticks) / (us - base_us);
+#endif
+}
+
+void CpuTracer::setEventCapacity(size_t capacity) {
+    std::lock_guard lock(mutex);
+    // 按时间先后重排之后截掉最旧的
+    std::rotate(collected.begin(), collected.begin() + static_cast<std::ptrdiff_t>(collected_next), collected.end());
+    event_capacity = std::max<size_t>(capacity, 1);
+    if (collected.size() > event_capacity) {
+        collected.erase(collected.begin(), collected.end() - static_cast<std::ptrdiff_t>(event_capacity));
+    }
+    collected_next = 0;
+}
+
+void CpuTracer::clear() {
+    std::lock_guard lock(mutex);
+    collectLocked();
+    collected.clear();
+    collected_next = 0;
+}
+
+double CpuTracer::toMicroseconds(uint64_t ticks) {
+    std::lock_guard lock(mutex);
+    calibrate();
+    return base_us + (static_cast<double>(ticks) - static_cast<double>(base_ticks)) / ticks_per_us;
+}
+
+void CpuTracer::writeChromeTrace(ChromeTraceWriter& writer, uint32_t pid, uint32_t first_tid, double begin_us, double end_us) {
+    std::lock_guard lock(mutex);
+    collectLocked();
+    for (size_t i = 0; i < thread_names.size(); i++) {
+        writer.setThreadName(pid, first_tid + static_cast<uint32_t>(i), thread_names[i]);
+    }
+    for (const CollectedEvent& event : collected) {
+        const double begin = base_us + (static_cast<double>(event.scope.begin) - static_cast<double>(base_ticks)) / ticks_per_us;
+        const double duration = static_cast<double>(event.scope.end - event.scope.begin) / ticks_per_us;
+        if (begin + duration < begin_us || begin > end_us) continue;
+        writer.addComplete(event.scope.name, pid, first_tid + event.thread, begin, duration);
+    }
+}
+
+bool CpuTracer::writeChromeTrace(const std::string& path) {
+    std::ofstream file(path);
+    if (!file) return false;
+    ChromeTraceWriter writer(file);
+    writer.setProcessName(1, "lunar");
+    writeChromeTrace(writer);
+    writer.finish();
+    return static_cast<bool>(file);
+}
+
+size_t CpuTracer::getEventCount() {
+    std::lock_guard lock(mutex);
+    collectLocked();
+    return collected.size();
+}
+
+uint64_t CpuTracer::getDroppedCount() {
+    std::lock_guard lock(mutex);
+    uint64_t dropped = retired_dropped;
+    for (const ThreadSlot& slot : threads) {
+        dropped += slot.ring->getDroppedCount();
+    }
+    return dropped;
+}
+
+size_t CpuTracer::getThreadCount() {
+    std::lock_guard lock(mutex);
+    return thread_names.size();
+}
+
+}
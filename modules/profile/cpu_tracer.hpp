@@ -0,0 +1,173 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#include <x86intrin.h>
+#define LUNAR_PROFILE_RDTSC 1
+#else
+#define LUNAR_PROFILE_RDTSC 0
+#endif
+
+namespace lunar {
+
+class ChromeTraceWriter;
+
+// 一个结束的作用域; 名字必须是字符串字面量等静态存储的字符串, 只保存指针
+struct CpuScopeEvent {
+    const char* name{nullptr};
+    uint64_t begin{0}, end{0};  // CpuTracer::now()的计数
+};
+
+// 每个线程一个单生产者单消费者的环形缓冲: 所属线程写入, 收集线程读出.
+// 写满时丢弃新的事件并计数, 热路径上从不加锁也不分配内存
+class CpuScopeRing {
+public:
+    static constexpr size_t capacity = 1 << 14;
+
+    // 只能由所属线程调用
+    bool push(const char* name, uint64_t begin, uint64_t end) {
+        const uint64_t write = head.load(std::memory_order_relaxed);
+        if (write - cached_tail >= capacity) {
+            cached_tail = tail.load(std::memory_order_acquire);
+            if (write - cached_tail >= capacity) {
+                dropped.store(dropped.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+                return false;
+            }
+        }
+        events[write & (capacity - 1)] = {name, begin, end};
+        head.store(write + 1, std::memory_order_release);
+        return true;
+    }
+    // 只能由收集线程调用, 把现有的事件追加到out, 返回取出的数量
+    size_t drain(std::vector<CpuScopeEvent>& out);
+
+    [[nodiscard]] uint64_t getDroppedCount() const { return dropped.load(std::memory_order_relaxed); }
+    // 所属线程退出时标记, 取空之后缓冲可以释放
+    void retire() { retired.store(true, std::memory_order_release); }
+    [[nodiscard]] bool isRetired() const { return retired.load(std::memory_order_acquire); }
+
+private:
+    // 生产者与消费者的计数各占一条缓存行, 避免伪共享
+    alignas(64) std::atomic<uint64_t> head{0};
+    uint64_t cached_tail{0};
+    std::atomic<uint64_t> dropped{0};
+    std::atomic<bool> retired{false};
+    alignas(64) std::atomic<uint64_t> tail{0};
+    alignas(64) CpuScopeEvent events[capacity];
+};
+
+// CPU作用域追踪: LUNAR_PROFILE_SCOPE记录到各线程的环形缓冲, 收集线程定期取出,
+// 按需或在stop时写成Chrome trace. 时间戳在x86上用rdtsc, 收集时换算到getProfileTimeMicroseconds的时钟
+class CpuTracer {
+public:
+    static constexpr size_t default_event_capacity = 1 << 18;
+
+    static CpuTracer& getInstance() {
+        static CpuTracer instance;
+        return instance;
+    }
+    CpuTracer(const CpuTracer&) = delete;
+    CpuTracer& operator=(const CpuTracer&) = delete;
+
+    static uint64_t now() {
+#if LUNAR_PROFILE_RDTSC
+        return __rdtsc();
+#else
+        return std::chrono::steady_clock::now().time_since_epoch().count();
+#endif
+    }
+    static void record(const char* name, uint64_t begin, uint64_t end) {
+        CpuScopeRing* ring = thread_ring;
+        if (!ring) ring = registerThread();
+        ring->push(name, begin, end);
+    }
+    // 给当前线程命名, 同时完成注册; name会被复制
+    static void setThreadName(const std::string& name);
+
+    // 启动收集线程; trace_path不为空时stop会把收集到的事件写到这里
+    void start(const std::string& trace_path = "", std::chrono::milliseconds drain_interval = std::chrono::milliseconds(10));
+    // 停止收集线程, 取出剩余的事件, 按start时的路径写出
+    void stop();
+    [[nodiscard]] bool isRunning() const { return running; }
+
+    // 立即从所有线程的缓冲取出事件; 收集线程之外也可以调用
+    void collect();
+    // 只保留最近的capacity个事件, 更早的被覆盖
+    void setEventCapacity(size_t capacity);
+    void clear();
+
+    // 写出之前先collect; 各线程的tid从first_tid开始编号, 只写与[begin_us, end_us]相交的区间
+    void writeChromeTrace(ChromeTraceWriter& writer, uint32_t pid = 1, uint32_t first_tid = 16,
+                          double begin_us = -std::numeric_limits<double>::infinity(),
+                          double end_us = std::numeric_limits<double>::infinity());
+    bool writeChromeTrace(const std::string& path);
+
+    // 计数换算成微秒
+    [[nodiscard]] double toMicroseconds(uint64_t ticks);
+    [[nodiscard]] size_t getEventCount();
+    [[nodiscard]] uint64_t getDroppedCount();
+    [[nodiscard]] size_t getThreadCount();
+
+private:
+    struct ThreadSlot {
+        std::unique_ptr<CpuScopeRing> ring;
+        uint32_t thread{0};  // thread_names中的下标
+    };
+    struct CollectedEvent {
+        CpuScopeEvent scope;
+        uint32_t thread{0};
+    };
+
+    CpuTracer();
+    ~CpuTracer();
+    static CpuScopeRing* registerThread();
+    void collectLocked();
+    void calibrate();
+    void run(std::chrono::milliseconds drain_interval);
+
+    inline static thread_local CpuScopeRing* thread_ring = nullptr;
+
+    std::mutex mutex;  // 保护以下所有成员
+    std::vector<ThreadSlot> threads;  // 线程退出后缓冲保留, 直到被取完
+    std::vector<std::string> thread_names;  // 所有注册过的线程, 包括已经退出的
+    uint64_t retired_dropped{0};
+    std::vector<CollectedEvent> collected;  // 环形, 写满后覆盖最旧的
+    size_t collected_next{0};
+    size_t event_capacity{default_event_capacity};
+    std::vector<CpuScopeEvent> scratch;
+    std::string trace_path;
+
+    // 计数与微秒的换算: us = base_us + (ticks - base_ticks) / ticks_per_us
+    uint64_t base_ticks{0};
+    double base_us{0.0};
+    double ticks_per_us{1.0};
+
+    std::thread collector;
+    std::condition_variable wake;
+    bool running{false};
+    bool stopping{false};
+};
+
+// 构造时记录开始的计数, 析构时把整个区间写入当前线程的缓冲
+class CpuProfileScope {
+public:
+    explicit CpuProfileScope(const char* name): name(name), begin(CpuTracer::now()) {}
+    ~CpuProfileScope() { CpuTracer::record(name, begin, CpuTracer::now()); }
+    CpuProfileScope(const CpuProfileScope&) = delete;
+    CpuProfileScope& operator=(const CpuProfileScope&) = delete;
+
+private:
+    const char* name;
+    uint64_t begin;
+};
+
+}
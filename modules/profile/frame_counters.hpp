@@ -0,0 +1,46 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace lunar {
+
+enum class FrameCounter : uint8_t {
+    DrawCalls,
+    Triangles,       // CPU发出的绘制中的三角形; GPU驱动的间接绘制数量只有GPU知道, 不计入
+    Dispatches,
+    Uploads,         // glBufferSubData, 纹理数据等CPU到GPU的传输
+    UploadBytes,
+    Allocations,     // 新建的纹理与缓冲区
+    AllocatedBytes,
+    Count
+};
+
+// 进程内累计的计数, 任何线程都可以累加; 每帧的数值由读取方与上一帧的快照相减得到.
+// 用LUNAR_PROFILE_COUNT累加, LUNAR_PROFILING关闭时不产生代码
+class FrameCounters {
+public:
+    static constexpr size_t count = static_cast<size_t>(FrameCounter::Count);
+    using Snapshot = std::array<uint64_t, count>;
+
+    static void add(FrameCounter counter, uint64_t value = 1) {
+        totals[static_cast<size_t>(counter)].fetch_add(value, std::memory_order_relaxed);
+    }
+    static Snapshot snapshot() {
+        Snapshot result;
+        for (size_t i = 0; i < count; i++) result[i] = totals[i].load(std::memory_order_relaxed);
+        return result;
+    }
+    static const char* getName(FrameCounter counter) {
+        static constexpr const char* names[count] = {
+            "draw calls", "triangles", "dispatches", "uploads", "upload bytes", "allocations", "allocated bytes"
+        };
+        return names[static_cast<size_t>(counter)];
+    }
+
+private:
+    inline static std::array<std::atomic<uint64_t>, count> totals{};
+};
+
+}
@@ -0,0 +1,226 @@
+#include "gpu_profiler.hpp"
+#include "chrome_trace.hpp"
+#include "clock.hpp"
+#include <glad/glad.h>
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+
+namespace lunar {
+
+// 每隔这么多帧重新对齐一次GPU与CPU的时钟
+static constexpr uint64_t calibration_interval = 240;
+
+GpuProfiler::GpuProfiler(): queries(frames_in_flight * max_passes * 2), history(history_size) {
+    glGenQueries(static_cast<GLsizei>(queries.size()), queries.data());
+    calibrate();
+}
+
+GpuProfiler::~GpuProfiler() {
+    glDeleteQueries(static_cast<GLsizei>(queries.size()), queries.data());
+}
+
+void GpuProfiler::calibrate() {
+    GLint64 gpu_ns = 0;
+    glGetInteger64v(GL_TIMESTAMP, &gpu_ns);
+    gpu_offset_us = getProfileTimeMicroseconds() - static_cast<double>(gpu_ns) / 1000.0;
+}
+
+unsigned int GpuProfiler::getQuery(unsigned int slot, unsigned int pass, unsigned int end) const {
+    return queries[(slot * max_passes + pass) * 2 + end];
+}
+
+uint16_t GpuProfiler::internName(std::string_view name) {
+    for (size_t i = 0; i < names.size(); i++) {
+        if (names[i] == name) return static_cast<uint16_t>(i);
+    }
+    names.emplace_back(name);
+    pass_history.emplace_back(history_size);
+    return static_cast<uint16_t>(names.size() - 1);
+}
+
+bool GpuProfiler::tryResolve(Slot& slot, unsigned int slot_index) {
+    if (slot.pass_count > 0) {
+        // 同一帧的查询按顺序完成, 最后一个就绪即全部就绪
+        GLint available = 0;
+        glGetQueryObjectiv(getQuery(slot_index, slot.pass_count - 1, 1), GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available) return false;
+    }
+
+    GpuFrameRecord& record = history[history_next];
+    record.index = slot.index;
+    record.cpu_begin_us = slot.cpu_begin_us;
+    record.cpu_end_us = slot.cpu_end_us;
+    record.pass_count = slot.pass_count;
+    double wait_us = 0.0, gpu_us = 0.0;
+    for (uint32_t i = 0; i < slot.pass_count; i++) {
+        GpuPassSample& sample = record.passes[i];
+        sample = slot.passes[i];
+        GLuint64 begin_ns = 0, end_ns = 0;
+        glGetQueryObjectui64v(getQuery(slot_index, i, 0), GL_QUERY_RESULT, &begin_ns);
+        glGetQueryObjectui64v(getQuery(slot_index, i, 1), GL_QUERY_RESULT, &end_ns);
+        sample.gpu_begin_us = static_cast<double>(begin_ns) / 1000.0 + gpu_offset_us;
+        sample.gpu_end_us = static_cast<double>(end_ns) / 1000.0 + gpu_offset_us;
+        const double duration_us = std::max(0.0, sample.gpu_end_us - sample.gpu_begin_us);
+        pass_history[sample.name].add(static_cast<float>(duration_us / 1000.0));
+        if (sample.depth == 0) {
+            gpu_us += duration_us;
+            if (sample.cpu_wait) wait_us += sample.cpu_end_us - sample.cpu_begin_us;
+        }
+    }
+    record.cpu_ms = static_cast<float>(std::max(0.0, slot.cpu_end_us - slot.cpu_begin_us - wait_us) / 1000.0);
+    record.gpu_ms = static_cast<float>(gpu_us / 1000.0);
+    // GPU耗时超过CPU忙碌时间时, CPU必然在某处等待GPU
+    record.bound = record.gpu_ms > record.cpu_ms ? FrameBound::GPU : FrameBound::CPU;
+    cpu_history.add(record.cpu_ms);
+    gpu_history.add(record.gpu_ms);
+
+    history_next = (history_next + 1) % history.size();
+    history_count = std::min(history_count + 1, history.size());
+    slot.pending = false;
+    return true;
+}
+
+void GpuProfiler::beginFrame() {
+    if (in_frame) endFrame();
+    // 从最早的帧开始读回, 遇到尚未完成的就停下
+    for (uint64_t index = frame_index >= frames_in_flight ? frame_index - frames_in_flight : 0; index < frame_index; index++) {
+        const auto slot_index = static_cast<unsigned int>(index % frames_in_flight);
+        Slot& slot = slots[slot_index];
+        if (!slot.pending || slot.index != index) continue;
+        if (!tryResolve(slot, slot_index)) break;
+    }
+    current_slot = static_cast<unsigned int>(frame_index % frames_in_flight);
+    Slot& slot = slots[current_slot];
+    if (slot.pending) {
+        // GPU落后超过frames_in_flight帧, 丢弃这一帧的结果而不是等待
+        slot.pending = false;
+        dropped_frames++;
+    }
+    if (frame_index % calibration_interval == 0) calibrate();
+    slot.index = frame_index;
+    slot.pass_count = 0;
+    slot.cpu_begin_us = getProfileTimeMicroseconds();
+    stack_size = 0;
+    overflow_depth = 0;
+    in_frame = true;
+}
+
+void GpuProfiler::endFrame() {
+    if (!in_frame) return;
+    while (stack_size > 0 || overflow_depth > 0) endPass();
+    Slot& slot = slots[current_slot];
+    slot.cpu_end_us = getProfileTimeMicroseconds();
+    slot.pending = true;
+    in_frame = false;
+    frame_index++;
+}
+
+void GpuProfiler::beginPass(std::string_view name, bool cpu_wait) {
+    if (!in_frame) return;
+    Slot& slot = slots[current_slot];
+    if (overflow_depth > 0 || stack_size == max_depth || slot.pass_count == max_passes) {
+        overflow_depth++;
+        return;
+    }
+    const uint32_t pass = slot.pass_count++;
+    GpuPassSample& sample = slot.passes[pass];
+    sample.name = internName(name);
+    sample.depth = static_cast<uint8_t>(stack_size);
+    sample.cpu_wait = cpu_wait;
+    sample.cpu_begin_us = getProfileTimeMicroseconds();
+    glQueryCounter(getQuery(current_slot, pass, 0), GL_TIMESTAMP);
+    stack[stack_size++] = pass;
+}
+
+void GpuProfiler::endPass() {
+    if (!in_frame) return;
+    if (overflow_depth > 0) {
+        overflow_depth--;
+        return;
+    }
+    if (stack_size == 0) return;
+    const uint32_t pass = stack[--stack_size];
+    glQueryCounter(getQuery(current_slot, pass, 1), GL_TIMESTAMP);
+    slots[current_slot].passes[pass].cpu_end_us = getProfileTimeMicroseconds();
+}
+
+GpuProfiler::Scope::Scope(GpuProfiler* profiler, std::string_view name, bool cpu_wait): profiler(profiler) {
+    if (profiler) profiler->beginPass(name, cpu_wait);
+}
+
+GpuProfiler::Scope::~Scope() {
+    if (profiler) profiler->endPass();
+}
+
+const GpuFrameRecord& GpuProfiler::getFrame(size_t age) const {
+    return history[(history_next + history.size() - 1 - age % history.size()) % history.size()];
+}
+
+std::vector<GpuPassStats> GpuProfiler::getPassStats() const {
+    std::vector<GpuPassStats> stats;
+    for (size_t i = 0; i < names.size(); i++) {
+        const TimingHistory& samples = pass_history[i];
+        stats.push_back({names[i], samples.size(), samples.average(), samples.percentile(50.0f),
+                         samples.percentile(95.0f), samples.percentile(99.0f), samples.max()});
+    }
+    return stats;
+}
+
+float GpuProfiler::getGpuBoundRatio() const {
+    if (history_count == 0) return 0.0f;
+    size_t gpu_bound = 0;
+    for (size_t age = 0; age < history_count; age++) {
+        if (getFrame(age).bound == FrameBound::GPU) gpu_bound++;
+    }
+    return static_cast<float>(gpu_bound) / static_cast<float>(history_count);
+}
+
+std::string GpuProfiler::getReport() const {
+    std::ostringstream report;
+    report.setf(std::ios::fixed);
+    report.precision(3);
+    report << "gpu profiler: " << history_count << " frames, " << dropped_frames << " dropped\n";
+    report << "  frame cpu " << cpu_history.average() << " ms (p95 " << cpu_history.percentile(95.0f) << "), gpu "
+           << gpu_history.average() << " ms (p95 " << gpu_history.percentile(95.0f) << "), "
+           << static_cast<int>(getGpuBoundRatio() * 100.0f + 0.5f) << "% gpu bound\n";
+    report << "  pass                  avg      p50      p95      p99      max  (gpu ms)\n";
+    for (const auto& pass : getPassStats()) {
+        report << "  " << pass.name;
+        for (size_t i = pass.name.size(); i < 18; i++) report << ' ';
+        report << ' ' << pass.average_ms << "    " << pass.p50_ms << "    " << pass.p95_ms
+               << "    " << pass.p99_ms << "    " << pass.max_ms << "\n";
+    }
+    return report.str();
+}
+
+void GpuProfiler::writeChromeTrace(ChromeTraceWriter& writer, uint32_t pid) const {
+    constexpr uint32_t cpu_track = 1, gpu_track = 2;
+    writer.setThreadName(pid, cpu_track, "render thread");
+    writer.setThreadName(pid, gpu_track, "GPU");
+    for (size_t age = history_count; age-- > 0;) {
+        const GpuFrameRecord& frame = getFrame(age);
+        const std::string frame_name = "frame " + std::to_string(frame.index)
+            + (frame.bound == FrameBound::GPU ? " (gpu bound)" : " (cpu bound)");
+        writer.addComplete(frame_name, pid, cpu_track, frame.cpu_begin_us, frame.cpu_end_us - frame.cpu_begin_us);
+        for (uint32_t i = 0; i < frame.pass_count; i++) {
+            const GpuPassSample& pass = frame.passes[i];
+            writer.addComplete(names[pass.name], pid, cpu_track, pass.cpu_begin_us, pass.cpu_end_us - pass.cpu_begin_us);
+            writer.addComplete(names[pass.name], pid, gpu_track, pass.gpu_begin_us, pass.gpu_end_us - pass.gpu_begin_us);
+        }
+        writer.addCounter("cpu ms", pid, frame.cpu_begin_us, frame.cpu_ms);
+        writer.addCounter("gpu ms", pid, frame.cpu_begin_us, frame.gpu_ms);
+    }
+}
+
+bool GpuProfiler::writeChromeTrace(const std::string& path) const {
+    std::ofstream file(path);
+    if (!file) return false;
+    ChromeTraceWriter writer(file);
+    writer.setProcessName(1, "lunar");
+    writeChromeTrace(writer);
+    writer.finish();
+    return static_cast<bool>(file);
+}
+
+}
@@ -0,0 +1,127 @@
+#pragma once
+#include "timing_history.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace lunar {
+
+class ChromeTraceWriter;
+
+enum class FrameBound : uint8_t {
+    Unknown,
+    CPU,
+    GPU
+};
+
+// 时间以getProfileTimeMicroseconds为基准, 单位微秒; GPU时间戳已换算到同一时钟
+struct GpuPassSample {
+    uint16_t name{0};  // GpuProfiler::getPassNames中的下标
+    uint8_t depth{0};
+    bool cpu_wait{false};
+    double cpu_begin_us{0.0}, cpu_end_us{0.0};
+    double gpu_begin_us{0.0}, gpu_end_us{0.0};
+};
+
+struct GpuFrameRecord {
+    static constexpr unsigned int max_passes = 32;
+
+    uint64_t index{0};
+    double cpu_begin_us{0.0}, cpu_end_us{0.0};
+    float cpu_ms{0.0f};  // 扣除等待之后CPU实际忙碌的时间
+    float gpu_ms{0.0f};  // 顶层pass在GPU上的耗时之和
+    FrameBound bound{FrameBound::Unknown};
+    uint32_t pass_count{0};
+    std::array<GpuPassSample, max_passes> passes{};
+};
+
+struct GpuPassStats {
+    std::string name;
+    size_t samples{0};
+    float average_ms{0.0f}, p50_ms{0.0f}, p95_ms{0.0f}, p99_ms{0.0f}, max_ms{0.0f};
+};
+
+// GPU计时: 每个pass的开始与结束各写一个GL_TIMESTAMP查询, 查询对象按帧组成环, 在frames_in_flight帧之后读回.
+// 读回时结果仍未就绪的帧直接丢弃, 从不等待GPU. 每帧按CPU忙碌时间与GPU耗时判断瓶颈在哪一侧.
+class GpuProfiler {
+public:
+    static constexpr unsigned int frames_in_flight = 3;
+    static constexpr unsigned int max_passes = GpuFrameRecord::max_passes;
+    static constexpr unsigned int max_depth = 8;
+    static constexpr size_t history_size = 300;
+
+    GpuProfiler();
+    ~GpuProfiler();
+    GpuProfiler(const GpuProfiler&) = delete;
+    GpuProfiler& operator=(const GpuProfiler&) = delete;
+
+    void beginFrame();
+    void endFrame();
+    // cpu_wait表示该pass的CPU时间主要是在等待(交换缓冲区, glFinish等), 不计入CPU忙碌时间
+    void beginPass(std::string_view name, bool cpu_wait = false);
+    void endPass();
+
+    // profiler为空时什么也不做
+    class Scope {
+    public:
+        Scope(GpuProfiler* profiler, std::string_view name, bool cpu_wait = false);
+        ~Scope();
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+    private:
+        GpuProfiler* profiler;
+    };
+
+    [[nodiscard]] const std::vector<std::string>& getPassNames() const { return names; }
+    [[nodiscard]] std::vector<GpuPassStats> getPassStats() const;
+    // 已读回的帧数(最多history_size), age为0是最近读回的一帧
+    [[nodiscard]] size_t getFrameCount() const { return history_count; }
+    [[nodiscard]] const GpuFrameRecord& getFrame(size_t age) const;
+    [[nodiscard]] size_t getDroppedFrameCount() const { return dropped_frames; }
+    // 历史中GPU瓶颈的帧所占比例
+    [[nodiscard]] float getGpuBoundRatio() const;
+    [[nodiscard]] std::string getReport() const;
+
+    void writeChromeTrace(ChromeTraceWriter& writer, uint32_t pid = 1) const;
+    bool writeChromeTrace(const std::string& path) const;
+
+private:
+    struct Slot {
+        bool pending{false};
+        uint64_t index{0};
+        double cpu_begin_us{0.0}, cpu_end_us{0.0};
+        uint32_t pass_count{0};
+        std::array<GpuPassSample, max_passes> passes{};
+    };
+
+    uint16_t internName(std::string_view name);
+    [[nodiscard]] unsigned int getQuery(unsigned int slot, unsigned int pass, unsigned int end) const;
+    bool tryResolve(Slot& slot, unsigned int slot_index);
+    void calibrate();
+
+    std::vector<unsigned int> queries;
+    std::array<Slot, frames_in_flight> slots{};
+    unsigned int current_slot{0};
+    bool in_frame{false};
+    uint64_t frame_index{0};
+    // 正在进行的pass在slot中的下标, 超出容量的pass记为max_passes
+    std::array<uint32_t, max_depth> stack{};
+    uint32_t stack_size{0};
+    uint32_t overflow_depth{0};
+    // GPU时间戳(纳秒) / 1000 + gpu_offset_us = 统一时钟下的微秒
+    double gpu_offset_us{0.0};
+
+    std::vector<std::string> names;
+    std::vector<TimingHistory> pass_history;
+    TimingHistory cpu_history{history_size};
+    TimingHistory gpu_history{history_size};
+    std::vector<GpuFrameRecord> history;
+    size_t history_next{0};
+    size_t history_count{0};
+    size_t dropped_frames{0};
+};
+
+}
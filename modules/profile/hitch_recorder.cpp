@@ -0,0 +1,124 @@
+#include "hitch_recorder.hpp"
+#include "chrome_trace.hpp"
+#include "clock.hpp"
+#include "cpu_tracer.hpp"
+#include "gpu_profiler.hpp"
+#include <algorithm>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+
+namespace lunar {
+
+HitchRecorder::HitchRecorder(size_t window):
+    frames(std::max<size_t>(window, 1)), frame_history(std::max<size_t>(window, 1)),
+    dump_delay(GpuProfiler::frames_in_flight + 1), frames_since_dump(std::max<size_t>(window, 1)) {
+    last_counters = FrameCounters::snapshot();
+}
+
+void HitchRecorder::setThreshold(float median_ratio, float min_frame_ms) {
+    threshold = std::max(median_ratio, 1.0f);
+    this->min_frame_ms = std::max(min_frame_ms, 0.0f);
+}
+
+void HitchRecorder::beginFrame() {
+    frame_begin_us = getProfileTimeMicroseconds();
+    in_frame = true;
+}
+
+bool HitchRecorder::endFrame() {
+    if (!in_frame) return false;
+    in_frame = false;
+    const double end_us = getProfileTimeMicroseconds();
+
+    HitchFrameRecord& record = frames[frame_next];
+    record.index = frame_index;
+    record.begin_us = frame_begin_us;
+    record.end_us = end_us;
+    record.frame_ms = static_cast<float>((end_us - frame_begin_us) / 1000.0);
+    // 中位数不包括本帧; TimingHistory的排序缓冲在构造时已经分配
+    record.median_ms = frame_history.percentile(50.0f);
+    const FrameCounters::Snapshot counters = FrameCounters::snapshot();
+    for (size_t i = 0; i < FrameCounters::count; i++) record.counters[i] = counters[i] - last_counters[i];
+    last_counters = counters;
+    record.hitch = frame_history.size() >= std::min(warmup_frames, frames.size())
+        && record.frame_ms > record.median_ms * threshold && record.frame_ms >= min_frame_ms;
+
+    frame_history.add(record.frame_ms);
+    frame_next = (frame_next + 1) % frames.size();
+    frame_count = std::min(frame_count + 1, frames.size());
+    frame_index++;
+    frames_since_dump++;
+
+    if (record.hitch) {
+        hitch_count++;
+        if (frames_until_dump == 0 && frames_since_dump >= frames.size()) {
+            frames_until_dump = dump_delay + 1;
+            pending_hitch_index = record.index;
+        }
+    }
+    if (frames_until_dump > 0 && --frames_until_dump == 0) {
+        const std::string path = makeDumpPath(pending_hitch_index);
+        if (dump(path)) {
+            std::cout << "Frame hitch detected, trace written to " << path << std::endl;
+        } else {
+            std::cerr << "Failed to write hitch trace: " << path << std::endl;
+        }
+        frames_since_dump = 0;
+    }
+    return record.hitch;
+}
+
+const HitchFrameRecord& HitchRecorder::getFrame(size_t age) const {
+    return frames[(frame_next + frames.size() - 1 - std::min(age, frames.size() - 1)) % frames.size()];
+}
+
+std::string HitchRecorder::makeDumpPath(uint64_t frame_index) const {
+    const std::time_t now = std::time(nullptr);
+    char stamp[32];
+    std::strftime(stamp, sizeof(stamp), "%Y%m%d-%H%M%S", std::localtime(&now));
+    std::string path = output_directory;
+    if (!path.empty() && path.back() != '/') path += '/';
+    return path + "hitch-" + stamp + "-frame" + std::to_string(frame_index) + ".json";
+}
+
+void HitchRecorder::writeChromeTrace(ChromeTraceWriter& writer, uint32_t pid) {
+    constexpr uint32_t frame_track = 3;
+    writer.setThreadName(pid, frame_track, "frames");
+    double window_begin_us = 0.0, window_end_us = 0.0;
+    for (size_t age = frame_count; age-- > 0;) {
+        const HitchFrameRecord& frame = getFrame(age);
+        if (age == frame_count - 1) window_begin_us = frame.begin_us;
+        window_end_us = frame.end_us;
+        std::string name = "frame " + std::to_string(frame.index);
+        if (frame.hitch) {
+            name = "HITCH " + name;
+            writer.addInstant("hitch", pid, frame_track, frame.begin_us);
+        }
+        writer.addComplete(name, pid, frame_track, frame.begin_us, frame.end_us - frame.begin_us);
+        writer.addCounter("frame ms", pid, frame.begin_us, frame.frame_ms);
+        writer.addCounter("median ms", pid, frame.begin_us, frame.median_ms);
+        for (size_t i = 0; i < FrameCounters::count; i++) {
+            writer.addCounter(FrameCounters::getName(static_cast<FrameCounter>(i)), pid, frame.begin_us,
+                              static_cast<double>(frame.counters[i]));
+        }
+    }
+    if (gpu_profiler) gpu_profiler->writeChromeTrace(writer, pid);
+    if (frame_count > 0) CpuTracer::getInstance().writeChromeTrace(writer, pid, 16, window_begin_us, window_end_us);
+}
+
+bool HitchRecorder::dump(const std::string& path) {
+    std::ofstream file(path);
+    if (!file) return false;
+    {
+        ChromeTraceWriter writer(file);
+        writer.setProcessName(1, "lunar");
+        writeChromeTrace(writer);
+    }
+    if (!file) return false;
+    last_dump_path = path;
+    dump_count++;
+    return true;
+}
+
+}
@@ -0,0 +1,86 @@
+#pragma once
+#include "frame_counters.hpp"
+#include "timing_history.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace lunar {
+
+class ChromeTraceWriter;
+class GpuProfiler;
+
+struct HitchFrameRecord {
+    uint64_t index{0};
+    double begin_us{0.0}, end_us{0.0};  // getProfileTimeMicroseconds
+    float frame_ms{0.0f};
+    float median_ms{0.0f};  // 判定时之前若干帧的中位数
+    bool hitch{false};
+    FrameCounters::Snapshot counters{};  // 本帧内的增量
+};
+
+// 卡顿"黑匣子": 始终保留最近window帧的帧时间与计数, 某一帧超过中位数的threshold倍时,
+// 等GPU计时读回之后把整个窗口连同CPU区间与GPU pass写成带时间戳的trace文件.
+// 每帧的记录写入预先分配的环, 不分配内存; 只有写出文件时才分配.
+class HitchRecorder {
+public:
+    static constexpr size_t default_window = 300;
+    // 积累这么多帧之后才开始判定, 启动时的加载不算卡顿
+    static constexpr size_t warmup_frames = 60;
+
+    explicit HitchRecorder(size_t window = default_window);
+
+    // 超过中位数的median_ratio倍且不短于min_frame_ms时判定为卡顿
+    void setThreshold(float median_ratio, float min_frame_ms = 0.0f);
+    void setOutputDirectory(const std::string& directory) { output_directory = directory; }
+    // 写出时一并写入GPU pass; 为空时只有CPU数据
+    void setGpuProfiler(const GpuProfiler* profiler) { gpu_profiler = profiler; }
+    // 判定之后再等多少帧写出, 默认等到GpuProfiler读回卡顿那一帧
+    void setDumpDelay(unsigned int frames) { dump_delay = frames; }
+
+    void beginFrame();
+    // 返回这一帧是否卡顿; 到了写出的时刻在这里写文件, 写出的耗时不计入任何一帧
+    bool endFrame();
+
+    // 立即把当前窗口写出
+    bool dump(const std::string& path);
+    void writeChromeTrace(ChromeTraceWriter& writer, uint32_t pid = 1);
+
+    [[nodiscard]] size_t getFrameCount() const { return frame_count; }
+    // age为0是最近结束的一帧
+    [[nodiscard]] const HitchFrameRecord& getFrame(size_t age) const;
+    [[nodiscard]] size_t getHitchCount() const { return hitch_count; }
+    [[nodiscard]] size_t getDumpCount() const { return dump_count; }
+    [[nodiscard]] const std::string& getLastDumpPath() const { return last_dump_path; }
+
+private:
+    [[nodiscard]] std::string makeDumpPath(uint64_t frame_index) const;
+
+    std::vector<HitchFrameRecord> frames;
+    size_t frame_next{0};
+    size_t frame_count{0};
+    TimingHistory frame_history;
+
+    float threshold{2.0f};
+    float min_frame_ms{0.0f};
+    unsigned int dump_delay;
+    std::string output_directory{"."};
+    const GpuProfiler* gpu_profiler{nullptr};
+
+    uint64_t frame_index{0};
+    double frame_begin_us{0.0};
+    bool in_frame{false};
+    FrameCounters::Snapshot last_counters{};
+
+    // 还要等多少帧写出, 0为没有待写出的卡顿
+    unsigned int frames_until_dump{0};
+    uint64_t pending_hitch_index{0};
+    // 距上次写出的帧数, 不足一个窗口时只记录不再写出, 避免连续卡顿写出大量重叠的文件
+    size_t frames_since_dump;
+    size_t hitch_count{0};
+    size_t dump_count{0};
+    std::string last_dump_path;
+};
+
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+// CPU作用域计时宏. CMake选项LUNAR_PROFILING关闭时全部展开为空语句, 不产生任何代码.
+//   LUNAR_PROFILE_SCOPE("name");  从这里到作用域结束计为一个区间, name必须是字符串字面量
+//   LUNAR_PROFILE_FUNCTION();     以函数名命名
+//   LUNAR_PROFILE_THREAD("name"); 给当前线程命名
+//   LUNAR_PROFILE_COUNT(DrawCalls, 1); 累加FrameCounter中的计数
+#if LUNAR_PROFILING
+#include "cpu_tracer.hpp"
+#include "frame_counters.hpp"
+
+#define LUNAR_PROFILE_CONCAT_IMPL(a, b) a##b
+#define LUNAR_PROFILE_CONCAT(a, b) LUNAR_PROFILE_CONCAT_IMPL(a, b)
+#define LUNAR_PROFILE_SCOPE(name) ::lunar::CpuProfileScope LUNAR_PROFILE_CONCAT(lunar_profile_scope_, __LINE__)(name)
+#define LUNAR_PROFILE_FUNCTION() LUNAR_PROFILE_SCOPE(__func__)
+#define LUNAR_PROFILE_THREAD(name) ::lunar::CpuTracer::setThreadName(name)
+#define LUNAR_PROFILE_COUNT(counter, value) ::lunar::FrameCounters::add(::lunar::FrameCounter::counter, value)
+#else
+#define LUNAR_PROFILE_SCOPE(name) ((void)0)
+#define LUNAR_PROFILE_FUNCTION() ((void)0)
+#define LUNAR_PROFILE_THREAD(name) ((void)0)
+#define LUNAR_PROFILE_COUNT(counter, value) ((void)0)
+#endif
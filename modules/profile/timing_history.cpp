@@ -0,0 +1,49 @@
+#include "timing_history.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace lunar {
+
+TimingHistory::TimingHistory(size_t capacity): samples(std::max<size_t>(capacity, 1), 0.0f) {
+    sorted.reserve(samples.size());
+}
+
+void TimingHistory::add(float value) {
+    samples[next] = value;
+    next = (next + 1) % samples.size();
+    count = std::min(count + 1, samples.size());
+}
+
+void TimingHistory::clear() {
+    next = 0;
+    count = 0;
+}
+
+float TimingHistory::latest() const {
+    if (count == 0) return 0.0f;
+    return samples[(next + samples.size() - 1) % samples.size()];
+}
+
+float TimingHistory::average() const {
+    if (count == 0) return 0.0f;
+    double total = 0.0;
+    for (size_t i = 0; i < count; i++) total += samples[i];
+    return static_cast<float>(total / static_cast<double>(count));
+}
+
+float TimingHistory::max() const {
+    if (count == 0) return 0.0f;
+    return *std::max_element(samples.begin(), samples.begin() + static_cast<std::ptrdiff_t>(count));
+}
+
+float TimingHistory::percentile(float p) const {
+    if (count == 0) return 0.0f;
+    // 环未满时有效样本就是前count个
+    sorted.assign(samples.begin(), samples.begin() + static_cast<std::ptrdiff_t>(count));
+    const auto rank = static_cast<size_t>(std::ceil(std::clamp(p, 0.0f, 100.0f) / 100.0f * static_cast<float>(count)));
+    const size_t index = std::clamp<size_t>(rank, 1, count) - 1;
+    std::nth_element(sorted.begin(), sorted.begin() + static_cast<std::ptrdiff_t>(index), sorted.end());
+    return sorted[index];
+}
+
+}
@@ -0,0 +1,30 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+
+namespace lunar {
+
+// 固定容量的耗时样本环, 只保留最近capacity个样本. 记录不分配内存, 百分位在查询时计算.
+class TimingHistory {
+public:
+    explicit TimingHistory(size_t capacity = 256);
+
+    void add(float value);
+    void clear();
+
+    [[nodiscard]] size_t size() const { return count; }
+    [[nodiscard]] size_t capacity() const { return samples.size(); }
+    [[nodiscard]] float latest() const;
+    [[nodiscard]] float average() const;
+    [[nodiscard]] float max() const;
+    // 最近邻排名法, p在0到100之间; 没有样本时为0
+    [[nodiscard]] float percentile(float p) const;
+
+private:
+    std::vector<float> samples;
+    size_t next{0};
+    size_t count{0};
+    mutable std::vector<float> sorted;
+};
+
+}
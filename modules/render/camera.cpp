@@ -5,11 +5,12 @@
 #include <glm/gtx/rotate_vector.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
+#include <cmath>
 #include <iostream>
 
 namespace lunar{
     Camera::Camera(glm::vec3 camera_pos, float zoom):focus(zoom),
-    camera_pos(camera_pos), camera_direction(glm::vec3(0.0f, 0.0f, 1.0f)){
+    camera_pos(camera_pos), camera_direction(glm::vec3(0.0f, 0.0f, 1.0f)), previous_pos(camera_pos){
         glm::vec3 up = glm::vec3(0.0f, 1.0f, 0.0f);
         camera_right = glm::normalize(glm::cross(up, camera_direction));
         camera_up = glm::normalize(glm::cross(camera_direction, camera_right));
@@ -18,12 +19,17 @@ namespace lunar{
         return glm::lookAt(camera_pos, camera_pos - camera_direction, camera_up);
     }
 
+    glm::mat4 Camera::computeViewMatrix(float alpha) const {
+        const glm::vec3 position = getPosition(alpha);
+        return glm::lookAt(position, position - camera_direction, camera_up);
+    }
+
     glm::mat4 Camera::computeProjectionMatrix() const{
         if (!Window::initialized){
             throw std::runtime_error("Window not initialized");
         }else {
             Window& w = Window::getInstance();
-            return glm::perspective(glm::radians(static_cast<float>(focus)), static_cast<float>(w.getWidth()) / static_cast<float>(w.getHeight()), 0.1f, 100.0f);
+            return glm::perspective(glm::radians(static_cast<float>(focus)), static_cast<float>(w.getWidth()) / static_cast<float>(w.getHeight()), near_plane, far_plane);
         }
     }
 
@@ -120,15 +126,42 @@ namespace lunar{
     }
 
     void Camera::registerCallback(Interface& interface){
-        interface.registerCallback("camera_move_forward", std::bind(&lunar::Camera::moveForward, this, std::placeholders::_1));
-        interface.registerCallback("camera_move_backward", std::bind(&lunar::Camera::moveBackward, this, std::placeholders::_1));
-        interface.registerCallback("camera_move_left", std::bind(&lunar::Camera::moveLeft, this, std::placeholders::_1));
-        interface.registerCallback("camera_move_right", std::bind(&lunar::Camera::moveRight, this, std::placeholders::_1));
-        interface.registerCallback("camera_rotate", std::bind(&lunar::Camera::rotate, this, std::placeholders::_1));
-        interface.registerCallback("camera_reset_zoom", std::bind(&lunar::Camera::resetZoom, this));
-        interface.registerCallback("camera_move_up", std::bind(&lunar::Camera::moveUp, this, std::placeholders::_1));
-        interface.registerCallback("camera_move_down", std::bind(&lunar::Camera::moveDown, this, std::placeholders::_1));
-        interface.registerCallback("camera_zoom", std::bind(&lunar::Camera::zoom, this, std::placeholders::_1));
+        interface.registerCallback("camera_move_forward", EventCallbackFunction::fromMethod<&Camera::moveForward>(this));
+        interface.registerCallback("camera_move_backward", EventCallbackFunction::fromMethod<&Camera::moveBackward>(this));
+        interface.registerCallback("camera_move_left", EventCallbackFunction::fromMethod<&Camera::moveLeft>(this));
+        interface.registerCallback("camera_move_right", EventCallbackFunction::fromMethod<&Camera::moveRight>(this));
+        interface.registerCallback("camera_rotate", EventCallbackFunction::fromMethod<&Camera::rotate>(this));
+        interface.registerCallback("camera_reset_zoom", [this](const Event&) { resetZoom(); });
+        interface.registerCallback("camera_move_up", EventCallbackFunction::fromMethod<&Camera::moveUp>(this));
+        interface.registerCallback("camera_move_down", EventCallbackFunction::fromMethod<&Camera::moveDown>(this));
+        interface.registerCallback("camera_zoom", EventCallbackFunction::fromMethod<&Camera::zoom>(this));
+    }
+
+    void Camera::update(const Interface& interface, float delta_time){
+        previous_pos = camera_pos;
+        // camera_direction指向后方, moveLeft沿camera_right移动, 与按键回调的方向一致
+        glm::vec3 input(interface.getAxis("camera_right"), interface.getAxis("camera_up"), interface.getAxis("camera_forward"));
+        const float length_squared = glm::dot(input, input);
+        if (length_squared == 0.0f) return;
+        // 斜向移动不更快
+        if (length_squared > 1.0f) input /= std::sqrt(length_squared);
+        const glm::vec3 velocity = move_velocity * move_speed * (-input.x * camera_right + input.y * camera_up - input.z * camera_direction);
+        camera_pos += velocity * delta_time;
+    }
+
+    void Camera::lookAt(const glm::vec3& position, const glm::vec3& target){
+        camera_pos = position;
+        // 直接放置时不从旧位置插值过来
+        previous_pos = position;
+        // camera_direction指向摄像机后方, 与computeViewMatrix一致
+        const glm::vec3 direction = position - target;
+        if (glm::dot(direction, direction) < 1e-12f) return;
+        camera_direction = glm::normalize(direction);
+        glm::vec3 up = glm::vec3(0.0f, 1.0f, 0.0f);
+        // 正对上下方时换一个参考方向
+        if (std::abs(glm::dot(up, camera_direction)) > 0.999f) up = glm::vec3(0.0f, 0.0f, 1.0f);
+        camera_right = glm::normalize(glm::cross(up, camera_direction));
+        camera_up = glm::normalize(glm::cross(camera_direction, camera_right));
     }
 
     void Camera::rotate(const Event& event){
@@ -13,6 +13,8 @@ class Camera{
     explicit Camera(glm::vec3 camera_pos, float zoom = 45.0f);
     static Camera& getInstance(){ static Camera instance; return instance; }
     [[nodiscard]] glm::mat4 computeViewMatrix() const;
+    // 位置在上一次与这一次update之间按alpha插值, 朝向由鼠标事件直接修改, 不插值
+    [[nodiscard]] glm::mat4 computeViewMatrix(float alpha) const;
     [[nodiscard]] glm::mat4 computeProjectionMatrix() const;
     [[nodiscard]] glm::vec3 computeTransformMatrix() const;
     void resetZoom() {focus = 45.0f;}
@@ -25,13 +27,24 @@ class Camera{
     void moveUp(const Event& event);
     void moveDown(const Event& event);
     void registerCallback(Interface& interface);
+    // 每次固定步长的更新调用: 按camera_forward, camera_right, camera_up三个轴与步长移动, 单位为秒
+    void update(const Interface& interface, float delta_time);
+    // 直接放到position并朝向target, 用于脚本控制的摄像机(基准测试的路径等)
+    void lookAt(const glm::vec3& position, const glm::vec3& target);
     [[nodiscard]] glm::vec3 getPosition() const {return camera_pos;}
+    [[nodiscard]] glm::vec3 getPosition(float alpha) const {return previous_pos + (camera_pos - previous_pos) * alpha;}
+    [[nodiscard]] float getNearPlane() const {return near_plane;}
+    [[nodiscard]] float getFarPlane() const {return far_plane;}
 
     inline static float zoom_speed = 2.0f;
     inline static float rotate_speed = 0.001f;
     inline static float move_speed = 1.0f;
+    // 按住移动键时每秒移动的距离
+    inline static float move_velocity = 3.0f;
     private:
     double focus;
+    float near_plane{0.1f}, far_plane{100.0f};
     glm::vec3 camera_pos, camera_direction, camera_up, camera_right;
+    glm::vec3 previous_pos;  // 上一次update之前的位置
 };
 }
\ No newline at end of file
@@ -0,0 +1,51 @@
+#include "camera_path.hpp"
+#include "camera.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+
+namespace lunar {
+
+CameraPath::CameraPath(std::vector<CameraKeyframe> keyframes, bool loop):
+    keyframes(std::move(keyframes)), loop(loop) {}
+
+const CameraKeyframe& CameraPath::getKeyframe(long index) const {
+    const long count = static_cast<long>(keyframes.size());
+    if (loop) return keyframes[static_cast<size_t>(((index % count) + count) % count)];
+    // 不闭合时两端重复端点, 端点处的切线沿着首尾两段
+    return keyframes[static_cast<size_t>(std::clamp(index, 0L, count - 1))];
+}
+
+static glm::vec3 catmullRom(const glm::vec3& p0, const glm::vec3& p1, const glm::vec3& p2, const glm::vec3& p3, float s) {
+    const float s2 = s * s, s3 = s2 * s;
+    return 0.5f * ((2.0f * p1) + (p2 - p0) * s + (2.0f * p0 - 5.0f * p1 + 4.0f * p2 - p3) * s2
+        + (3.0f * p1 - p0 - 3.0f * p2 + p3) * s3);
+}
+
+CameraKeyframe CameraPath::evaluate(float t) const {
+    if (keyframes.empty()) {
+        throw std::runtime_error("Camera path has no keyframes");
+    }
+    if (keyframes.size() == 1) return keyframes.front();
+    const long segments = static_cast<long>(loop ? keyframes.size() : keyframes.size() - 1);
+    const float position = std::clamp(t, 0.0f, 1.0f) * static_cast<float>(segments);
+    const long segment = std::min(static_cast<long>(std::floor(position)), segments - 1);
+    const float s = position - static_cast<float>(segment);
+
+    const CameraKeyframe& k0 = getKeyframe(segment - 1);
+    const CameraKeyframe& k1 = getKeyframe(segment);
+    const CameraKeyframe& k2 = getKeyframe(segment + 1);
+    const CameraKeyframe& k3 = getKeyframe(segment + 2);
+    return {
+        catmullRom(k0.position, k1.position, k2.position, k3.position, s),
+        catmullRom(k0.target, k1.target, k2.target, k3.target, s)
+    };
+}
+
+void CameraPath::apply(Camera& camera, float t) const {
+    const CameraKeyframe keyframe = evaluate(t);
+    camera.lookAt(keyframe.position, keyframe.target);
+}
+
+}
@@ -0,0 +1,40 @@
+#pragma once
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <vector>
+
+namespace lunar {
+
+class Camera;
+
+struct CameraKeyframe {
+    glm::vec3 position;
+    glm::vec3 target;  // 摄像机看向的点
+};
+
+// 经过每个关键帧的Catmull-Rom样条, 位置与注视点分别插值. 参数t在0到1之间, 每段占相同的长度,
+// 同样的t总是得到同样的摄像机, 基准测试不再依赖鼠标怎么移动
+class CameraPath {
+public:
+    CameraPath() = default;
+    explicit CameraPath(std::vector<CameraKeyframe> keyframes, bool loop = false);
+
+    void addKeyframe(const CameraKeyframe& keyframe) { keyframes.push_back(keyframe); }
+    // 闭合时最后一个关键帧连回第一个
+    void setLoop(bool loop) { this->loop = loop; }
+
+    [[nodiscard]] CameraKeyframe evaluate(float t) const;
+    void apply(Camera& camera, float t) const;
+
+    [[nodiscard]] size_t size() const { return keyframes.size(); }
+    [[nodiscard]] bool empty() const { return keyframes.empty(); }
+    [[nodiscard]] bool isLoop() const { return loop; }
+
+private:
+    [[nodiscard]] const CameraKeyframe& getKeyframe(long index) const;
+
+    std::vector<CameraKeyframe> keyframes;
+    bool loop{false};
+};
+
+}
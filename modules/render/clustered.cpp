@@ -0,0 +1,160 @@
+#include "clustered.hpp"
+#include "profile/profile_scope.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+namespace lunar {
+
+static const std::string cluster_lights_lib =
+#include "glsllibs/cluster-lights.glsl"
+;
+static const std::string clustered_lighting_lib =
+#include "glsllibs/clustered-lighting.glsl"
+;
+static const std::string cluster_bounds_shader =
+#include "glsllibs/cluster-bounds-cs.glsl"
+;
+static const std::string cluster_cull_shader = ShaderProgram::loadGLSLlib(
+    #include "glsllibs/cluster-cull-cs.glsl"
+    ,
+    cluster_lights_lib
+);
+
+// 与着色器中uvec3 uniform对应
+static void setUVec3(const ShaderProgram& shader, const std::string& name, unsigned int x, unsigned int y, unsigned int z) {
+    glUniform3ui(glGetUniformLocation(shader.getID(), name.c_str()), x, y, z);
+}
+
+static float maxComponent(const glm::vec3& v) {
+    return std::max(v.x, std::max(v.y, v.z));
+}
+
+ClusteredLighting::ClusteredLighting(unsigned int max_lights, unsigned int grid_x, unsigned int grid_y, unsigned int grid_z,
+                                     unsigned int average_lights_per_cluster):
+    bounds_shader("", "", cluster_bounds_shader), cull_shader("", "", cluster_cull_shader),
+    max_lights(max_lights), grid_x(grid_x), grid_y(grid_y), grid_z(grid_z),
+    index_capacity(grid_x * grid_y * grid_z * average_lights_per_cluster) {
+    const unsigned int cluster_count = getClusterCount();
+
+    glGenBuffers(1, &light_buffer);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, light_buffer);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, max_lights * sizeof(GpuLight), nullptr, GL_DYNAMIC_DRAW);
+
+    glGenBuffers(1, &bounds_buffer);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, bounds_buffer);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, cluster_count * sizeof(glm::vec4) * 2, nullptr, GL_DYNAMIC_COPY);
+
+    glGenBuffers(1, &grid_buffer);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, grid_buffer);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, cluster_count * sizeof(unsigned int) * 2, nullptr, GL_DYNAMIC_COPY);
+
+    // 第一个uint是全局计数器, 后面是所有簇共享的光源索引表
+    glGenBuffers(1, &index_buffer);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, index_buffer);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, (index_capacity + 1) * sizeof(unsigned int), nullptr, GL_DYNAMIC_COPY);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+    gpu_lights.reserve(max_lights);
+}
+
+ClusteredLighting::~ClusteredLighting() {
+    unsigned int buffers[] = {light_buffer, bounds_buffer, grid_buffer, index_buffer};
+    glDeleteBuffers(4, buffers);
+}
+
+std::string ClusteredLighting::getShaderLibrary() {
+    return cluster_lights_lib + clustered_lighting_lib;
+}
+
+void ClusteredLighting::setLights(const std::vector<PointLight>& point_lights, const std::vector<SpotLight>& spot_lights) {
+    LUNAR_PROFILE_SCOPE("upload cluster lights");
+    if (point_lights.size() + spot_lights.size() > max_lights) {
+        throw std::runtime_error("Too many lights for clustered lighting");
+    }
+    gpu_lights.clear();
+    for (const auto& light : point_lights) {
+        float intensity = maxComponent(light.color * glm::max(light.diffuse, light.specular));
+        gpu_lights.push_back({
+            .position_radius = glm::vec4(light.position, General::getLightRadius(light.constant, light.linear, light.quadratic, intensity)),
+            .direction_type = glm::vec4(0.0f),
+            .color = glm::vec4(light.color, 0.0f),
+            .ambient = glm::vec4(light.ambient, 0.0f),
+            .diffuse = glm::vec4(light.diffuse, 0.0f),
+            .specular = glm::vec4(light.specular, 0.0f),
+            .attenuation = glm::vec4(light.constant, light.linear, light.quadratic, 0.0f),
+            .cone = glm::vec4(0.0f)
+        });
+    }
+    for (const auto& light : spot_lights) {
+        float intensity = maxComponent(light.color * glm::max(light.diffuse, light.specular));
+        gpu_lights.push_back({
+            .position_radius = glm::vec4(light.position, General::getLightRadius(light.constant, light.linear, light.quadratic, intensity)),
+            .direction_type = glm::vec4(glm::normalize(light.direction), 1.0f),
+            .color = glm::vec4(light.color, 0.0f),
+            .ambient = glm::vec4(light.ambient, 0.0f),
+            .diffuse = glm::vec4(light.diffuse, 0.0f),
+            .specular = glm::vec4(light.specular, 0.0f),
+            .attenuation = glm::vec4(light.constant, light.linear, light.quadratic, 0.0f),
+            .cone = glm::vec4(light.cutoff, light.outer_cutoff, 0.0f, 0.0f)
+        });
+    }
+    light_count = static_cast<unsigned int>(gpu_lights.size());
+    if (light_count == 0) return;
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, light_buffer);
+    glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, gpu_lights.size() * sizeof(GpuLight), gpu_lights.data());
+    LUNAR_PROFILE_COUNT(Uploads, 1);
+    LUNAR_PROFILE_COUNT(UploadBytes, gpu_lights.size() * sizeof(GpuLight));
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+}
+
+void ClusteredLighting::update(const glm::mat4& view, const glm::mat4& projection, float z_near, float z_far,
+                               int viewport_width, int viewport_height) {
+    this->viewport_width = viewport_width;
+    this->viewport_height = viewport_height;
+    const unsigned int cluster_count = getClusterCount();
+
+    // 簇的包围盒只与投影有关, 相机移动不需要重建
+    if (projection != cached_projection || z_near != this->z_near || z_far != this->z_far) {
+        bounds_shader.use();
+        bounds_shader.setMat4("inverseProjection", glm::inverse(projection));
+        setUVec3(bounds_shader, "gridSize", grid_x, grid_y, grid_z);
+        bounds_shader.setFloat("zNear", z_near);
+        bounds_shader.setFloat("zFar", z_far);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 7, bounds_buffer);
+        bounds_shader.dispatch((cluster_count + 63) / 64);
+        glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+        cached_projection = projection;
+        this->z_near = z_near;
+        this->z_far = z_far;
+    }
+
+    // 只清零全局计数器
+    const unsigned int zero = 0;
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, index_buffer);
+    glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, sizeof(unsigned int), &zero);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+    cull_shader.use();
+    cull_shader.setMat4("view", view);
+    cull_shader.setUInt("clusterCount", cluster_count);
+    cull_shader.setUInt("lightCount", light_count);
+    cull_shader.setUInt("indexCapacity", index_capacity);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 6, light_buffer);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 7, bounds_buffer);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 8, grid_buffer);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 9, index_buffer);
+    cull_shader.dispatch((cluster_count + 127) / 128);
+    glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+}
+
+void ClusteredLighting::bind(const ShaderProgram& shader) const {
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 6, light_buffer);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 8, grid_buffer);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 9, index_buffer);
+    setUVec3(shader, "clusterGridSize", grid_x, grid_y, grid_z);
+    shader.setVec2("clusterScreenSize", glm::vec2(static_cast<float>(viewport_width), static_cast<float>(viewport_height)));
+    shader.setFloat("clusterNear", z_near);
+    shader.setFloat("clusterFar", z_far);
+}
+
+}
@@ -0,0 +1,62 @@
+#pragma once
+#include "shader.hpp"
+#include "model/material.hpp"
+#include <glm/glm.hpp>
+#include <vector>
+
+namespace lunar {
+
+// 分簇前向光照: 把视锥划分为grid_x * grid_y * grid_z个簇(froxel),
+// 每帧由计算着色器把光源分配到簇中, 片段着色器只遍历所在簇的光源.
+// 片段着色器需要依次加载glsllibs/cluster-lights.glsl和glsllibs/clustered-lighting.glsl.
+class ClusteredLighting {
+public:
+    explicit ClusteredLighting(unsigned int max_lights = 4096,
+                               unsigned int grid_x = 16, unsigned int grid_y = 9, unsigned int grid_z = 24,
+                               unsigned int average_lights_per_cluster = 64);
+    ~ClusteredLighting();
+    ClusteredLighting(const ClusteredLighting&) = delete;
+    ClusteredLighting& operator=(const ClusteredLighting&) = delete;
+
+    // 光源的影响半径由衰减系数推导
+    void setLights(const std::vector<PointLight>& point_lights, const std::vector<SpotLight>& spot_lights);
+    // 投影矩阵变化时重建簇的包围盒, 然后重新分配光源
+    void update(const glm::mat4& view, const glm::mat4& projection, float z_near, float z_far, int viewport_width, int viewport_height);
+    // 绑定片段着色器需要的缓冲区与uniform, shader需要处于使用状态
+    void bind(const ShaderProgram& shader) const;
+
+    [[nodiscard]] unsigned int getLightCount() const { return light_count; }
+    [[nodiscard]] unsigned int getClusterCount() const { return grid_x * grid_y * grid_z; }
+
+    // 片段着色器需要拼接的GLSL库
+    static std::string getShaderLibrary();
+
+private:
+    // 与cluster-lights.glsl中的std430布局一致
+    struct GpuLight {
+        glm::vec4 position_radius;
+        glm::vec4 direction_type;
+        glm::vec4 color;
+        glm::vec4 ambient;
+        glm::vec4 diffuse;
+        glm::vec4 specular;
+        glm::vec4 attenuation;
+        glm::vec4 cone;
+    };
+
+    ShaderProgram bounds_shader;
+    ShaderProgram cull_shader;
+    unsigned int max_lights;
+    unsigned int grid_x, grid_y, grid_z;
+    unsigned int index_capacity;
+    unsigned int light_count{0};
+
+    glm::mat4 cached_projection{0.0f};
+    float z_near{0.0f}, z_far{0.0f};
+    int viewport_width{0}, viewport_height{0};
+
+    std::vector<GpuLight> gpu_lights;
+    unsigned int light_buffer, bounds_buffer, grid_buffer, index_buffer;
+};
+
+}
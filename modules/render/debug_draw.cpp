@@ -0,0 +1,275 @@
+#include "debug_draw.hpp"
+#include <glm/gtc/matrix_transform.hpp>
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <stdexcept>
+
+namespace lunar {
+
+static const std::string debug_draw_vertex_shader =
+#include "glsllibs/debug-draw-vs.glsl"
+;
+static const std::string debug_draw_fragment_shader =
+#include "glsllibs/debug-draw-fs.glsl"
+;
+
+static_assert(sizeof(DebugDraw::Vertex) == 16, "unexpected debug vertex layout");
+
+// 线段字体: 字形画在3x3的点阵上, 点按小键盘编号
+//   7 8 9
+//   4 5 6
+//   1 2 3
+// 每两个数字是一条线段, "*n"在点n画一个小点
+static const char* getGlyph(char c) {
+    switch (static_cast<char>(std::toupper(static_cast<unsigned char>(c)))) {
+        case '0': return "79 93 31 17 37";
+        case '1': return "82 78";
+        case '2': return "79 96 64 41 13";
+        case '3': return "79 93 31 56";
+        case '4': return "74 46 93";
+        case '5': return "97 74 46 63 31";
+        case '6': return "97 71 13 36 64";
+        case '7': return "79 93";
+        case '8': return "79 93 31 17 46";
+        case '9': return "64 47 79 93 31";
+        case 'A': return "17 79 93 46";
+        case 'B': return "71 78 85 46 63 31";
+        case 'C': return "97 71 13";
+        case 'D': return "71 78 86 62 21";
+        case 'E': return "97 71 13 45";
+        case 'F': return "97 71 45";
+        case 'G': return "97 71 13 36 65";
+        case 'H': return "71 93 46";
+        case 'I': return "79 82 13";
+        case 'J': return "93 31 14";
+        case 'K': return "71 49 43";
+        case 'L': return "71 13";
+        case 'M': return "17 75 59 93";
+        case 'N': return "17 73 39";
+        case 'O': return "79 93 31 17";
+        case 'P': return "17 79 96 64";
+        case 'Q': return "79 93 31 17 53";
+        case 'R': return "17 79 96 64 43";
+        case 'S': return "97 74 46 63 31";
+        case 'T': return "79 82";
+        case 'U': return "71 13 39";
+        case 'V': return "72 29";
+        case 'W': return "71 15 53 39";
+        case 'X': return "73 91";
+        case 'Y': return "75 95 52";
+        case 'Z': return "79 91 13";
+        case '-': return "46";
+        case '+': return "46 82";
+        case '=': return "46 13";
+        case '_': return "13";
+        case '/': return "19";
+        case '(': return "84 42";
+        case ')': return "86 62";
+        case '.': return "*2";
+        case ',': return "*2";
+        case ':': return "*2 *5";
+        case '%': return "19 *7 *3";
+        default:  return "";
+    }
+}
+
+uint32_t DebugDraw::packColor(const glm::vec3& color) {
+    const auto channel = [](float value) {
+        return static_cast<uint32_t>(std::lround(std::clamp(value, 0.0f, 1.0f) * 255.0f));
+    };
+    // 按字节顺序RGBA, 与GL_UNSIGNED_BYTE的顶点属性一致(小端)
+    return channel(color.x) | (channel(color.y) << 8) | (channel(color.z) << 16) | (255u << 24);
+}
+
+void DebugDraw::init(unsigned int capacity) {
+    if (!compiled) return;
+    release();
+    // 两个端点成对写入, 容量取偶数
+    this->capacity = std::max(capacity & ~1u, 2u);
+    shader = std::make_unique<ShaderProgram>(debug_draw_vertex_shader, debug_draw_fragment_shader);
+
+    const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+    const GLsizeiptr size = static_cast<GLsizeiptr>(ring_size) * this->capacity * sizeof(Vertex);
+    glGenVertexArrays(1, &VAO);
+    glGenBuffers(1, &buffer);
+    glBindVertexArray(VAO);
+    glBindBuffer(GL_ARRAY_BUFFER, buffer);
+    glBufferStorage(GL_ARRAY_BUFFER, size, nullptr, flags);
+    mapped = static_cast<Vertex*>(glMapBufferRange(GL_ARRAY_BUFFER, 0, size, flags));
+    if (!mapped) {
+        throw std::runtime_error("Failed to map debug draw buffer");
+    }
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, position));
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(Vertex), (void*)offsetof(Vertex, color));
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    enabled = true;
+}
+
+void DebugDraw::release() {
+    for (auto& fence : fences) {
+        if (fence) glDeleteSync(fence);
+        fence = nullptr;
+    }
+    if (buffer) {
+        glBindBuffer(GL_ARRAY_BUFFER, buffer);
+        glUnmapBuffer(GL_ARRAY_BUFFER);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        glDeleteBuffers(1, &buffer);
+        glDeleteVertexArrays(1, &VAO);
+    }
+    shader.reset();
+    buffer = VAO = 0;
+    mapped = nullptr;
+    enabled = false;
+    segment_acquired = false;
+    depth_count = overlay_count = 0;
+}
+
+void DebugDraw::setCamera(const glm::mat4& view) {
+    // 视图矩阵旋转部分的前两行就是摄像机在世界空间中的右方与上方
+    camera_right = glm::vec3(view[0][0], view[1][0], view[2][0]);
+    camera_up = glm::vec3(view[0][1], view[1][1], view[2][1]);
+}
+
+DebugDraw::Vertex* DebugDraw::acquireSegment() {
+    if (!segment_acquired) {
+        // 三帧之前的绘制通常早已完成, 这里几乎不会真的等待
+        if (fences[slot]) {
+            while (glClientWaitSync(fences[slot], GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000) == GL_TIMEOUT_EXPIRED) {}
+            glDeleteSync(fences[slot]);
+            fences[slot] = nullptr;
+        }
+        segment_acquired = true;
+    }
+    return mapped + static_cast<size_t>(slot) * capacity;
+}
+
+void DebugDraw::addLine(const glm::vec3& from, const glm::vec3& to, uint32_t color, bool overlay) {
+    if (depth_count + overlay_count + 2 > capacity) {
+        dropped_vertices += 2;
+        return;
+    }
+    Vertex* segment = acquireSegment();
+    Vertex* target;
+    if (overlay) {
+        overlay_count += 2;
+        target = segment + (capacity - overlay_count);
+    } else {
+        target = segment + depth_count;
+        depth_count += 2;
+    }
+    target[0] = {from, color};
+    target[1] = {to, color};
+}
+
+void DebugDraw::addBox(const glm::vec3& min, const glm::vec3& max, uint32_t color, bool overlay) {
+    const glm::vec3 corners[8] = {
+        {min.x, min.y, min.z}, {max.x, min.y, min.z}, {max.x, max.y, min.z}, {min.x, max.y, min.z},
+        {min.x, min.y, max.z}, {max.x, min.y, max.z}, {max.x, max.y, max.z}, {min.x, max.y, max.z}
+    };
+    for (int i = 0; i < 4; i++) {
+        addLine(corners[i], corners[(i + 1) % 4], color, overlay);
+        addLine(corners[i + 4], corners[(i + 1) % 4 + 4], color, overlay);
+        addLine(corners[i], corners[i + 4], color, overlay);
+    }
+}
+
+void DebugDraw::addSphere(const glm::vec3& center, float radius, uint32_t color, bool overlay, unsigned int segments) {
+    segments = std::max(segments, 4u);
+    // 三个坐标平面上的大圆
+    glm::vec3 previous[3];
+    for (unsigned int i = 0; i <= segments; i++) {
+        const float angle = 2.0f * 3.14159265f * static_cast<float>(i) / static_cast<float>(segments);
+        const float c = std::cos(angle) * radius, s = std::sin(angle) * radius;
+        const glm::vec3 points[3] = {center + glm::vec3(c, s, 0.0f), center + glm::vec3(c, 0.0f, s), center + glm::vec3(0.0f, c, s)};
+        for (int axis = 0; axis < 3; axis++) {
+            if (i > 0) addLine(previous[axis], points[axis], color, overlay);
+            previous[axis] = points[axis];
+        }
+    }
+}
+
+void DebugDraw::addFrustum(const glm::mat4& view_projection, uint32_t color, bool overlay) {
+    const glm::mat4 inverse = glm::inverse(view_projection);
+    glm::vec3 corners[8];
+    for (int i = 0; i < 8; i++) {
+        // 与addBox相同的角点顺序, 近平面在前
+        const glm::vec4 ndc((i == 1 || i == 2 || i == 5 || i == 6) ? 1.0f : -1.0f,
+                            (i == 2 || i == 3 || i == 6 || i == 7) ? 1.0f : -1.0f,
+                            i < 4 ? -1.0f : 1.0f, 1.0f);
+        const glm::vec4 world = inverse * ndc;
+        corners[i] = glm::vec3(world) / world.w;
+    }
+    for (int i = 0; i < 4; i++) {
+        addLine(corners[i], corners[(i + 1) % 4], color, overlay);
+        addLine(corners[i + 4], corners[(i + 1) % 4 + 4], color, overlay);
+        addLine(corners[i], corners[i + 4], color, overlay);
+    }
+}
+
+void DebugDraw::addText(const glm::vec3& position, std::string_view text, uint32_t color, float size, bool overlay) {
+    const float width = size * 0.5f;
+    const glm::vec3 right = camera_right * (width * 0.5f);  // 点阵一格
+    const glm::vec3 up = camera_up * (size * 0.5f);
+    const float dot = 0.1f;
+    glm::vec3 origin = position;
+    for (char c : text) {
+        const auto point = [&](char key) {
+            const int index = key - '1';
+            return origin + right * static_cast<float>(index % 3) + up * static_cast<float>(index / 3);
+        };
+        const char* glyph = getGlyph(c);
+        for (const char* p = glyph; p[0] && p[1];) {
+            if (p[0] == '*') {
+                const glm::vec3 center = point(p[1]);
+                addLine(center - right * dot - up * dot, center + right * dot + up * dot, color, overlay);
+                addLine(center - right * dot + up * dot, center + right * dot - up * dot, color, overlay);
+            } else {
+                addLine(point(p[0]), point(p[1]), color, overlay);
+            }
+            p += 2;
+            while (*p == ' ') p++;
+        }
+        origin += camera_right * (width * 1.5f);
+    }
+}
+
+void DebugDraw::render(const glm::mat4& view_projection) {
+    if (!isEnabled()) return;
+    if (depth_count + overlay_count > 0) {
+        const GLboolean depth_test = glIsEnabled(GL_DEPTH_TEST);
+        GLboolean depth_write;
+        glGetBooleanv(GL_DEPTH_WRITEMASK, &depth_write);
+
+        shader->use();
+        shader->setMat4("viewProjection", view_projection);
+        glBindVertexArray(VAO);
+        const GLint first = static_cast<GLint>(slot * capacity);
+        // 线段不写深度, 彼此之间不遮挡
+        glDepthMask(GL_FALSE);
+        if (depth_count > 0) {
+            glEnable(GL_DEPTH_TEST);
+            glDrawArrays(GL_LINES, first, static_cast<GLsizei>(depth_count));
+        }
+        if (overlay_count > 0) {
+            glDisable(GL_DEPTH_TEST);
+            glDrawArrays(GL_LINES, first + static_cast<GLint>(capacity - overlay_count), static_cast<GLsizei>(overlay_count));
+        }
+        glBindVertexArray(0);
+        glDepthMask(depth_write);
+        if (depth_test) glEnable(GL_DEPTH_TEST);
+        else glDisable(GL_DEPTH_TEST);
+    }
+    if (segment_acquired) {
+        fences[slot] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        slot = (slot + 1) % ring_size;
+        segment_acquired = false;
+    }
+    depth_count = overlay_count = 0;
+}
+
+}
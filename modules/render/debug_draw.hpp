@@ -0,0 +1,102 @@
+#pragma once
+#include "shader.hpp"
+#include "model/bounds.hpp"
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+
+namespace lunar {
+
+// 即时模式的调试线框: 任何地方都可以追加线段, 顶点直接写进持久映射的缓冲区, 每帧最多两次绘制
+// (深度测试与覆盖在最上层各一次). CMake选项LUNAR_DEBUG_DRAW关闭或运行时未启用时, 所有调用都在内联的判断处返回.
+class DebugDraw {
+public:
+#if LUNAR_DEBUG_DRAW
+    static constexpr bool compiled = true;
+#else
+    static constexpr bool compiled = false;
+#endif
+    // 缓冲区分为ring_size段, 每帧写一段, 写之前等待这一段上次的绘制完成
+    static constexpr unsigned int ring_size = 3;
+    static constexpr unsigned int default_capacity = 1 << 16;
+
+    struct Vertex {
+        glm::vec3 position;
+        uint32_t color;  // RGBA8
+    };
+
+    static DebugDraw& getInstance() {
+        static DebugDraw instance;
+        return instance;
+    }
+    DebugDraw(const DebugDraw&) = delete;
+    DebugDraw& operator=(const DebugDraw&) = delete;
+
+    // 需要GL上下文; capacity为每帧的顶点数, 超出的线段被丢弃. 初始化之后即启用
+    void init(unsigned int capacity = default_capacity);
+    // 在GL上下文销毁之前调用
+    void release();
+    void setEnabled(bool enabled) { this->enabled = enabled && buffer != 0; }
+    [[nodiscard]] bool isInitialized() const { return buffer != 0; }
+    [[nodiscard]] bool isEnabled() const { return compiled && enabled; }
+    // text3d按这个视图矩阵朝向摄像机
+    void setCamera(const glm::mat4& view);
+
+    void line(const glm::vec3& from, const glm::vec3& to, const glm::vec3& color = glm::vec3(1.0f), bool overlay = false) {
+        if (isEnabled()) addLine(from, to, packColor(color), overlay);
+    }
+    void aabb(const AABB& box, const glm::vec3& color = glm::vec3(0.0f, 1.0f, 0.0f), bool overlay = false) {
+        if (isEnabled() && box.isValid()) addBox(box.min, box.max, packColor(color), overlay);
+    }
+    void sphere(const glm::vec3& center, float radius, const glm::vec3& color = glm::vec3(1.0f, 1.0f, 0.0f),
+                bool overlay = false, unsigned int segments = 24) {
+        if (isEnabled()) addSphere(center, radius, packColor(color), overlay, segments);
+    }
+    // 视图投影矩阵所对应的视锥体
+    void frustum(const glm::mat4& view_projection, const glm::vec3& color = glm::vec3(1.0f, 0.5f, 0.0f), bool overlay = false) {
+        if (isEnabled()) addFrustum(view_projection, packColor(color), overlay);
+    }
+    // 线段字体, 支持数字, 字母(不区分大小写)与少量符号; size为字高, 从position向右书写
+    void text3d(const glm::vec3& position, std::string_view text, const glm::vec3& color = glm::vec3(1.0f),
+                float size = 0.2f, bool overlay = true) {
+        if (isEnabled()) addText(position, text, packColor(color), size, overlay);
+    }
+
+    // 画出本帧追加的所有线段并切换到下一段缓冲
+    void render(const glm::mat4& view_projection);
+
+    [[nodiscard]] unsigned int getVertexCount() const { return depth_count + overlay_count; }
+    [[nodiscard]] uint64_t getDroppedVertexCount() const { return dropped_vertices; }
+    [[nodiscard]] unsigned int getCapacity() const { return capacity; }
+
+    static uint32_t packColor(const glm::vec3& color);
+
+private:
+    DebugDraw() = default;
+    ~DebugDraw() = default;
+
+    void addLine(const glm::vec3& from, const glm::vec3& to, uint32_t color, bool overlay);
+    void addBox(const glm::vec3& min, const glm::vec3& max, uint32_t color, bool overlay);
+    void addSphere(const glm::vec3& center, float radius, uint32_t color, bool overlay, unsigned int segments);
+    void addFrustum(const glm::mat4& view_projection, uint32_t color, bool overlay);
+    void addText(const glm::vec3& position, std::string_view text, uint32_t color, float size, bool overlay);
+    // 当前段可写时返回其起点, 第一次写入前等待这一段的栅栏
+    Vertex* acquireSegment();
+
+    bool enabled{false};
+    std::unique_ptr<ShaderProgram> shader;
+    unsigned int VAO{0}, buffer{0};
+    Vertex* mapped{nullptr};
+    unsigned int capacity{0};
+    GLsync fences[ring_size]{};
+    unsigned int slot{0};
+    bool segment_acquired{false};
+    // 深度测试的线段从段首向后写, 覆盖的线段从段尾向前写, 各自连续
+    unsigned int depth_count{0}, overlay_count{0};
+    uint64_t dropped_vertices{0};
+    glm::vec3 camera_right{1.0f, 0.0f, 0.0f}, camera_up{0.0f, 1.0f, 0.0f};
+};
+
+}
@@ -0,0 +1,128 @@
+#include "deferred.hpp"
+#include "profile/profile_scope.hpp"
+#include <stdexcept>
+
+namespace lunar {
+
+static const std::string gbuffer_pack_lib =
+#include "glsllibs/gbuffer-pack.glsl"
+;
+static const std::string toon_lib =
+#include "glsllibs/3shade2.glsl"
+;
+static const std::string gbuffer_fragment_shader = ShaderProgram::loadGLSLlib(
+    #include "glsllibs/gbuffer-fs.glsl"
+    ,
+    gbuffer_pack_lib
+);
+static const std::string deferred_vertex_shader =
+#include "glsllibs/postprocess-vs.glsl"
+;
+static const std::string deferred_lighting_shader =
+#include "glsllibs/deferred-lighting-fs.glsl"
+;
+
+static unsigned int createTarget(GLenum internal_format, int width, int height) {
+    unsigned int texture;
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glTexStorage2D(GL_TEXTURE_2D, 1, internal_format, width, height);
+    LUNAR_PROFILE_COUNT(Allocations, 1);
+    LUNAR_PROFILE_COUNT(AllocatedBytes, RenderTargetPool::getBytesPerPixel(internal_format) * width * height);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    return texture;
+}
+
+DeferredRenderer::DeferredRenderer(const PostProcesser& target, const std::string& lighting_lib):
+    lighting_shader(deferred_vertex_shader,
+                    ShaderProgram::loadGLSLlib(deferred_lighting_shader, toon_lib + gbuffer_pack_lib + lighting_lib)),
+    target_framebuffer(target.getFramebuffer()), depth_texture(target.getDepthTexture()) {
+    glGenFramebuffers(1, &framebuffer);
+    const TextureExtent extent = target.getExtent();
+    allocate(extent.texture_width, extent.texture_height);
+    allocation_count = target.getAllocationCount();
+
+    lighting_shader.setVertices<4>({
+        {-1.0f,  1.0f,  0.0f, 1.0f},
+        {-1.0f, -1.0f,  0.0f, 0.0f},
+        { 1.0f, -1.0f,  1.0f, 0.0f},
+        {-1.0f,  1.0f,  0.0f, 1.0f},
+        { 1.0f, -1.0f,  1.0f, 0.0f},
+        { 1.0f,  1.0f,  1.0f, 1.0f}
+    });
+    lighting_shader.setVertexDataProperty({"position", "TexCoords"}, {2, 2});
+    lighting_shader.setIndices({0, 1, 2, 3, 4, 5});
+}
+
+DeferredRenderer::~DeferredRenderer() {
+    glDeleteFramebuffers(1, &framebuffer);
+    unsigned int textures[] = {albedo_texture, normal_texture, specular_texture};
+    glDeleteTextures(3, textures);
+}
+
+void DeferredRenderer::allocate(int width, int height) {
+    // G-buffer使用不可变存储, 尺寸变化时整个重建
+    unsigned int textures[] = {albedo_texture, normal_texture, specular_texture};
+    glDeleteTextures(3, textures);
+    albedo_texture = createTarget(GL_RGBA8, width, height);
+    normal_texture = createTarget(GL_RG16, width, height);
+    specular_texture = createTarget(GL_RGBA8, width, height);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, albedo_texture, 0);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT1, GL_TEXTURE_2D, normal_texture, 0);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT2, GL_TEXTURE_2D, specular_texture, 0);
+    // 与PostProcesser共用深度, 光照阶段之后的前向绘制可以直接做深度测试
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, depth_texture, 0);
+    const GLenum attachments[] = {GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1, GL_COLOR_ATTACHMENT2};
+    glDrawBuffers(3, attachments);
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+        throw std::runtime_error("G-buffer framebuffer is not complete");
+    }
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+void DeferredRenderer::resize(const PostProcesser& target) {
+    if (target.getAllocationCount() == allocation_count) return;
+    const TextureExtent extent = target.getExtent();
+    allocate(extent.texture_width, extent.texture_height);
+    allocation_count = target.getAllocationCount();
+}
+
+std::string DeferredRenderer::getGeometryFragmentShader() {
+    return gbuffer_fragment_shader;
+}
+
+void DeferredRenderer::beginGeometryPass() const {
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    glEnable(GL_DEPTH_TEST);
+    // 覆盖标记为0表示该像素没有几何体
+    glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+}
+
+void DeferredRenderer::lightingPass(const glm::mat4& view, const glm::mat4& projection, const glm::vec3& view_pos) {
+    glBindFramebuffer(GL_FRAMEBUFFER, target_framebuffer);
+    // 全屏绘制不读写深度, 保留几何阶段的结果
+    glDisable(GL_DEPTH_TEST);
+
+    lighting_shader.use();
+    lighting_shader.setMat4("inverseViewProjection", glm::inverse(projection * view));
+    lighting_shader.setVec3("viewPos", view_pos);
+    const unsigned int inputs[] = {albedo_texture, normal_texture, specular_texture, depth_texture};
+    const char* names[] = {"gAlbedo", "gNormal", "gSpecular", "gDepth"};
+    for (int i = 0; i < 4; i++) {
+        glActiveTexture(GL_TEXTURE0 + i);
+        glBindTexture(GL_TEXTURE_2D, inputs[i]);
+        lighting_shader.setInt(names[i], i);
+    }
+    lighting_shader.draw();
+
+    glEnable(GL_DEPTH_TEST);
+}
+
+}
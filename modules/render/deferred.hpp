@@ -0,0 +1,47 @@
+#pragma once
+#include "shader.hpp"
+#include "postprocess.hpp"
+#include <glm/glm.hpp>
+#include <string>
+
+namespace lunar {
+
+// 延迟着色: 几何阶段只把材质写入紧凑的G-buffer, 光照与三渲二量化在全屏阶段对每个像素只做一次.
+// G-buffer布局: RGBA8漫反射颜色, RG16八面体法线, RGBA8高光颜色与高光指数,
+// 深度直接使用PostProcesser的深度纹理, 光照结果写入PostProcesser的颜色纹理.
+class DeferredRenderer {
+public:
+    // lighting_lib会拼接进光照着色器, 用来启用分簇光照与级联阴影
+    explicit DeferredRenderer(const PostProcesser& target, const std::string& lighting_lib = "");
+    ~DeferredRenderer();
+    DeferredRenderer(const DeferredRenderer&) = delete;
+    DeferredRenderer& operator=(const DeferredRenderer&) = delete;
+
+    // 几何阶段使用的片段着色器, 与box-vs或gpu-driven-vs搭配
+    static std::string getGeometryFragmentShader();
+
+    // PostProcesser的纹理重新分配之后, G-buffer跟着重新分配, 其余时候什么也不做
+    void resize(const PostProcesser& target);
+    // 绑定并清空G-buffer, 之后正常绘制不透明物体
+    void beginGeometryPass() const;
+    // 切回PostProcesser的帧缓冲并计算光照, 深度保持不变, 之后可以继续前向绘制
+    void lightingPass(const glm::mat4& view, const glm::mat4& projection, const glm::vec3& view_pos);
+
+    // 用于设置光源等uniform, 在lightingPass之前调用
+    [[nodiscard]] ShaderProgram& getLightingShader() { return lighting_shader; }
+    [[nodiscard]] unsigned int getAlbedoTexture() const { return albedo_texture; }
+    [[nodiscard]] unsigned int getNormalTexture() const { return normal_texture; }
+    [[nodiscard]] unsigned int getSpecularTexture() const { return specular_texture; }
+
+private:
+    void allocate(int width, int height);
+
+    ShaderProgram lighting_shader;
+    unsigned int target_framebuffer;
+    unsigned int depth_texture;
+    unsigned int framebuffer;
+    unsigned int albedo_texture{0}, normal_texture{0}, specular_texture{0};
+    unsigned int allocation_count;
+};
+
+}
@@ -0,0 +1,87 @@
+#include "dynamic_resolution.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace lunar {
+
+// 向下取到步长的整数倍, 容忍浮点误差
+static float quantize(float scale) {
+    constexpr float step = DynamicResolutionController::scale_step;
+    return std::floor(scale / step + 1.0e-3f) * step;
+}
+
+DynamicResolutionController::DynamicResolutionController(float target_ms, float min_scale, float max_scale):
+    target_ms(target_ms), min_scale(min_scale), max_scale(std::max(min_scale, max_scale)), scale(this->max_scale) {}
+
+void DynamicResolutionController::reset(float scale) {
+    this->scale = std::clamp(scale, min_scale, max_scale);
+    smoothed_ms = -1.0f;
+    cooldown = 0;
+}
+
+float DynamicResolutionController::update(float gpu_ms) {
+    if (gpu_ms <= 0.0f) return scale;
+    // 指数平滑, 单帧的尖峰不会直接改变分辨率
+    smoothed_ms = smoothed_ms < 0.0f ? gpu_ms : smoothed_ms + 0.2f * (gpu_ms - smoothed_ms);
+    if (cooldown > 0) {
+        cooldown--;
+        return scale;
+    }
+
+    float desired = scale;
+    if (smoothed_ms > target_ms) {
+        desired = quantize(scale * std::sqrt(target_ms / smoothed_ms));
+    } else if (smoothed_ms < target_ms * upscale_threshold) {
+        // 上调只走一半, 同时保证至少一步
+        float estimate = scale * std::sqrt(target_ms * upscale_threshold / smoothed_ms);
+        desired = std::max(scale + scale_step, quantize((scale + estimate) * 0.5f));
+    }
+    desired = std::clamp(desired, min_scale, max_scale);
+    if (std::abs(desired - scale) < scale_step * 0.5f) return scale;
+
+    // 按像素数预测新分辨率下的时间, 冷却结束前不会因为旧的测量值再次调整
+    smoothed_ms *= (desired * desired) / (scale * scale);
+    scale = desired;
+    cooldown = cooldown_frames;
+    return scale;
+}
+
+GpuFrameTimer::GpuFrameTimer() {
+    glGenQueries(ring_size, queries);
+}
+
+GpuFrameTimer::~GpuFrameTimer() {
+    glDeleteQueries(ring_size, queries);
+}
+
+void GpuFrameTimer::begin() {
+    // 环已满时丢弃最早的结果, 保证不会复用仍在进行中的查询
+    if (issued - resolved == ring_size) {
+        float discarded;
+        if (!poll(discarded)) return;
+    }
+    glBeginQuery(GL_TIME_ELAPSED, queries[issued % ring_size]);
+    active = true;
+}
+
+void GpuFrameTimer::end() {
+    if (!active) return;
+    glEndQuery(GL_TIME_ELAPSED);
+    active = false;
+    issued++;
+}
+
+bool GpuFrameTimer::poll(float& milliseconds) {
+    if (resolved == issued) return false;
+    const unsigned int query = queries[resolved % ring_size];
+    GLint available = 0;
+    glGetQueryObjectiv(query, GL_QUERY_RESULT_AVAILABLE, &available);
+    if (!available) return false;
+    GLuint64 nanoseconds = 0;
+    glGetQueryObjectui64v(query, GL_QUERY_RESULT, &nanoseconds);
+    resolved++;
+    milliseconds = static_cast<float>(static_cast<double>(nanoseconds) / 1.0e6);
+    return true;
+}
+
+}
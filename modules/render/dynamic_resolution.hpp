@@ -0,0 +1,58 @@
+#pragma once
+#include <glad/glad.h>
+
+namespace lunar {
+
+// 根据GPU帧时间调整渲染分辨率的缩放系数. 像素数与缩放的平方成正比, 因此按sqrt(预算 / 实际时间)估算目标缩放;
+// 超出预算时立即下调, 低于预算一定比例才缓慢上调, 缩放按固定步长量化, 每次调整后等待若干帧让测量结果跟上.
+class DynamicResolutionController {
+public:
+    explicit DynamicResolutionController(float target_ms = 16.0f, float min_scale = 0.5f, float max_scale = 1.0f);
+
+    // 输入最新一帧的GPU时间, 返回新的缩放
+    float update(float gpu_ms);
+    void reset(float scale = 1.0f);
+
+    [[nodiscard]] float getScale() const { return scale; }
+    [[nodiscard]] float getTargetMilliseconds() const { return target_ms; }
+    // 平滑后的GPU时间, 还没有输入时为负数
+    [[nodiscard]] float getSmoothedMilliseconds() const { return smoothed_ms; }
+
+    static constexpr float scale_step = 0.05f;
+    static constexpr int cooldown_frames = 8;
+    // 低于预算的这个比例才上调, 避免在预算附近来回跳动
+    static constexpr float upscale_threshold = 0.85f;
+
+private:
+    float target_ms;
+    float min_scale, max_scale;
+    float scale;
+    float smoothed_ms{-1.0f};
+    int cooldown{0};
+};
+
+// GPU计时查询的环, 读取的是几帧之前已经完成的结果, 不会等待GPU
+class GpuFrameTimer {
+public:
+    GpuFrameTimer();
+    ~GpuFrameTimer();
+    GpuFrameTimer(const GpuFrameTimer&) = delete;
+    GpuFrameTimer& operator=(const GpuFrameTimer&) = delete;
+
+    void begin();
+    void end();
+    // 取出最早一个已经完成的结果, 没有时返回false
+    bool poll(float& milliseconds);
+    // 已经发出但还没有读回的查询数, 达到ring_size时begin不再计时
+    [[nodiscard]] unsigned int getPendingCount() const { return issued - resolved; }
+
+    static constexpr unsigned int ring_size = 4;
+
+private:
+    unsigned int queries[ring_size]{};
+    unsigned int issued{0};   // 已经发出的查询总数
+    unsigned int resolved{0}; // 已经读回的查询总数
+    bool active{false};
+};
+
+}
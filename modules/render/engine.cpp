@@ -0,0 +1,119 @@
+#include "engine.hpp"
+#include "window.hpp"
+#include "interface/interface.hpp"
+#include "profile/profile_scope.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace lunar {
+
+Engine::Engine(double update_rate) {
+    setUpdateRate(update_rate);
+    // 事件在帧首处理, 回调的结果在同一帧的更新中生效
+    addHook(FramePhase::Input, [](const FrameContext&) {
+        if (Window::initialized) Window::getInstance().pollEvents();
+        Interface::getInstance().dispatchEvents();
+    });
+    addHook(FramePhase::Present, [](const FrameContext&) {
+        if (Window::initialized) Window::getInstance().swapBuffers();
+    });
+}
+
+Engine::HookId Engine::addHook(FramePhase phase, PhaseCallback callback, int priority) {
+    auto& phase_hooks = hooks[static_cast<size_t>(phase)];
+    // 插在同priority的最后一个之后
+    auto position = std::find_if(phase_hooks.begin(), phase_hooks.end(),
+        [priority](const Hook& hook) { return hook.priority < priority; });
+    const HookId id = next_hook_id++;
+    phase_hooks.insert(position, {id, priority, std::move(callback)});
+    return id;
+}
+
+void Engine::removeHook(HookId id) {
+    for (auto& phase_hooks : hooks) {
+        std::erase_if(phase_hooks, [id](const Hook& hook) { return hook.id == id; });
+    }
+}
+
+void Engine::setUpdateRate(double rate) {
+    if (!(rate > 0.0)) {
+        throw std::runtime_error("Engine update rate must be positive");
+    }
+    context.fixed_delta = 1.0 / rate;
+}
+
+void Engine::setMaxUpdatesPerFrame(unsigned int count) {
+    if (count == 0) {
+        throw std::runtime_error("Engine needs at least one update per frame");
+    }
+    max_updates_per_frame = count;
+}
+
+void Engine::run() {
+    if (!Window::initialized) {
+        throw std::runtime_error("Window not initialized");
+    }
+    auto& window = Window::getInstance();
+    stop_requested = false;
+    clock_started = false;
+    while (!stop_requested && !window.shouldClose()) step();
+}
+
+void Engine::step() {
+    if (fixed_frame_time > 0.0) {
+        step(fixed_frame_time);
+        return;
+    }
+    // 第一帧没有上一帧可以比较, 不推进模拟
+    const auto now = std::chrono::steady_clock::now();
+    const double frame_delta = clock_started ? std::chrono::duration<double>(now - last_frame).count() : 0.0;
+    last_frame = now;
+    clock_started = true;
+    step(frame_delta);
+}
+
+void Engine::step(double frame_delta) {
+    LUNAR_PROFILE_SCOPE("frame");
+    context.frame_delta = std::max(frame_delta, 0.0);
+    {
+        LUNAR_PROFILE_SCOPE("input");
+        runPhase(FramePhase::Input);
+    }
+    {
+        LUNAR_PROFILE_SCOPE("update");
+        accumulator += context.frame_delta;
+        unsigned int updates = 0;
+        while (accumulator >= context.fixed_delta) {
+            // 断点, 加载或者更新本身太慢时丢弃积压的时间, 模拟变慢但不会停不下来
+            if (updates == max_updates_per_frame) {
+                // 留一点余量, 舍入误差不会多留下一个几乎完整的步长
+                const double backlog = std::floor(accumulator / context.fixed_delta + 1e-6);
+                skipped_updates += static_cast<uint64_t>(backlog);
+                accumulator = std::max(accumulator - backlog * context.fixed_delta, 0.0);
+                break;
+            }
+            runPhase(FramePhase::Update);
+            accumulator -= context.fixed_delta;
+            context.time += context.fixed_delta;
+            context.update++;
+            updates++;
+        }
+        context.alpha = std::clamp(static_cast<float>(accumulator / context.fixed_delta), 0.0f, 1.0f);
+    }
+    {
+        LUNAR_PROFILE_SCOPE("render");
+        runPhase(FramePhase::Render);
+    }
+    {
+        LUNAR_PROFILE_SCOPE("present");
+        runPhase(FramePhase::Present);
+    }
+    context.frame++;
+}
+
+void Engine::runPhase(FramePhase phase) {
+    for (const Hook& hook : hooks[static_cast<size_t>(phase)]) hook.callback(context);
+}
+
+}
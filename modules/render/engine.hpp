@@ -0,0 +1,99 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <chrono>
+#include <functional>
+#include <vector>
+
+namespace lunar {
+
+// 一帧依次经过的阶段
+enum class FramePhase {
+    Input,    // 处理窗口事件并分发输入队列
+    Update,   // 固定步长的模拟, 一帧内执行零次或多次
+    Render,   // 每帧一次, 按alpha在上一次与这一次更新的状态之间插值
+    Present,  // 交换缓冲区, 以及帧末的统计与检查
+};
+
+struct FrameContext {
+    uint64_t frame{0};         // 当前帧, 从0开始
+    uint64_t update{0};        // 已经完成的更新次数, Update阶段内为当前这一次的序号
+    double time{0.0};          // 模拟时间: 更新次数 * fixed_delta
+    double frame_delta{0.0};   // 这一帧经过的时间, 单位为秒
+    double fixed_delta{0.0};   // 更新的步长
+    float alpha{0.0f};         // 累积器中剩余的时间 / fixed_delta, 在[0, 1)内
+
+    // Render阶段画面对应的模拟时间, 在上一次与这一次更新之间
+    [[nodiscard]] double getRenderTime() const {
+        const double render_time = time - (1.0 - alpha) * fixed_delta;
+        return render_time > 0.0 ? render_time : 0.0;
+    }
+};
+
+// 主循环: 输入, 固定频率的更新, 可变频率的渲染, 呈现. 渲染频率与更新频率无关,
+// 模拟结果不受帧率影响. 各子系统通过addHook挂到某个阶段上; 同一阶段按priority从高到低执行,
+// 相同时按添加顺序. 事件处理与交换缓冲区是priority为builtin_priority的内置钩子,
+// 需要在它们之前或之后执行的钩子使用更高或更低的priority
+class Engine {
+public:
+    using PhaseCallback = std::function<void(const FrameContext&)>;
+    using HookId = size_t;
+
+    static constexpr double default_update_rate = 60.0;
+    // 一帧最多追赶的更新次数, 超出的部分直接丢弃, 避免更新越慢越追不上
+    static constexpr unsigned int default_max_updates_per_frame = 5;
+    static constexpr int builtin_priority = 0;
+
+    explicit Engine(double update_rate = default_update_rate);
+    Engine(const Engine&) = delete;
+    Engine& operator=(const Engine&) = delete;
+
+    HookId addHook(FramePhase phase, PhaseCallback callback, int priority = builtin_priority);
+    // 不要在钩子内部添加或移除钩子
+    void removeHook(HookId id);
+
+    // 每秒更新的次数; 不能为0或负数
+    void setUpdateRate(double rate);
+    void setMaxUpdatesPerFrame(unsigned int count);
+    // 大于0时每帧按这个时间推进而不读时钟, 用于输入回放与测试; 0时恢复使用时钟
+    void setFixedFrameTime(double seconds) { fixed_frame_time = seconds; }
+
+    // 直到窗口关闭或requestStop, 需要先初始化Window
+    void run();
+    // 执行一帧, frame_delta来自时钟或setFixedFrameTime
+    void step();
+    // 执行一帧, 这一帧经过frame_delta秒
+    void step(double frame_delta);
+    void requestStop() { stop_requested = true; }
+    [[nodiscard]] bool isStopRequested() const { return stop_requested; }
+
+    [[nodiscard]] const FrameContext& getContext() const { return context; }
+    [[nodiscard]] double getUpdateRate() const { return 1.0 / context.fixed_delta; }
+    [[nodiscard]] uint64_t getFrameCount() const { return context.frame; }
+    [[nodiscard]] uint64_t getUpdateCount() const { return context.update; }
+    // 因超过每帧更新上限而丢弃的更新次数
+    [[nodiscard]] uint64_t getSkippedUpdateCount() const { return skipped_updates; }
+
+private:
+    struct Hook {
+        HookId id;
+        int priority;
+        PhaseCallback callback;
+    };
+    static constexpr size_t phase_count = 4;
+
+    void runPhase(FramePhase phase);
+
+    std::vector<Hook> hooks[phase_count];
+    HookId next_hook_id{0};
+    FrameContext context;
+    double accumulator{0.0};
+    unsigned int max_updates_per_frame{default_max_updates_per_frame};
+    uint64_t skipped_updates{0};
+    double fixed_frame_time{0.0};
+    std::chrono::steady_clock::time_point last_frame;
+    bool clock_started{false};
+    bool stop_requested{false};
+};
+
+}
@@ -0,0 +1,183 @@
+#include "frame_capture.hpp"
+#include "window.hpp"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <utility>
+
+namespace lunar {
+
+FrameCapture::FrameCapture(unsigned int ring_size, size_t queue_limit):
+    slots(ring_size), queue_limit(queue_limit) {
+    if (ring_size == 0) {
+        throw std::runtime_error("Frame capture needs at least one pixel buffer");
+    }
+    for (Slot& slot : slots) glGenBuffers(1, &slot.buffer);
+    encoder = std::thread(&FrameCapture::run, this);
+}
+
+FrameCapture::~FrameCapture() {
+    flush();
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    encoder.join();
+    for (Slot& slot : slots) {
+        if (slot.fence) glDeleteSync(slot.fence);
+        glDeleteBuffers(1, &slot.buffer);
+    }
+}
+
+void FrameCapture::setOutput(const std::string& directory, CaptureFormat format, const std::string& prefix) {
+    std::lock_guard<std::mutex> lock(mutex);
+    this->directory = directory;
+    this->format = format;
+    this->prefix = prefix;
+}
+
+void FrameCapture::setCallback(FrameCallback callback) {
+    std::lock_guard<std::mutex> lock(mutex);
+    this->callback = std::move(callback);
+}
+
+void FrameCapture::capture(GLuint framebuffer, int width, int height) {
+    if (width <= 0 || height <= 0) return;
+    // 先取回所有已经完成的, 保持顺序, 遇到第一个未完成的就停下
+    while (pending_count > 0 && retrieveOldest(false)) {}
+    // 环已满时只能等最旧的一个, 隔了ring_size - 1帧通常已经完成
+    if (pending_count == slots.size()) retrieveOldest(true);
+
+    Slot& slot = slots[(oldest + pending_count) % slots.size()];
+    const size_t size = static_cast<size_t>(width) * static_cast<size_t>(height) * 4;
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.buffer);
+    if (slot.capacity < size) {
+        glBufferData(GL_PIXEL_PACK_BUFFER, static_cast<GLsizeiptr>(size), nullptr, GL_STREAM_READ);
+        slot.capacity = size;
+    }
+    GLint previous_framebuffer = 0, previous_read_buffer = GL_BACK, previous_alignment = 4;
+    glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &previous_framebuffer);
+    glGetIntegerv(GL_PACK_ALIGNMENT, &previous_alignment);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, framebuffer);
+    glGetIntegerv(GL_READ_BUFFER, &previous_read_buffer);
+    glReadBuffer(framebuffer ? GL_COLOR_ATTACHMENT0 : GL_BACK);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    // 绑定了像素缓冲时最后一个参数是缓冲内的偏移, 调用立即返回
+    glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    glPixelStorei(GL_PACK_ALIGNMENT, previous_alignment);
+    glReadBuffer(static_cast<GLenum>(previous_read_buffer));
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, previous_framebuffer);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    slot.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    slot.width = width;
+    slot.height = height;
+    slot.index = capture_index++;
+    pending_count++;
+}
+
+void FrameCapture::capture() {
+    const auto& window = Window::getInstance();
+    capture(window.getFramebuffer(), window.getWidth(), window.getHeight());
+}
+
+bool FrameCapture::retrieveOldest(bool wait) {
+    Slot& slot = slots[oldest];
+    GLenum status = glClientWaitSync(slot.fence, GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+    if (status == GL_TIMEOUT_EXPIRED) {
+        if (!wait) return false;
+        stall_count++;
+        while ((status = glClientWaitSync(slot.fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000)) == GL_TIMEOUT_EXPIRED) {}
+    }
+    glDeleteSync(slot.fence);
+    slot.fence = nullptr;
+    oldest = (oldest + 1) % static_cast<unsigned int>(slots.size());
+    pending_count--;
+
+    bool accepted;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        accepted = queue.size() < queue_limit;
+        if (!accepted) dropped_count++;
+    }
+    if (!accepted || status == GL_WAIT_FAILED) return true;
+
+    const size_t size = static_cast<size_t>(slot.width) * static_cast<size_t>(slot.height) * 4;
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.buffer);
+    const void* mapped = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, static_cast<GLsizeiptr>(size), GL_MAP_READ_BIT);
+    if (mapped) {
+        std::vector<unsigned char> pixels(size);
+        std::memcpy(pixels.data(), mapped, size);
+        glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            queue.push_back({slot.index, Image(slot.width, slot.height, std::move(pixels))});
+        }
+        wake.notify_one();
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    return true;
+}
+
+void FrameCapture::flush() {
+    while (pending_count > 0) retrieveOldest(true);
+    std::unique_lock<std::mutex> lock(mutex);
+    idle.wait(lock, [this] { return queue.empty() && !encoding; });
+}
+
+uint64_t FrameCapture::getEncodedCount() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return encoded_count;
+}
+
+uint64_t FrameCapture::getDroppedCount() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return dropped_count;
+}
+
+void FrameCapture::run() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        wake.wait(lock, [this] { return stopping || !queue.empty(); });
+        if (queue.empty()) break;
+        CapturedFrame frame = std::move(queue.front());
+        queue.pop_front();
+        encoding = true;
+        lock.unlock();
+        encode(frame);
+        lock.lock();
+        encoding = false;
+        encoded_count++;
+        if (queue.empty()) idle.notify_all();
+    }
+}
+
+void FrameCapture::encode(CapturedFrame& frame) {
+    Image& image = frame.image;
+    flipRows(image.pixels, image.width, image.height);
+
+    FrameCallback frame_callback;
+    std::string path;
+    CaptureFormat frame_format;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        frame_callback = callback;
+        frame_format = format;
+        char name[32];
+        std::snprintf(name, sizeof(name), "_%06llu", static_cast<unsigned long long>(frame.index));
+        path = directory + "/" + prefix + name;
+    }
+    if (frame_callback) {
+        frame_callback(frame);
+        return;
+    }
+    if (frame_format == CaptureFormat::PNG) {
+        writePNG(path + ".png", image);
+        return;
+    }
+    std::ofstream file(path + "_" + std::to_string(image.width) + "x" + std::to_string(image.height) + ".rgba", std::ios::binary);
+    file.write(reinterpret_cast<const char*>(image.pixels.data()), static_cast<std::streamsize>(image.pixels.size()));
+}
+
+}
@@ -0,0 +1,96 @@
+#pragma once
+#include "image.hpp"
+#include <glad/glad.h>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace lunar {
+
+enum class CaptureFormat {
+    PNG,
+    Raw,  // 不做任何编码的RGBA8, 第一行为图像顶部, 大小见文件名
+};
+
+struct CapturedFrame {
+    uint64_t index{0};  // 第几次capture, 从0开始
+    Image image;
+};
+
+// 不阻塞管线的帧捕获: glReadPixels读进像素缓冲对象的环, 每次读取后插入栅栏,
+// 隔ring_size - 1帧之后GPU早已完成, 这时才映射取回, 交给后台线程翻转与编码.
+// 渲染线程上只有一次memcpy; 编码跟不上时丢弃新的帧而不是等待, 丢弃的数量可以查询.
+class FrameCapture {
+public:
+    static constexpr unsigned int default_ring_size = 3;
+    static constexpr size_t default_queue_limit = 8;
+    // 在编码线程上调用, 设置之后不再写文件
+    using FrameCallback = std::function<void(const CapturedFrame&)>;
+
+    // 需要GL上下文
+    explicit FrameCapture(unsigned int ring_size = default_ring_size, size_t queue_limit = default_queue_limit);
+    ~FrameCapture();
+    FrameCapture(const FrameCapture&) = delete;
+    FrameCapture& operator=(const FrameCapture&) = delete;
+
+    // 写到directory/prefix_000000.png, Raw时为prefix_000000_WxH.rgba
+    void setOutput(const std::string& directory, CaptureFormat format = CaptureFormat::PNG, const std::string& prefix = "frame");
+    void setCallback(FrameCallback callback);
+
+    // 在交换缓冲之前调用, 读取framebuffer的颜色附件0(为0时读后缓冲), 并取回已经完成的旧帧
+    void capture(GLuint framebuffer, int width, int height);
+    // 读取Window的最终画面
+    void capture();
+    // 等待并取回所有在途的读取, 再等编码线程处理完; 测试与退出时调用
+    void flush();
+
+    [[nodiscard]] uint64_t getCapturedCount() const { return capture_index; }
+    [[nodiscard]] uint64_t getEncodedCount();
+    [[nodiscard]] uint64_t getDroppedCount();
+    // 取回时栅栏还没有完成而不得不等待的次数, 正常应为0
+    [[nodiscard]] uint64_t getStallCount() const { return stall_count; }
+    [[nodiscard]] unsigned int getPendingCount() const { return pending_count; }
+
+private:
+    struct Slot {
+        GLuint buffer{0};
+        GLsync fence{nullptr};
+        int width{0}, height{0};
+        size_t capacity{0};
+        uint64_t index{0};
+    };
+
+    // 把最旧的一个在途读取取回并送入编码队列, wait为false且还未完成时返回false
+    bool retrieveOldest(bool wait);
+    void run();
+    void encode(CapturedFrame& frame);
+
+    std::vector<Slot> slots;
+    unsigned int oldest{0};
+    unsigned int pending_count{0};
+    uint64_t capture_index{0};
+    uint64_t stall_count{0};
+
+    std::string directory{"."};
+    std::string prefix{"frame"};
+    CaptureFormat format{CaptureFormat::PNG};
+    FrameCallback callback;
+
+    std::thread encoder;
+    std::mutex mutex;  // 保护以下成员与上面的输出设置
+    std::condition_variable wake;
+    std::condition_variable idle;
+    std::deque<CapturedFrame> queue;
+    size_t queue_limit;
+    bool encoding{false};
+    bool stopping{false};
+    uint64_t encoded_count{0};
+    uint64_t dropped_count{0};
+};
+
+}
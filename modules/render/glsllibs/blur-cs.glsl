@@ -0,0 +1,51 @@
+R"(
+#version 430 core
+#define BLUR_GROUP_SIZE 128
+#define BLUR_TILE_SIZE (BLUR_GROUP_SIZE + 2 * MAX_BLUR_RADIUS + 1)
+layout(local_size_x = BLUR_GROUP_SIZE) in;
+
+uniform sampler2D inputTexture;
+uniform sampler2D depthTexture;
+uniform ivec2 blurAxis;  // (1, 0)为水平, (0, 1)为竖直
+uniform ivec2 imageExtent;  // 有效区域, 动态分辨率下小于纹理尺寸
+layout(rgba8) writeonly uniform image2D outputImage;
+
+// 每个工作组处理一行(或一列)中连续的BLUR_GROUP_SIZE个像素, 连同两侧的半径一起读入共享内存
+shared vec3 tile[BLUR_TILE_SIZE];
+
+vec3 sampleTile(float position) {
+    int index = int(floor(position));
+    return mix(tile[index], tile[index + 1], position - float(index));
+}
+
+void main()
+{
+    ivec2 size = imageExtent;
+    ivec2 across = ivec2(1) - blurAxis;
+    int lineLength = blurAxis.x == 1 ? size.x : size.y;
+    int line = int(gl_WorkGroupID.y);
+    int start = int(gl_WorkGroupID.x) * BLUR_GROUP_SIZE - MAX_BLUR_RADIUS;
+
+    for (int i = int(gl_LocalInvocationID.x); i < BLUR_TILE_SIZE; i += BLUR_GROUP_SIZE) {
+        int position = clamp(start + i, 0, lineLength - 1);
+        tile[i] = texelFetch(inputTexture, blurAxis * position + across * line, 0).rgb;
+    }
+    barrier();
+
+    int position = int(gl_GlobalInvocationID.x);
+    if (position >= lineLength) return;
+    ivec2 pixel = blurAxis * position + across * line;
+    int radius = blurRadius(texelFetch(depthTexture, pixel, 0).r);
+
+    // 与片段着色器版本使用同一张表, 分数偏移在共享内存里插值
+    int base = radius * BLUR_TAP_STRIDE;
+    float center = float(int(gl_LocalInvocationID.x) + MAX_BLUR_RADIUS);
+    vec3 color = tile[int(center)] * blurTaps[base].x;
+    int taps = (radius + 1) / 2;
+    for (int i = 1; i <= taps; i++) {
+        vec2 tap = blurTaps[base + i].xy;
+        color += (sampleTile(center + tap.x) + sampleTile(center - tap.x)) * tap.y;
+    }
+    imageStore(outputImage, pixel, vec4(color, 1.0));
+}
+)"
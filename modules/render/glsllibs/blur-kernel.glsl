@@ -0,0 +1,29 @@
+R"(
+// 可分离高斯模糊, 权重由CPU预先计算(见PostProcesser::uploadBlurKernel)
+#define MAX_BLUR_RADIUS 5
+#define BLUR_TAP_STRIDE 4
+
+// 半径r的核占blurTaps[r * BLUR_TAP_STRIDE]开始的(r + 1) / 2 + 1项:
+// 第0项x为中心权重, 之后每项x为到中心的偏移(像素), y为该处双线性采样的权重(已乘2侧中的一侧)
+layout(std140, binding = 0) uniform BlurKernel {
+    vec4 blurTaps[(MAX_BLUR_RADIUS + 1) * BLUR_TAP_STRIDE];
+};
+
+// 半径随深度增大, 与原来的5 * depth一致
+int blurRadius(float depth) {
+    return clamp(int(float(MAX_BLUR_RADIUS) * depth), 0, MAX_BLUR_RADIUS);
+}
+
+// 沿direction(以uv为单位的一个像素)做一维模糊, 每次双线性采样合并两个相邻像素.
+// 采样位置限制在uvMax以内, 不读有效区域外的像素
+vec3 separableBlur(sampler2D source, vec2 uv, vec2 direction, int radius) {
+    int base = radius * BLUR_TAP_STRIDE;
+    vec3 color = texture(source, uv).rgb * blurTaps[base].x;
+    int taps = (radius + 1) / 2;
+    for (int i = 1; i <= taps; i++) {
+        vec2 tap = blurTaps[base + i].xy;
+        color += (texture(source, min(uv + direction * tap.x, uvMax)).rgb + texture(source, min(uv - direction * tap.x, uvMax)).rgb) * tap.y;
+    }
+    return color;
+}
+)"
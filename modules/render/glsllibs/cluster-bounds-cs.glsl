@@ -0,0 +1,50 @@
+R"(
+#version 430 core
+layout(local_size_x = 64) in;
+
+struct ClusterBounds {
+    vec4 minPoint; // 观察空间
+    vec4 maxPoint;
+};
+
+layout(std430, binding = 7) writeonly buffer ClusterBoundsBuffer {
+    ClusterBounds clusterBounds[];
+};
+
+uniform mat4 inverseProjection;
+uniform uvec3 gridSize;
+uniform float zNear;
+uniform float zFar;
+
+// 从原点出发经过point的射线与z = depth平面的交点
+vec3 intersectDepthPlane(vec3 point, float depth) {
+    return point * (depth / point.z);
+}
+
+vec3 ndcToView(vec2 ndc) {
+    vec4 view = inverseProjection * vec4(ndc, -1.0, 1.0);
+    return view.xyz / view.w;
+}
+
+void main()
+{
+    uint index = gl_GlobalInvocationID.x;
+    if (index >= gridSize.x * gridSize.y * gridSize.z) return;
+    uvec3 cell = uvec3(index % gridSize.x, (index / gridSize.x) % gridSize.y, index / (gridSize.x * gridSize.y));
+
+    vec3 tileMin = ndcToView(vec2(cell.xy) / vec2(gridSize.xy) * 2.0 - 1.0);
+    vec3 tileMax = ndcToView(vec2(cell.xy + 1u) / vec2(gridSize.xy) * 2.0 - 1.0);
+
+    // 深度方向按指数划分, 使每层在屏幕上的厚度大致相同
+    float sliceNear = -zNear * pow(zFar / zNear, float(cell.z) / float(gridSize.z));
+    float sliceFar = -zNear * pow(zFar / zNear, float(cell.z + 1u) / float(gridSize.z));
+
+    vec3 minNear = intersectDepthPlane(tileMin, sliceNear);
+    vec3 minFar = intersectDepthPlane(tileMin, sliceFar);
+    vec3 maxNear = intersectDepthPlane(tileMax, sliceNear);
+    vec3 maxFar = intersectDepthPlane(tileMax, sliceFar);
+
+    clusterBounds[index].minPoint = vec4(min(min(minNear, minFar), min(maxNear, maxFar)), 0.0);
+    clusterBounds[index].maxPoint = vec4(max(max(minNear, minFar), max(maxNear, maxFar)), 0.0);
+}
+)"
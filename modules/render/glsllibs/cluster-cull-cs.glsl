@@ -0,0 +1,75 @@
+R"(
+#version 430 core
+layout(local_size_x = 128) in;
+
+struct ClusterBounds {
+    vec4 minPoint;
+    vec4 maxPoint;
+};
+
+layout(std430, binding = 7) readonly buffer ClusterBoundsBuffer {
+    ClusterBounds clusterBounds[];
+};
+
+layout(std430, binding = 8) writeonly buffer ClusterGridBuffer {
+    uvec2 clusterGrid[]; // x = 在索引表中的偏移, y = 光源数量
+};
+
+layout(std430, binding = 9) buffer ClusterIndexBuffer {
+    uint globalIndexCount;
+    uint clusterLightIndices[];
+};
+
+uniform mat4 view;
+uniform uint clusterCount;
+uniform uint lightCount;
+uniform uint indexCapacity;
+
+shared vec4 sharedLights[128]; // 观察空间位置 + 半径
+
+bool sphereIntersectsBounds(vec4 sphere, vec3 bmin, vec3 bmax) {
+    vec3 closest = clamp(sphere.xyz, bmin, bmax);
+    vec3 delta = closest - sphere.xyz;
+    return dot(delta, delta) <= sphere.w * sphere.w;
+}
+
+void main()
+{
+    uint clusterIndex = gl_GlobalInvocationID.x;
+    bool valid = clusterIndex < clusterCount;
+    vec3 bmin = valid ? clusterBounds[clusterIndex].minPoint.xyz : vec3(0.0);
+    vec3 bmax = valid ? clusterBounds[clusterIndex].maxPoint.xyz : vec3(0.0);
+
+    uint visibleLights[MAX_LIGHTS_PER_CLUSTER];
+    uint visibleCount = 0u;
+
+    // 整个工作组分批把光源变换到观察空间并放入共享内存, 每个簇只遍历共享内存
+    for (uint base = 0u; base < lightCount; base += 128u) {
+        uint lightIndex = base + gl_LocalInvocationIndex;
+        if (lightIndex < lightCount) {
+            vec4 positionRadius = clusterLights[lightIndex].positionRadius;
+            sharedLights[gl_LocalInvocationIndex] = vec4((view * vec4(positionRadius.xyz, 1.0)).xyz, positionRadius.w);
+        }
+        barrier();
+
+        uint batchSize = min(128u, lightCount - base);
+        if (valid) {
+            for (uint i = 0u; i < batchSize && visibleCount < MAX_LIGHTS_PER_CLUSTER; i++) {
+                if (sphereIntersectsBounds(sharedLights[i], bmin, bmax)) {
+                    visibleLights[visibleCount++] = base + i;
+                }
+            }
+        }
+        barrier();
+    }
+
+    if (!valid) return;
+    uint offset = atomicAdd(globalIndexCount, visibleCount);
+    // 索引表溢出时丢弃多余的光源, 而不是越界写入
+    visibleCount = offset < indexCapacity ? min(visibleCount, indexCapacity - offset) : 0u;
+    for (uint i = 0u; i < visibleCount; i++) {
+        clusterLightIndices[offset + i] = visibleLights[i];
+    }
+    clusterGrid[clusterIndex] = uvec2(offset, visibleCount);
+}
+)"
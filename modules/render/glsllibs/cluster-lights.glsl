@@ -0,0 +1,18 @@
+R"(
+#define MAX_LIGHTS_PER_CLUSTER 128
+
+struct ClusterLight {
+    vec4 positionRadius;  // xyz = 世界空间位置, w = 影响半径
+    vec4 directionType;   // xyz = 聚光方向, w = 0 点光源 / 1 聚光灯
+    vec4 color;
+    vec4 ambient;
+    vec4 diffuse;
+    vec4 specular;
+    vec4 attenuation;     // 常数项, 一次项, 二次项
+    vec4 cone;            // 内锥角余弦, 外锥角余弦
+};
+
+layout(std430, binding = 6) readonly buffer ClusterLightBuffer {
+    ClusterLight clusterLights[];
+};
+)"
@@ -0,0 +1,58 @@
+R"(
+#define LUNAR_CLUSTERED
+layout(std430, binding = 8) readonly buffer ClusterGridBuffer {
+    uvec2 clusterGrid[];
+};
+
+layout(std430, binding = 9) readonly buffer ClusterIndexBuffer {
+    uint globalIndexCount;
+    uint clusterLightIndices[];
+};
+
+uniform uvec3 clusterGridSize;
+uniform vec2 clusterScreenSize;
+uniform float clusterNear;
+uniform float clusterFar;
+
+uint findCluster() {
+    // 由窗口深度恢复观察空间线性深度
+    float ndcDepth = gl_FragCoord.z * 2.0 - 1.0;
+    float linearDepth = 2.0 * clusterNear * clusterFar / (clusterFar + clusterNear - ndcDepth * (clusterFar - clusterNear));
+    uint slice = uint(max(log(linearDepth / clusterNear) / log(clusterFar / clusterNear) * float(clusterGridSize.z), 0.0));
+    uvec2 tile = uvec2(gl_FragCoord.xy / clusterScreenSize * vec2(clusterGridSize.xy));
+    tile = min(tile, clusterGridSize.xy - 1u);
+    slice = min(slice, clusterGridSize.z - 1u);
+    return tile.x + tile.y * clusterGridSize.x + slice * clusterGridSize.x * clusterGridSize.y;
+}
+
+// 只遍历当前片段所在簇的光源列表
+vec3 computeClusteredLighting(vec3 fragPos, vec3 normal, vec3 viewDir, vec3 diffuseColor, vec3 specularColor, float shininess) {
+    uvec2 cluster = clusterGrid[findCluster()];
+    vec3 result = vec3(0.0);
+    for (uint i = 0u; i < cluster.y; i++) {
+        ClusterLight light = clusterLights[clusterLightIndices[cluster.x + i]];
+        vec3 toLight = light.positionRadius.xyz - fragPos;
+        float distanceToLight = length(toLight);
+        if (distanceToLight >= light.positionRadius.w) continue;
+        vec3 lightDir = toLight / distanceToLight;
+
+        float attenuation = 1.0 / (light.attenuation.x + light.attenuation.y * distanceToLight + light.attenuation.z * distanceToLight * distanceToLight);
+        // 在半径处平滑衰减到0, 避免簇边界处的突变
+        float window = clamp(1.0 - pow(distanceToLight / light.positionRadius.w, 4.0), 0.0, 1.0);
+        attenuation *= window * window;
+        if (light.directionType.w > 0.5) {
+            float theta = dot(lightDir, normalize(-light.directionType.xyz));
+            attenuation *= clamp((theta - light.cone.y) / max(light.cone.x - light.cone.y, 1e-4), 0.0, 1.0);
+        }
+
+        vec3 ambient = light.ambient.rgb * diffuseColor;
+        float diff = max(dot(normal, lightDir), 0.0);
+        vec3 diffuse = light.color.rgb * diff * light.diffuse.rgb * diffuseColor;
+        vec3 halfwayDir = normalize(lightDir + viewDir);
+        float spec = pow(max(dot(normal, halfwayDir), 0.0), shininess);
+        vec3 specular = light.color.rgb * spec * light.specular.rgb * specularColor;
+        result += (ambient + diffuse + specular) * attenuation;
+    }
+    return result;
+}
+)"
@@ -0,0 +1,50 @@
+R"(
+#define LUNAR_SHADOWS
+#define MAX_SHADOW_CASCADES 4
+
+struct ParallelLight {
+    vec3 direction;  // 光线传播的方向
+    vec3 ambient;
+    vec3 diffuse;
+    vec3 specular;
+};
+
+uniform ParallelLight sun;
+uniform sampler2DArrayShadow shadowMap;
+uniform mat4 shadowMatrices[MAX_SHADOW_CASCADES];
+uniform float shadowTexelSizes[MAX_SHADOW_CASCADES];  // 每个级联一个纹素对应的世界空间尺寸
+uniform int shadowCascadeCount;
+
+// 返回0(完全在阴影中)到1(完全受光)
+float computeShadow(vec3 fragPos, vec3 normal) {
+    vec3 lightDir = normalize(-sun.direction);
+    float slope = 1.0 - max(dot(normal, lightDir), 0.0);
+    vec2 texel = 1.0 / vec2(textureSize(shadowMap, 0).xy);
+    // 级联按从近到远排列, 取第一个覆盖该片段的级联
+    for (int i = 0; i < shadowCascadeCount; i++) {
+        // 沿法线偏移, 偏移量与纹素大小成正比, 掠射角时更大
+        vec3 offsetPos = fragPos + normal * shadowTexelSizes[i] * (0.5 + 1.5 * slope);
+        vec3 coord = (shadowMatrices[i] * vec4(offsetPos, 1.0)).xyz * 0.5 + 0.5;
+        if (any(lessThan(coord.xy, texel)) || any(greaterThan(coord.xy, 1.0 - texel)) || coord.z > 1.0) continue;
+        // 3x3 PCF, 每次采样由硬件完成比较与双线性过滤
+        float lit = 0.0;
+        for (int x = -1; x <= 1; x++) {
+            for (int y = -1; y <= 1; y++) {
+                lit += texture(shadowMap, vec4(coord.xy + vec2(x, y) * texel, float(i), coord.z));
+            }
+        }
+        return lit / 9.0;
+    }
+    return 1.0;
+}
+
+vec3 computeSunLighting(vec3 fragPos, vec3 normal, vec3 viewDir, vec3 diffuseColor, vec3 specularColor, float shininess) {
+    vec3 lightDir = normalize(-sun.direction);
+    vec3 ambient = sun.ambient * diffuseColor;
+    float diff = max(dot(normal, lightDir), 0.0);
+    vec3 halfwayDir = normalize(lightDir + viewDir);
+    float spec = pow(max(dot(normal, halfwayDir), 0.0), shininess);
+    vec3 lit = sun.diffuse * diff * diffuseColor + sun.specular * spec * specularColor;
+    return ambient + computeShadow(fragPos, normal) * lit;
+}
+)"
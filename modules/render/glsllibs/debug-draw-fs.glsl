@@ -0,0 +1,10 @@
+R"(
+#version 430 core
+in vec4 Color;
+out vec4 FragColor;
+
+void main()
+{
+    FragColor = Color;
+}
+)"
@@ -0,0 +1,15 @@
+R"(
+#version 430 core
+layout(location = 0) in vec3 aPos;
+layout(location = 1) in vec4 aColor;
+
+out vec4 Color;
+
+uniform mat4 viewProjection;
+
+void main()
+{
+    gl_Position = viewProjection * vec4(aPos, 1.0);
+    Color = aColor;
+}
+)"
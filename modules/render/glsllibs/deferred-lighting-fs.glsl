@@ -0,0 +1,65 @@
+R"(
+#version 430 core
+
+struct Light {
+    vec3 position;
+    vec3 color;
+    vec3 ambient;
+    vec3 diffuse;
+    vec3 specular;
+};
+
+in vec2 TexCoords;
+out vec4 fragColor;
+
+uniform sampler2D gAlbedo;
+uniform sampler2D gNormal;
+uniform sampler2D gSpecular;
+uniform sampler2D gDepth;
+
+uniform mat4 inverseViewProjection;
+uniform vec3 viewPos;
+uniform Light light;
+
+void main()
+{
+    // 与G-buffer逐像素对应, 不需要过滤
+    ivec2 pixel = ivec2(gl_FragCoord.xy);
+    vec4 albedo = texelFetch(gAlbedo, pixel, 0);
+    // 没有几何体的像素保留清屏颜色
+    if (albedo.a == 0.0) discard;
+
+    float depth = texelFetch(gDepth, pixel, 0).r;
+    // 全屏矩形覆盖的是视口, 动态分辨率下视口只是纹理的一部分
+    vec2 uv = TexCoords;
+    vec4 world = inverseViewProjection * vec4(vec3(uv, depth) * 2.0 - 1.0, 1.0);
+    vec3 fragPos = world.xyz / world.w;
+
+    vec3 normal = decodeNormal(texelFetch(gNormal, pixel, 0).rg);
+    vec4 specularShininess = texelFetch(gSpecular, pixel, 0);
+    vec3 diffuseColor = albedo.rgb;
+    vec3 specularColor = specularShininess.rgb;
+    float shininess = specularShininess.a * MAX_SHININESS;
+    vec3 viewDir = normalize(viewPos - fragPos);
+
+#ifdef LUNAR_CLUSTERED
+    vec3 result = computeClusteredLighting(fragPos, normal, viewDir, diffuseColor, specularColor, shininess);
+#else
+    vec3 lightDir = normalize(light.position - fragPos);
+    vec3 ambient = light.ambient * diffuseColor;
+    float diff = max(dot(normal, lightDir), 0.0);
+    vec3 diffuse = light.color * diff * light.diffuse * diffuseColor;
+    vec3 halfwayDir = normalize(lightDir + viewDir);
+    float spec = pow(max(dot(normal, halfwayDir), 0.0), shininess);
+    vec3 specular = light.color * spec * light.specular * specularColor;
+    vec3 result = ambient + diffuse + specular;
+#endif
+#ifdef LUNAR_SHADOWS
+    result += computeSunLighting(fragPos, normal, viewDir, diffuseColor, specularColor, shininess);
+#endif
+
+    // 三渲二量化每个像素只做一次
+    result = color_thinning(result, 2.0);
+    fragColor = vec4(result, 1.0);
+}
+)"
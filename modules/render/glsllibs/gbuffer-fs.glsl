@@ -0,0 +1,26 @@
+R"(
+#version 430 core
+
+struct Material {
+    sampler2D diffuse;
+    sampler2D specular;
+    float shininess;
+};
+
+in vec3 normal;
+in vec3 fragPos;
+in vec2 TexCoords;
+
+layout (location = 0) out vec4 gAlbedo;    // rgb: 漫反射颜色, a: 覆盖标记
+layout (location = 1) out vec2 gNormal;    // 八面体编码的法线
+layout (location = 2) out vec4 gSpecular;  // rgb: 高光颜色, a: 高光指数
+
+uniform Material material;
+
+void main()
+{
+    gAlbedo = vec4(texture(material.diffuse, TexCoords).rgb, 1.0);
+    gNormal = encodeNormal(normalize(normal));
+    gSpecular = vec4(texture(material.specular, TexCoords).rgb, clamp(material.shininess / MAX_SHININESS, 0.0, 1.0));
+}
+)"
@@ -0,0 +1,23 @@
+R"(
+// 八面体法线编码, 单位法线压缩到两个[0, 1]分量
+vec2 octWrap(vec2 v) {
+    return (1.0 - abs(v.yx)) * vec2(v.x >= 0.0 ? 1.0 : -1.0, v.y >= 0.0 ? 1.0 : -1.0);
+}
+
+vec2 encodeNormal(vec3 n) {
+    n /= abs(n.x) + abs(n.y) + abs(n.z);
+    n.xy = n.z >= 0.0 ? n.xy : octWrap(n.xy);
+    return n.xy * 0.5 + 0.5;
+}
+
+vec3 decodeNormal(vec2 f) {
+    f = f * 2.0 - 1.0;
+    vec3 n = vec3(f.x, f.y, 1.0 - abs(f.x) - abs(f.y));
+    float t = clamp(-n.z, 0.0, 1.0);
+    n.xy += vec2(n.x >= 0.0 ? -t : t, n.y >= 0.0 ? -t : t);
+    return normalize(n);
+}
+
+// 高光指数按[0, 256)存入8位通道
+const float MAX_SHININESS = 256.0;
+)"
@@ -0,0 +1,83 @@
+R"(
+#version 430 core
+layout(local_size_x = 64) in;
+
+struct Instance {
+    mat4 model;
+    mat4 normalMatrix;
+    vec4 boundsMin; // 世界空间
+    vec4 boundsMax;
+    uvec4 info;     // x = 网格编号
+};
+
+struct MeshInfo {
+    uint lodFirst;
+    uint lodCount;
+    uint batch;
+    uint padding;
+};
+
+struct Lod {
+    uint indexCount;
+    uint firstIndex;
+    int baseVertex;
+    float maxDistance;
+};
+
+struct DrawCommand {
+    uint count;
+    uint instanceCount;
+    uint firstIndex;
+    int baseVertex;
+    uint baseInstance;
+};
+
+layout(std430, binding = 0) readonly buffer InstanceBuffer { Instance instances[]; };
+layout(std430, binding = 1) readonly buffer MeshBuffer { MeshInfo meshes[]; };
+layout(std430, binding = 2) readonly buffer LodBuffer { Lod lods[]; };
+layout(std430, binding = 3) readonly buffer BatchBuffer { uint batchOffsets[]; };
+layout(std430, binding = 4) writeonly buffer CommandBuffer { DrawCommand commands[]; };
+layout(std430, binding = 5) buffer CountBuffer { uint drawCounts[]; };
+
+uniform vec4 frustumPlanes[6];
+uniform vec3 cameraPosition;
+uniform uint instanceCount;
+uniform bool occlusionCulling;
+
+bool frustumVisible(vec3 bmin, vec3 bmax) {
+    for (int i = 0; i < 6; i++) {
+        vec4 plane = frustumPlanes[i];
+        vec3 positive = mix(bmin, bmax, greaterThanEqual(plane.xyz, vec3(0.0)));
+        if (dot(plane.xyz, positive) + plane.w < 0.0) return false;
+    }
+    return true;
+}
+
+void main()
+{
+    uint id = gl_GlobalInvocationID.x;
+    if (id >= instanceCount) return;
+
+    Instance instance = instances[id];
+    vec3 bmin = instance.boundsMin.xyz;
+    vec3 bmax = instance.boundsMax.xyz;
+    if (!frustumVisible(bmin, bmax)) return;
+    if (occlusionCulling && hizOccluded(bmin, bmax)) return;
+
+    // 按包围盒中心到相机的距离选择LOD, 最后一级没有距离上限
+    MeshInfo mesh = meshes[instance.info.x];
+    float distanceToCamera = distance(cameraPosition, (bmin + bmax) * 0.5);
+    uint lodIndex = mesh.lodFirst + mesh.lodCount - 1u;
+    for (uint i = 0u; i + 1u < mesh.lodCount; i++) {
+        if (distanceToCamera <= lods[mesh.lodFirst + i].maxDistance) {
+            lodIndex = mesh.lodFirst + i;
+            break;
+        }
+    }
+    Lod lod = lods[lodIndex];
+
+    uint slot = atomicAdd(drawCounts[mesh.batch], 1u);
+    // baseInstance经恒等实例属性传给顶点着色器, 用作实例数组下标
+    commands[batchOffsets[mesh.batch] + slot] = DrawCommand(lod.indexCount, 1u, lod.firstIndex, lod.baseVertex, id);
+}
+)"
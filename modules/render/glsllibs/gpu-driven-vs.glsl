@@ -0,0 +1,34 @@
+R"(
+#version 430 core
+layout (location = 0) in vec3 aPos;
+layout (location = 1) in vec3 aNormal;
+layout (location = 2) in vec2 aTexCoords;
+layout (location = 3) in uint aInstanceIndex; // 恒等缓冲区, 值等于绘制命令的baseInstance
+
+struct Instance {
+    mat4 model;
+    mat4 normalMatrix;
+    vec4 boundsMin;
+    vec4 boundsMax;
+    uvec4 info;
+};
+
+layout(std430, binding = 0) readonly buffer InstanceBuffer { Instance instances[]; };
+
+out vec2 TexCoords;
+out vec3 normal;
+out vec3 fragPos;
+
+uniform mat4 view;
+uniform mat4 projection;
+
+void main()
+{
+    mat4 model = instances[aInstanceIndex].model;
+    vec4 worldPos = model * vec4(aPos, 1.0);
+    gl_Position = projection * view * worldPos;
+    normal = normalize(mat3(instances[aInstanceIndex].normalMatrix) * aNormal);
+    fragPos = worldPos.xyz;
+    TexCoords = aTexCoords;
+}
+)"
@@ -0,0 +1,18 @@
+R"(
+#version 430 core
+layout(local_size_x = 8, local_size_y = 8) in;
+
+uniform sampler2D depthTexture;
+// 深度纹理有效区域与金字塔第0层的尺寸之比
+uniform vec2 sourceScale;
+layout(rg32f, binding = 0) writeonly uniform image2D dstLevel;
+
+// 金字塔第0层: r = 最小深度, g = 最大深度
+void main()
+{
+    ivec2 coord = ivec2(gl_GlobalInvocationID.xy);
+    if (any(greaterThanEqual(coord, imageSize(dstLevel)))) return;
+    float depth = texelFetch(depthTexture, ivec2((vec2(coord) + 0.5) * sourceScale), 0).r;
+    imageStore(dstLevel, coord, vec4(depth, depth, 0.0, 0.0));
+}
+)"
@@ -0,0 +1,26 @@
+R"(
+#version 430 core
+layout(local_size_x = 64) in;
+
+struct Bounds {
+    vec4 minCorner;
+    vec4 maxCorner;
+};
+
+layout(std430, binding = 0) readonly buffer BoundsBuffer {
+    Bounds bounds[];
+};
+
+layout(std430, binding = 1) writeonly buffer VisibilityBuffer {
+    uint visibility[];
+};
+
+uniform uint objectCount;
+
+void main()
+{
+    uint id = gl_GlobalInvocationID.x;
+    if (id >= objectCount) return;
+    visibility[id] = hizOccluded(bounds[id].minCorner.xyz, bounds[id].maxCorner.xyz) ? 0u : 1u;
+}
+)"
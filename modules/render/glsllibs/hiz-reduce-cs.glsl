@@ -0,0 +1,31 @@
+R"(
+#version 430 core
+layout(local_size_x = 8, local_size_y = 8) in;
+
+layout(rg32f, binding = 0) readonly uniform image2D srcLevel;
+layout(rg32f, binding = 1) writeonly uniform image2D dstLevel;
+
+void main()
+{
+    ivec2 coord = ivec2(gl_GlobalInvocationID.xy);
+    ivec2 dstSize = imageSize(dstLevel);
+    if (any(greaterThanEqual(coord, dstSize))) return;
+
+    ivec2 srcSize = imageSize(srcLevel);
+    ivec2 base = coord * 2;
+    // 上一层尺寸为奇数时，最后一行/列需要多读一个纹素，否则会漏掉遮挡信息
+    ivec2 extent = ivec2(2);
+    if ((srcSize.x & 1) != 0 && coord.x == dstSize.x - 1) extent.x = 3;
+    if ((srcSize.y & 1) != 0 && coord.y == dstSize.y - 1) extent.y = 3;
+
+    vec2 result = vec2(1.0, 0.0);
+    for (int y = 0; y < extent.y; y++) {
+        for (int x = 0; x < extent.x; x++) {
+            vec2 texel = imageLoad(srcLevel, min(base + ivec2(x, y), srcSize - 1)).rg;
+            result.x = min(result.x, texel.x);
+            result.y = max(result.y, texel.y);
+        }
+    }
+    imageStore(dstLevel, coord, vec4(result, 0.0, 0.0));
+}
+)"
@@ -0,0 +1,42 @@
+R"(
+uniform sampler2D hizTexture;
+uniform mat4 hizViewProjection; // 构建金字塔时(上一帧)的视图投影矩阵
+uniform vec2 hizSize;
+uniform int hizMipLevels;
+
+// 包围盒是否被Hi-Z金字塔中的深度完全遮挡, 无法判断时返回false
+bool hizOccluded(vec3 bmin, vec3 bmax) {
+    vec2 rectMin = vec2(1.0);
+    vec2 rectMax = vec2(0.0);
+    float nearest = 1.0;
+    for (int i = 0; i < 8; i++) {
+        vec3 corner = vec3((i & 1) != 0 ? bmax.x : bmin.x,
+                           (i & 2) != 0 ? bmax.y : bmin.y,
+                           (i & 4) != 0 ? bmax.z : bmin.z);
+        vec4 clip = hizViewProjection * vec4(corner, 1.0);
+        // 包围盒跨越近平面时无法可靠投影
+        if (clip.w <= 0.0) return false;
+        vec3 ndc = clip.xyz / clip.w;
+        vec2 uv = ndc.xy * 0.5 + 0.5;
+        rectMin = min(rectMin, uv);
+        rectMax = max(rectMax, uv);
+        nearest = min(nearest, ndc.z * 0.5 + 0.5);
+    }
+
+    // 上一帧完全在屏幕外的物体没有遮挡信息(视锥剔除不是这一步的职责)
+    if (any(greaterThan(rectMin, vec2(1.0))) || any(lessThan(rectMax, vec2(0.0)))) return false;
+    rectMin = clamp(rectMin, vec2(0.0), vec2(1.0));
+    rectMax = clamp(rectMax, vec2(0.0), vec2(1.0));
+
+    // 选择一层使得投影矩形最多覆盖2x2个纹素
+    vec2 sizePixels = (rectMax - rectMin) * hizSize;
+    float level = ceil(log2(max(max(sizePixels.x, sizePixels.y), 1.0)));
+    level = clamp(level, 0.0, float(hizMipLevels - 1));
+
+    float farthest = textureLod(hizTexture, rectMin, level).g;
+    farthest = max(farthest, textureLod(hizTexture, vec2(rectMax.x, rectMin.y), level).g);
+    farthest = max(farthest, textureLod(hizTexture, vec2(rectMin.x, rectMax.y), level).g);
+    farthest = max(farthest, textureLod(hizTexture, rectMax, level).g);
+    return nearest > farthest;
+}
+)"
@@ -5,9 +5,12 @@ layout(location = 1) in vec2 aTexCoords;
 
 out vec2 TexCoords;
 
+// 动态分辨率下画面只占纹理左下角的一部分
+uniform vec2 uvScale = vec2(1.0);
+
 void main()
 {
     gl_Position = vec4(aPos, 0.0, 1.0);
-    TexCoords = aTexCoords;
+    TexCoords = aTexCoords * uvScale;
 }
 )"
\ No newline at end of file
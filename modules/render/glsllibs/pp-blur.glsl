@@ -0,0 +1,12 @@
+R"(
+// 可分离高斯模糊的两个方向, 半径由深度决定
+vec4 blurHorizontal(vec2 uv) {
+    int radius = blurRadius(texture(depthTexture, uv).r);
+    return vec4(separableBlur(inputTexture, uv, vec2(texelSize.x, 0.0), radius), 1.0);
+}
+
+vec4 blurVertical(vec2 uv) {
+    int radius = blurRadius(texture(depthTexture, uv).r);
+    return vec4(separableBlur(inputTexture, uv, vec2(0.0, texelSize.y), radius), 1.0);
+}
+)"
@@ -0,0 +1,13 @@
+R"(
+uniform float gradingExposure;
+uniform float gradingContrast;
+uniform float gradingSaturation;
+
+vec4 colorGrading(vec4 color, vec2 uv) {
+    vec3 c = color.rgb * gradingExposure;
+    c = (c - 0.5) * gradingContrast + 0.5;
+    float luma = dot(c, vec3(0.2126, 0.7152, 0.0722));
+    c = mix(vec3(luma), c, gradingSaturation);
+    return vec4(clamp(c, 0.0, 1.0), color.a);
+}
+)"
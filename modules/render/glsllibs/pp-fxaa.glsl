@@ -0,0 +1,130 @@
+R"(
+// FXAA 3.11 quality, 预设12(5步搜索). 在最终的LDR图像上运行, 亮度由颜色计算.
+// 与原版一致, N/W为-y/-x方向, S/E为+y/+x方向
+uniform float fxaaSubpix;            // 亚像素锯齿的去除量, 默认0.75
+uniform float fxaaEdgeThreshold;     // 需要处理的最小局部对比度, 默认0.166
+uniform float fxaaEdgeThresholdMin;  // 暗部不处理的阈值, 默认0.0833
+
+#define FXAA_SEARCH_STEPS 5
+const float fxaaSearchSteps[FXAA_SEARCH_STEPS] = float[](1.0, 1.5, 2.0, 4.0, 12.0);
+
+// 邻域与端点搜索都限制在有效区域(uvMax)以内, 渲染缩放小于1时不读区域外的内容
+float fxaaLuma(vec2 uv) {
+    return dot(textureLod(inputTexture, min(uv, uvMax), 0.0).rgb, vec3(0.299, 0.587, 0.114));
+}
+
+vec4 fxaa(vec2 uv) {
+    vec4 colorM = textureLod(inputTexture, uv, 0.0);
+    float lumaM = dot(colorM.rgb, vec3(0.299, 0.587, 0.114));
+    float lumaS = fxaaLuma(uv + vec2(0.0, texelSize.y));
+    float lumaE = fxaaLuma(uv + vec2(texelSize.x, 0.0));
+    float lumaN = fxaaLuma(uv - vec2(0.0, texelSize.y));
+    float lumaW = fxaaLuma(uv - vec2(texelSize.x, 0.0));
+
+    float rangeMax = max(max(lumaN, lumaW), max(lumaE, max(lumaS, lumaM)));
+    float rangeMin = min(min(lumaN, lumaW), min(lumaE, min(lumaS, lumaM)));
+    float range = rangeMax - rangeMin;
+    // 对比度低的像素(绝大多数)直接返回
+    if (range < max(fxaaEdgeThresholdMin, rangeMax * fxaaEdgeThreshold)) return colorM;
+
+    float lumaNW = fxaaLuma(uv + vec2(-texelSize.x, -texelSize.y));
+    float lumaSE = fxaaLuma(uv + vec2(texelSize.x, texelSize.y));
+    float lumaNE = fxaaLuma(uv + vec2(texelSize.x, -texelSize.y));
+    float lumaSW = fxaaLuma(uv + vec2(-texelSize.x, texelSize.y));
+
+    // 判断边的方向
+    float lumaNS = lumaN + lumaS;
+    float lumaWE = lumaW + lumaE;
+    float subpixRcpRange = 1.0 / range;
+    float subpixNSWE = lumaNS + lumaWE;
+    float edgeHorz1 = -2.0 * lumaM + lumaNS;
+    float edgeVert1 = -2.0 * lumaM + lumaWE;
+    float lumaNESE = lumaNE + lumaSE;
+    float lumaNWNE = lumaNW + lumaNE;
+    float edgeHorz2 = -2.0 * lumaE + lumaNESE;
+    float edgeVert2 = -2.0 * lumaN + lumaNWNE;
+    float lumaNWSW = lumaNW + lumaSW;
+    float lumaSWSE = lumaSW + lumaSE;
+    float edgeHorz4 = abs(edgeHorz1) * 2.0 + abs(edgeHorz2);
+    float edgeVert4 = abs(edgeVert1) * 2.0 + abs(edgeVert2);
+    float edgeHorz3 = -2.0 * lumaW + lumaNWSW;
+    float edgeVert3 = -2.0 * lumaS + lumaSWSE;
+    float edgeHorz = abs(edgeHorz3) + edgeHorz4;
+    float edgeVert = abs(edgeVert3) + edgeVert4;
+
+    float subpixNWSWNESE = lumaNWSW + lumaNESE;
+    float lengthSign = texelSize.x;
+    bool horzSpan = edgeHorz >= edgeVert;
+    float subpixA = subpixNSWE * 2.0 + subpixNWSWNESE;
+    if (!horzSpan) {
+        lumaN = lumaW;
+        lumaS = lumaE;
+    } else {
+        lengthSign = texelSize.y;
+    }
+    float subpixB = subpixA * (1.0 / 12.0) - lumaM;
+
+    // 选择梯度较大的一侧
+    float gradientN = lumaN - lumaM;
+    float gradientS = lumaS - lumaM;
+    float lumaNN = lumaN + lumaM;
+    float lumaSS = lumaS + lumaM;
+    bool pairN = abs(gradientN) >= abs(gradientS);
+    float gradient = max(abs(gradientN), abs(gradientS));
+    if (pairN) lengthSign = -lengthSign;
+    float subpixC = clamp(abs(subpixB) * subpixRcpRange, 0.0, 1.0);
+
+    // 从两像素之间出发, 沿边的两个方向搜索端点
+    vec2 posB = uv;
+    vec2 offNP = horzSpan ? vec2(texelSize.x, 0.0) : vec2(0.0, texelSize.y);
+    if (!horzSpan) posB.x += lengthSign * 0.5;
+    else posB.y += lengthSign * 0.5;
+    vec2 posN = posB - offNP * fxaaSearchSteps[0];
+    vec2 posP = posB + offNP * fxaaSearchSteps[0];
+    float subpixD = -2.0 * subpixC + 3.0;
+    float lumaEndN = fxaaLuma(posN);
+    float subpixE = subpixC * subpixC;
+    float lumaEndP = fxaaLuma(posP);
+
+    if (!pairN) lumaNN = lumaSS;
+    float gradientScaled = gradient * 0.25;
+    float lumaMM = lumaM - lumaNN * 0.5;
+    float subpixF = subpixD * subpixE;
+    bool lumaMLTZero = lumaMM < 0.0;
+
+    lumaEndN -= lumaNN * 0.5;
+    lumaEndP -= lumaNN * 0.5;
+    bool doneN = abs(lumaEndN) >= gradientScaled;
+    bool doneP = abs(lumaEndP) >= gradientScaled;
+    for (int i = 1; i < FXAA_SEARCH_STEPS && !(doneN && doneP); i++) {
+        if (!doneN) {
+            posN -= offNP * fxaaSearchSteps[i];
+            lumaEndN = fxaaLuma(posN) - lumaNN * 0.5;
+            doneN = abs(lumaEndN) >= gradientScaled;
+        }
+        if (!doneP) {
+            posP += offNP * fxaaSearchSteps[i];
+            lumaEndP = fxaaLuma(posP) - lumaNN * 0.5;
+            doneP = abs(lumaEndP) >= gradientScaled;
+        }
+    }
+
+    // 按到较近端点的距离计算偏移, 再与亚像素偏移取较大者
+    float dstN = horzSpan ? uv.x - posN.x : uv.y - posN.y;
+    float dstP = horzSpan ? posP.x - uv.x : posP.y - uv.y;
+    bool goodSpanN = (lumaEndN < 0.0) != lumaMLTZero;
+    bool goodSpanP = (lumaEndP < 0.0) != lumaMLTZero;
+    float spanLengthRcp = 1.0 / (dstP + dstN);
+    bool directionN = dstN < dstP;
+    float dst = min(dstN, dstP);
+    bool goodSpan = directionN ? goodSpanN : goodSpanP;
+    float subpixG = subpixF * subpixF;
+    float pixelOffset = dst * (-spanLengthRcp) + 0.5;
+    float subpixH = subpixG * fxaaSubpix;
+    float pixelOffsetGood = goodSpan ? pixelOffset : 0.0;
+    float pixelOffsetSubpix = max(pixelOffsetGood, subpixH);
+    if (!horzSpan) uv.x += pixelOffsetSubpix * lengthSign;
+    else uv.y += pixelOffsetSubpix * lengthSign;
+    return vec4(textureLod(inputTexture, min(uv, uvMax), 0.0).rgb, colorM.a);
+}
+)"
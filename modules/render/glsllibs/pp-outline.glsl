@@ -0,0 +1,20 @@
+R"(
+uniform float outlineThreshold; // 深度差值阈值
+uniform float outlineOffset;    // 采样间隔(uv)
+
+// 深度不连续处描黑, 只读深度, 对颜色是逐像素的
+vec4 outline(vec4 color, vec2 uv) {
+    float centerDepth = texture(depthTexture, uv).r;
+    // 5x5核的遍历
+    for(int x = -2; x <= 2; x++) {
+        for(int y = -2; y <= 2; y++) {
+            if(x == 0 && y == 0) continue;
+            vec2 samplePos = min(uv + vec2(x, y) * outlineOffset, uvMax);
+            if(texture(depthTexture, samplePos).r - centerDepth > outlineThreshold) {
+                return vec4(0.0, 0.0, 0.0, 1.0);
+            }
+        }
+    }
+    return color;
+}
+)"
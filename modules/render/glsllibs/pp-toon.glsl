@@ -0,0 +1,7 @@
+R"(
+uniform float toonLevels;
+
+vec4 toon(vec4 color, vec2 uv) {
+    return vec4(color_thinning(color.rgb, toonLevels), color.a);
+}
+)"
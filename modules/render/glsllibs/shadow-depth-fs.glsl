@@ -0,0 +1,8 @@
+R"(
+#version 430 core
+
+// 只写深度
+void main()
+{
+}
+)"
@@ -0,0 +1,33 @@
+R"(
+#version 430 core
+out vec4 FragColor;
+in vec2 TexCoords;
+
+uniform sampler2D inputTexture;
+uniform vec2 inputTexelSize;
+uniform vec2 inputUvMax;
+uniform float sharpness;  // 0到1
+
+vec3 fetch(vec2 uv) {
+    return texture(inputTexture, min(uv, inputUvMax)).rgb;
+}
+
+// 对比度自适应锐化: 按十字邻域的动态范围决定锐化强度, 已经很锐利或接近饱和的像素少锐化, 不会产生过冲
+void main()
+{
+    vec2 uv = TexCoords;
+    vec2 t = inputTexelSize;
+    vec3 c = fetch(uv);
+    vec3 n = fetch(uv + vec2(0.0, t.y));
+    vec3 s = fetch(uv - vec2(0.0, t.y));
+    vec3 e = fetch(uv + vec2(t.x, 0.0));
+    vec3 w = fetch(uv - vec2(t.x, 0.0));
+
+    vec3 low = min(c, min(min(n, s), min(e, w)));
+    vec3 high = max(c, max(max(n, s), max(e, w)));
+    vec3 amount = sqrt(clamp(min(low, 1.0 - high) / max(high, 1.0 / 256.0), 0.0, 1.0));
+    vec3 weight = -amount / mix(8.0, 5.0, sharpness);
+    vec3 color = (c + (n + s + e + w) * weight) / (1.0 + 4.0 * weight);
+    FragColor = vec4(clamp(color, 0.0, 1.0), 1.0);
+}
+)"
@@ -0,0 +1,38 @@
+R"(
+#version 430 core
+// SMAA第三步: 按四条边界上的权重与相邻像素混合, 只沿权重较大的方向混合以免过度模糊
+out vec4 FragColor;
+
+uniform sampler2D inputTexture;
+uniform sampler2D blendTexture;
+uniform ivec2 imageExtent;
+
+vec4 weightAt(ivec2 pixel) {
+    if (any(greaterThanEqual(pixel, imageExtent))) return vec4(0.0);
+    return texelFetch(blendTexture, pixel, 0);
+}
+
+vec3 colorAt(ivec2 pixel) {
+    return texelFetch(inputTexture, clamp(pixel, ivec2(0), imageExtent - 1), 0).rgb;
+}
+
+void main()
+{
+    ivec2 pixel = ivec2(gl_FragCoord.xy);
+    vec4 own = weightAt(pixel);
+    float fromBelow = own.x;
+    float fromAbove = weightAt(pixel + ivec2(0, 1)).y;
+    float fromLeft = own.z;
+    float fromRight = weightAt(pixel + ivec2(1, 0)).w;
+    vec3 color = colorAt(pixel);
+
+    if (fromBelow + fromAbove >= fromLeft + fromRight) {
+        color = color * (1.0 - fromBelow - fromAbove)
+              + colorAt(pixel - ivec2(0, 1)) * fromBelow + colorAt(pixel + ivec2(0, 1)) * fromAbove;
+    } else {
+        color = color * (1.0 - fromLeft - fromRight)
+              + colorAt(pixel - ivec2(1, 0)) * fromLeft + colorAt(pixel + ivec2(1, 0)) * fromRight;
+    }
+    FragColor = vec4(color, 1.0);
+}
+)"
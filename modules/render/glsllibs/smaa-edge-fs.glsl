@@ -0,0 +1,36 @@
+R"(
+#version 430 core
+// SMAA第一步: 亮度边缘检测. r为与左侧像素之间的边, g为与下方像素之间的边
+out vec2 edges;
+
+uniform sampler2D inputTexture;
+uniform ivec2 imageExtent;
+uniform float edgeThreshold;
+
+float lumaAt(ivec2 pixel) {
+    vec3 color = texelFetch(inputTexture, clamp(pixel, ivec2(0), imageExtent - 1), 0).rgb;
+    return dot(color, vec3(0.2126, 0.7152, 0.0722));
+}
+
+void main()
+{
+    ivec2 pixel = ivec2(gl_FragCoord.xy);
+    float luma = lumaAt(pixel);
+    float left = lumaAt(pixel + ivec2(-1, 0));
+    float bottom = lumaAt(pixel + ivec2(0, -1));
+    vec2 delta = abs(vec2(luma) - vec2(left, bottom));
+    vec2 found = step(edgeThreshold, delta);
+    // 目标已清零, 没有边的像素不写
+    if (found.x + found.y == 0.0) discard;
+
+    // 局部对比度自适应: 附近有明显更强的边时忽略较弱的边, 避免在纹理细节上产生伪边
+    float right = lumaAt(pixel + ivec2(1, 0));
+    float top = lumaAt(pixel + ivec2(0, 1));
+    float left2 = lumaAt(pixel + ivec2(-2, 0));
+    float bottom2 = lumaAt(pixel + ivec2(0, -2));
+    vec2 maxDelta = max(delta, abs(vec2(luma) - vec2(right, top)));
+    maxDelta = max(maxDelta, abs(vec2(left, bottom) - vec2(left2, bottom2)));
+    float finalDelta = max(maxDelta.x, maxDelta.y);
+    edges = found * step(finalDelta, 2.0 * delta);
+}
+)"
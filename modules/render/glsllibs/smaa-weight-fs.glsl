@@ -0,0 +1,70 @@
+R"(
+#version 430 core
+// SMAA第二步: 沿每条边搜索两端, 由端点处的交叉边判断形状(L, Z, U), 解析地计算覆盖面积.
+// x: 本像素从下方像素混入的量, y: 下方像素从本像素混入的量, z: 本像素从左侧混入的量, w: 左侧从本像素混入的量
+out vec4 weights;
+
+uniform sampler2D edgeTexture;
+uniform ivec2 imageExtent;
+
+#define SMAA_MAX_SEARCH 16
+
+vec2 edgeAt(ivec2 pixel) {
+    if (any(lessThan(pixel, ivec2(0))) || any(greaterThanEqual(pixel, imageExtent))) return vec2(0.0);
+    return texelFetch(edgeTexture, pixel, 0).rg;
+}
+
+// 从pixel沿direction走, 同一条边还能延续多少个像素
+int searchLength(ivec2 pixel, ivec2 direction, int component) {
+    int steps = 0;
+    while (steps < SMAA_MAX_SEARCH && edgeAt(pixel + direction * (steps + 1))[component] != 0.0) steps++;
+    return steps;
+}
+
+// 端点处的交叉边: 在本像素一侧为+0.5, 在另一侧为-0.5, 两侧都有或都没有时为0
+float crossing(float inside, float outside) {
+    return 0.5 * (inside - outside);
+}
+
+// 抗锯齿线在距左端x处的高度, 两端高度为h1, h2, 边长edgeLength; U形拆成两个L形
+float coverage(float h1, float h2, float edgeLength, float x) {
+    if (h1 * h2 > 0.0) {
+        float halfLength = 0.5 * edgeLength;
+        return x < halfLength ? h1 * (1.0 - x / halfLength) : h2 * (x - halfLength) / halfLength;
+    }
+    return mix(h1, h2, x / edgeLength);
+}
+
+void main()
+{
+    ivec2 pixel = ivec2(gl_FragCoord.xy);
+    vec2 edges = texelFetch(edgeTexture, pixel, 0).rg;
+    // 目标已清零, 只有边上的像素需要计算
+    if (edges == vec2(0.0)) discard;
+
+    vec4 result = vec4(0.0);
+    if (edges.g > 0.0) {
+        // 下边界是水平边, 向左右搜索
+        int toLeft = searchLength(pixel, ivec2(-1, 0), 1);
+        int toRight = searchLength(pixel, ivec2(1, 0), 1);
+        ivec2 leftEnd = pixel - ivec2(toLeft, 0);
+        ivec2 rightEnd = pixel + ivec2(toRight + 1, 0);
+        float h1 = crossing(edgeAt(leftEnd).r, edgeAt(leftEnd - ivec2(0, 1)).r);
+        float h2 = crossing(edgeAt(rightEnd).r, edgeAt(rightEnd - ivec2(0, 1)).r);
+        float h = coverage(h1, h2, float(toLeft + toRight + 1), float(toLeft) + 0.5);
+        result.xy = vec2(max(h, 0.0), max(-h, 0.0));
+    }
+    if (edges.r > 0.0) {
+        // 左边界是竖直边, 向上下搜索
+        int toBottom = searchLength(pixel, ivec2(0, -1), 0);
+        int toTop = searchLength(pixel, ivec2(0, 1), 0);
+        ivec2 bottomEnd = pixel - ivec2(0, toBottom);
+        ivec2 topEnd = pixel + ivec2(0, toTop + 1);
+        float h1 = crossing(edgeAt(bottomEnd).g, edgeAt(bottomEnd - ivec2(1, 0)).g);
+        float h2 = crossing(edgeAt(topEnd).g, edgeAt(topEnd - ivec2(1, 0)).g);
+        float h = coverage(h1, h2, float(toBottom + toTop + 1), float(toBottom) + 0.5);
+        result.zw = vec2(max(h, 0.0), max(-h, 0.0));
+    }
+    weights = result;
+}
+)"
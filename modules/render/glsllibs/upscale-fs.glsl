@@ -0,0 +1,68 @@
+R"(
+#version 430 core
+out vec4 FragColor;
+in vec2 TexCoords;
+
+uniform sampler2D inputTexture;
+uniform vec2 inputTexelSize;  // 输入纹理一个像素的uv
+uniform vec2 inputUvMax;      // 输入有效区域最后一个像素中心的uv, 避免读到区域外的旧内容
+
+vec3 fetch(vec2 uv) {
+    return texture(inputTexture, min(uv, inputUvMax)).rgb;
+}
+
+float luma(vec3 color) {
+    return dot(color, vec3(0.299, 0.587, 0.114));
+}
+
+// Catmull-Rom双三次插值, 4x4的16个像素合并成5次双线性采样(省略四个角)
+vec3 catmullRom(vec2 uv) {
+    vec2 position = uv / inputTexelSize - 0.5;
+    vec2 center = floor(position) + 0.5;
+    vec2 f = position + 0.5 - center;
+    vec2 w0 = f * (-0.5 + f * (1.0 - 0.5 * f));
+    vec2 w1 = 1.0 + f * f * (-2.5 + 1.5 * f);
+    vec2 w2 = f * (0.5 + f * (2.0 - 1.5 * f));
+    vec2 w3 = f * f * (-0.5 + 0.5 * f);
+    vec2 w12 = w1 + w2;
+    vec2 uv0 = (center - 1.0) * inputTexelSize;
+    vec2 uv12 = (center + w2 / w12) * inputTexelSize;
+    vec2 uv3 = (center + 2.0) * inputTexelSize;
+    vec3 color = fetch(vec2(uv12.x, uv0.y)) * w12.x * w0.y
+               + fetch(vec2(uv0.x, uv12.y)) * w0.x * w12.y
+               + fetch(uv12) * w12.x * w12.y
+               + fetch(vec2(uv3.x, uv12.y)) * w3.x * w12.y
+               + fetch(vec2(uv12.x, uv3.y)) * w12.x * w3.y;
+    float weight = w12.x * w0.y + w0.x * w12.y + w12.x * w12.y + w3.x * w12.y + w12.x * w3.y;
+    return color / weight;
+}
+
+// 边缘自适应放大: 平坦区域用双三次插值保留细节, 边缘处沿边缘方向平滑以消除放大后的锯齿
+void main()
+{
+    vec2 uv = TexCoords;
+    vec2 t = inputTexelSize;
+    vec3 n = fetch(uv + vec2(0.0, t.y));
+    vec3 s = fetch(uv - vec2(0.0, t.y));
+    vec3 e = fetch(uv + vec2(t.x, 0.0));
+    vec3 w = fetch(uv - vec2(t.x, 0.0));
+    vec3 c = fetch(uv);
+
+    // 亮度梯度, 边缘方向与梯度垂直
+    vec2 gradient = vec2(luma(e) - luma(w), luma(n) - luma(s));
+    float strength = length(gradient);
+    vec3 cubic = catmullRom(uv);
+    if (strength < 1.0 / 64.0) {
+        FragColor = vec4(cubic, 1.0);
+        return;
+    }
+    vec2 along = vec2(-gradient.y, gradient.x) / strength;
+    vec3 directional = 0.5 * c + 0.25 * (fetch(uv + along * t) + fetch(uv - along * t));
+    vec3 color = mix(cubic, directional, clamp(strength * 4.0, 0.0, 1.0));
+
+    // 限制在邻域范围内, 双三次插值在强边缘处不会产生振铃
+    vec3 low = min(c, min(min(n, s), min(e, w)));
+    vec3 high = max(c, max(max(n, s), max(e, w)));
+    FragColor = vec4(clamp(color, low, high), 1.0);
+}
+)"
@@ -0,0 +1,250 @@
+#include "gpu_driven.hpp"
+#include "model/bounds.hpp"
+#include "profile/profile_scope.hpp"
+#include <numeric>
+#include <stdexcept>
+
+namespace lunar {
+
+static const std::string gpu_cull_shader = ShaderProgram::loadGLSLlib(
+    #include "glsllibs/gpu-cull-cs.glsl"
+    ,
+    #include "glsllibs/hiz-test.glsl"
+);
+
+static_assert(sizeof(glm::mat4) == 64 && sizeof(glm::vec4) == 16, "unexpected glm layout");
+
+GpuDrivenRenderer::GpuDrivenRenderer(unsigned int max_instances):
+    cull_shader("", "", gpu_cull_shader), max_instances(max_instances), indirect_count(GLAD_GL_VERSION_4_6) {
+    glGenVertexArrays(1, &VAO);
+    glGenBuffers(1, &VBO);
+    glGenBuffers(1, &EBO);
+    glGenBuffers(1, &instance_index_buffer);
+    glGenBuffers(1, &instance_buffer);
+    glGenBuffers(1, &mesh_buffer);
+    glGenBuffers(1, &lod_buffer);
+    glGenBuffers(1, &batch_buffer);
+    glGenBuffers(1, &command_buffer);
+    glGenBuffers(1, &count_buffer);
+
+    // 恒等实例属性: 第i个实例读到i, 配合baseInstance得到实例下标
+    std::vector<unsigned int> identity(max_instances);
+    std::iota(identity.begin(), identity.end(), 0u);
+
+    glBindVertexArray(VAO);
+    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)0);
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, normal));
+    glEnableVertexAttribArray(2);
+    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, tex_coords));
+
+    glBindBuffer(GL_ARRAY_BUFFER, instance_index_buffer);
+    glBufferData(GL_ARRAY_BUFFER, identity.size() * sizeof(unsigned int), identity.data(), GL_STATIC_DRAW);
+    glEnableVertexAttribArray(3);
+    glVertexAttribIPointer(3, 1, GL_UNSIGNED_INT, sizeof(unsigned int), (void*)0);
+    glVertexAttribDivisor(3, 1);
+    glBindVertexArray(0);
+
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, instance_buffer);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, max_instances * sizeof(GpuInstance), nullptr, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, command_buffer);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, max_instances * sizeof(DrawCommand), nullptr, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+}
+
+GpuDrivenRenderer::~GpuDrivenRenderer() {
+    unsigned int buffers[] = {VBO, EBO, instance_index_buffer, instance_buffer, mesh_buffer,
+                              lod_buffer, batch_buffer, command_buffer, count_buffer};
+    glDeleteBuffers(sizeof(buffers) / sizeof(buffers[0]), buffers);
+    glDeleteVertexArrays(1, &VAO);
+}
+
+unsigned int GpuDrivenRenderer::findOrCreateBatch(const Mesh& mesh) {
+    for (unsigned int i = 0; i < batches.size(); i++) {
+        const Batch& batch = batches[i];
+        if (batch.shininess != mesh.getShininess() || batch.textures.size() != mesh.textures.size()) continue;
+        bool same = true;
+        for (size_t t = 0; t < mesh.textures.size() && same; t++) {
+            same = batch.textures[t].id == mesh.textures[t].id && batch.textures[t].type == mesh.textures[t].type;
+        }
+        if (same) return i;
+    }
+    batches.push_back({.textures = mesh.textures, .shininess = mesh.getShininess()});
+    return static_cast<unsigned int>(batches.size() - 1);
+}
+
+unsigned int GpuDrivenRenderer::addMesh(const std::vector<const Mesh*>& mesh_lods, const std::vector<float>& lod_distances) {
+    if (mesh_lods.empty()) {
+        throw std::runtime_error("Mesh needs at least one LOD");
+    }
+    GpuMeshInfo info{
+        .lod_first = static_cast<unsigned int>(lods.size()),
+        .lod_count = static_cast<unsigned int>(mesh_lods.size()),
+        .batch = findOrCreateBatch(*mesh_lods[0]),
+        .padding = 0
+    };
+    for (size_t i = 0; i < mesh_lods.size(); i++) {
+        const Mesh& mesh = *mesh_lods[i];
+        lods.push_back({
+            .index_count = static_cast<unsigned int>(mesh.indices.size()),
+            .first_index = static_cast<unsigned int>(indices.size()),
+            .base_vertex = static_cast<int>(vertices.size()),
+            .max_distance = i < lod_distances.size() ? lod_distances[i] : 0.0f
+        });
+        vertices.insert(vertices.end(), mesh.vertices.begin(), mesh.vertices.end());
+        indices.insert(indices.end(), mesh.indices.begin(), mesh.indices.end());
+    }
+    meshes.push_back(info);
+    // 剔除使用最精细一级的包围盒
+    mesh_bounds.push_back(mesh_lods[0]->getBounds());
+    geometry_dirty = structure_dirty = true;
+    return static_cast<unsigned int>(meshes.size() - 1);
+}
+
+std::vector<unsigned int> GpuDrivenRenderer::addModel(const Model& model, const glm::mat4& transform) {
+    std::vector<unsigned int> instance_ids;
+    for (const auto& mesh : model.getMeshes()) {
+        instance_ids.push_back(addInstance(addMesh({&mesh}), transform));
+    }
+    return instance_ids;
+}
+
+unsigned int GpuDrivenRenderer::addInstance(unsigned int mesh_id, const glm::mat4& transform) {
+    if (mesh_id >= meshes.size()) {
+        throw std::runtime_error("Unknown mesh id");
+    }
+    if (instances.size() >= max_instances) {
+        throw std::runtime_error("Too many instances for GPU driven renderer");
+    }
+    instances.push_back({.mesh_id = mesh_id});
+    setInstanceTransform(static_cast<unsigned int>(instances.size() - 1), transform);
+    structure_dirty = true;
+    return static_cast<unsigned int>(instances.size() - 1);
+}
+
+void GpuDrivenRenderer::setInstanceTransform(unsigned int instance_id, const glm::mat4& transform) {
+    GpuInstance& instance = instances.at(instance_id);
+    AABB world_bounds = mesh_bounds[instance.mesh_id].transform(transform);
+    instance.model = transform;
+    instance.normal_matrix = glm::mat4(General::getNormalMatrix(transform));
+    instance.bounds_min = glm::vec4(world_bounds.min, 1.0f);
+    instance.bounds_max = glm::vec4(world_bounds.max, 1.0f);
+    instances_dirty = true;
+}
+
+void GpuDrivenRenderer::uploadGeometry() {
+    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(Vertex), vertices.data(), GL_STATIC_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    // 元素缓冲区绑定是VAO状态的一部分
+    glBindVertexArray(VAO);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), indices.data(), GL_STATIC_DRAW);
+    glBindVertexArray(0);
+    geometry_dirty = false;
+}
+
+void GpuDrivenRenderer::uploadStructure() {
+    // 每个批次预留的命令数等于引用它的实例数, 批次在命令缓冲区中连续排列
+    for (auto& batch : batches) batch.capacity = 0;
+    for (const auto& instance : instances) batches[meshes[instance.mesh_id].batch].capacity++;
+    std::vector<unsigned int> offsets(batches.size());
+    unsigned int offset = 0;
+    for (size_t i = 0; i < batches.size(); i++) {
+        batches[i].command_offset = offsets[i] = offset;
+        offset += batches[i].capacity;
+    }
+
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, mesh_buffer);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, meshes.size() * sizeof(GpuMeshInfo), meshes.data(), GL_STATIC_DRAW);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, lod_buffer);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, lods.size() * sizeof(GpuLod), lods.data(), GL_STATIC_DRAW);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, batch_buffer);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, offsets.size() * sizeof(unsigned int), offsets.data(), GL_STATIC_DRAW);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, count_buffer);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, batches.size() * sizeof(unsigned int), nullptr, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+    structure_dirty = false;
+}
+
+void GpuDrivenRenderer::cull(const glm::mat4& view, const glm::mat4& projection, const glm::vec3& camera_position, const HiZBuffer* hiz) {
+    if (instances.empty()) return;
+    if (geometry_dirty) uploadGeometry();
+    if (structure_dirty) uploadStructure();
+    if (instances_dirty) {
+        LUNAR_PROFILE_SCOPE("upload instances");
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, instance_buffer);
+        glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, instances.size() * sizeof(GpuInstance), instances.data());
+        LUNAR_PROFILE_COUNT(Uploads, 1);
+        LUNAR_PROFILE_COUNT(UploadBytes, instances.size() * sizeof(GpuInstance));
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+        instances_dirty = false;
+    }
+
+    const unsigned int zero = 0;
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, count_buffer);
+    glClearBufferData(GL_SHADER_STORAGE_BUFFER, GL_R32UI, GL_RED_INTEGER, GL_UNSIGNED_INT, &zero);
+    if (!indirect_count) {
+        // 没有间接数量时按容量绘制, 未写入的命令必须是instanceCount为0的空命令
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, command_buffer);
+        glClearBufferData(GL_SHADER_STORAGE_BUFFER, GL_R32UI, GL_RED_INTEGER, GL_UNSIGNED_INT, &zero);
+    }
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+    Frustum frustum = Frustum::fromMatrix(projection * view);
+    cull_shader.use();
+    glUniform4fv(glGetUniformLocation(cull_shader.getID(), "frustumPlanes"), 6, &frustum.planes[0].x);
+    cull_shader.setVec3("cameraPosition", camera_position);
+    cull_shader.setUInt("instanceCount", static_cast<unsigned int>(instances.size()));
+    const bool occlusion = hiz != nullptr && hiz->isValid();
+    cull_shader.setInt("occlusionCulling", occlusion);
+    if (occlusion) hiz->bind(cull_shader, 0);
+
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, instance_buffer);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, mesh_buffer);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, lod_buffer);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 3, batch_buffer);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 4, command_buffer);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 5, count_buffer);
+    cull_shader.dispatch((static_cast<unsigned int>(instances.size()) + 63) / 64);
+    glMemoryBarrier(GL_COMMAND_BARRIER_BIT | GL_SHADER_STORAGE_BARRIER_BIT);
+}
+
+void GpuDrivenRenderer::draw(const ShaderProgram& shader) const {
+    if (instances.empty()) return;
+    glUseProgram(shader.getID());
+    glBindVertexArray(VAO);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, instance_buffer);
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, command_buffer);
+    if (indirect_count) glBindBuffer(GL_PARAMETER_BUFFER, count_buffer);
+
+    for (unsigned int b = 0; b < batches.size(); b++) {
+        const Batch& batch = batches[b];
+        if (batch.capacity == 0) continue;
+        // 与Mesh::Draw相同的纹理绑定约定
+        for (unsigned int i = 0; i < batch.textures.size(); i++) {
+            glActiveTexture(GL_TEXTURE0 + i);
+            shader.setInt(batch.textures[i].type == TextureType::Specular ? "material.specular" : "material.diffuse", i);
+            glBindTexture(GL_TEXTURE_2D, batch.textures[i].id);
+        }
+        shader.setFloat("material.shininess", batch.shininess);
+
+        const void* offset = reinterpret_cast<const void*>(static_cast<uintptr_t>(batch.command_offset) * sizeof(DrawCommand));
+        if (indirect_count) {
+            glMultiDrawElementsIndirectCount(GL_TRIANGLES, GL_UNSIGNED_INT, offset,
+                                             static_cast<GLintptr>(b) * sizeof(unsigned int), batch.capacity, 0);
+        } else {
+            glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, offset, batch.capacity, 0);
+        }
+        LUNAR_PROFILE_COUNT(DrawCalls, 1);
+    }
+
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+    if (indirect_count) glBindBuffer(GL_PARAMETER_BUFFER, 0);
+    glBindVertexArray(0);
+}
+
+}
@@ -0,0 +1,97 @@
+#pragma once
+#include "shader.hpp"
+#include "hiz.hpp"
+#include "model/model.hpp"
+#include <glm/glm.hpp>
+#include <map>
+#include <vector>
+
+namespace lunar {
+
+// GPU驱动的绘制: 实例、包围盒与每个网格的绘制参数都放在SSBO中,
+// 一次计算着色器调度完成视锥/遮挡剔除与LOD选择, 并追加间接绘制命令.
+// 每个材质批次只需一次glMultiDrawElementsIndirect(Count), CPU开销与物体数量无关.
+class GpuDrivenRenderer {
+public:
+    explicit GpuDrivenRenderer(unsigned int max_instances = 16384);
+    ~GpuDrivenRenderer();
+    GpuDrivenRenderer(const GpuDrivenRenderer&) = delete;
+    GpuDrivenRenderer& operator=(const GpuDrivenRenderer&) = delete;
+
+    // lods按从精细到粗糙排列, lod_distances[i]为第i级可使用的最远距离, 最后一级没有上限
+    unsigned int addMesh(const std::vector<const Mesh*>& lods, const std::vector<float>& lod_distances = {});
+    // 把模型的每个网格作为单级LOD加入, 并各添加一个实例, 返回实例编号
+    std::vector<unsigned int> addModel(const Model& model, const glm::mat4& transform = glm::mat4(1.0f));
+    unsigned int addInstance(unsigned int mesh_id, const glm::mat4& transform);
+    void setInstanceTransform(unsigned int instance_id, const glm::mat4& transform);
+
+    // hiz为空时只做视锥剔除
+    void cull(const glm::mat4& view, const glm::mat4& projection, const glm::vec3& camera_position, const HiZBuffer* hiz = nullptr);
+    // shader需使用glsllibs/gpu-driven-vs.glsl作为顶点着色器
+    void draw(const ShaderProgram& shader) const;
+
+    [[nodiscard]] unsigned int getInstanceCount() const { return static_cast<unsigned int>(instances.size()); }
+    [[nodiscard]] unsigned int getBatchCount() const { return static_cast<unsigned int>(batches.size()); }
+    // 上下文不支持OpenGL 4.6时退化为固定数量的glMultiDrawElementsIndirect
+    [[nodiscard]] bool hasIndirectCount() const { return indirect_count; }
+
+private:
+    // 与gpu-cull-cs.glsl中的std430布局一致
+    struct GpuInstance {
+        glm::mat4 model{1.0f};
+        glm::mat4 normal_matrix{1.0f};
+        glm::vec4 bounds_min{0.0f};
+        glm::vec4 bounds_max{0.0f};
+        unsigned int mesh_id{0};
+        unsigned int padding[3]{};
+    };
+    struct GpuMeshInfo {
+        unsigned int lod_first;
+        unsigned int lod_count;
+        unsigned int batch;
+        unsigned int padding;
+    };
+    struct GpuLod {
+        unsigned int index_count;
+        unsigned int first_index;
+        int base_vertex;
+        float max_distance;
+    };
+    struct DrawCommand {
+        unsigned int count;
+        unsigned int instance_count;
+        unsigned int first_index;
+        int base_vertex;
+        unsigned int base_instance;
+    };
+    // 共享同一组纹理和高光系数的网格合为一个批次
+    struct Batch {
+        std::vector<Texture> textures;
+        float shininess;
+        unsigned int command_offset{0};
+        unsigned int capacity{0};
+    };
+
+    unsigned int findOrCreateBatch(const Mesh& mesh);
+    void uploadGeometry();
+    void uploadStructure();
+
+    ShaderProgram cull_shader;
+    unsigned int max_instances;
+    bool indirect_count;
+
+    std::vector<Vertex> vertices;
+    std::vector<unsigned int> indices;
+    std::vector<AABB> mesh_bounds;
+    std::vector<GpuMeshInfo> meshes;
+    std::vector<GpuLod> lods;
+    std::vector<Batch> batches;
+    std::vector<GpuInstance> instances;
+
+    bool geometry_dirty{false}, structure_dirty{false}, instances_dirty{false};
+
+    unsigned int VAO, VBO, EBO, instance_index_buffer;
+    unsigned int instance_buffer, mesh_buffer, lod_buffer, batch_buffer, command_buffer, count_buffer;
+};
+
+}
@@ -0,0 +1,196 @@
+#include "hiz.hpp"
+#include "window.hpp"
+#include "profile/profile_scope.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace lunar {
+
+static const std::string hiz_copy_shader =
+#include "glsllibs/hiz-copy-cs.glsl"
+;
+static const std::string hiz_reduce_shader =
+#include "glsllibs/hiz-reduce-cs.glsl"
+;
+static const std::string hiz_cull_shader = ShaderProgram::loadGLSLlib(
+    #include "glsllibs/hiz-cull-cs.glsl"
+    ,
+    #include "glsllibs/hiz-test.glsl"
+);
+
+static unsigned int groupCount(int size, int local_size) {
+    return static_cast<unsigned int>((size + local_size - 1) / local_size);
+}
+
+HiZBuffer::HiZBuffer():copy_shader("", "", hiz_copy_shader), reduce_shader("", "", hiz_reduce_shader) {
+    if (!Window::initialized) {
+        throw std::runtime_error("Window not initialized");
+    }
+    Window& w = Window::getInstance();
+    allocate(w.getWidth(), w.getHeight());
+}
+
+HiZBuffer::~HiZBuffer() {
+    glDeleteTextures(1, &texture);
+}
+
+void HiZBuffer::resize(int width, int height) {
+    // 最小化时窗口尺寸为0, 保持原样
+    if (width <= 0 || height <= 0 || (width == this->width && height == this->height)) return;
+    allocate(width, height);
+}
+
+void HiZBuffer::allocate(int width, int height) {
+    // 纹理存储不可变, 尺寸变化时换一张新的纹理
+    if (texture) glDeleteTextures(1, &texture);
+    this->width = width;
+    this->height = height;
+    mip_levels = static_cast<int>(std::floor(std::log2(std::max(width, height)))) + 1;
+    valid = false;
+
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glTexStorage2D(GL_TEXTURE_2D, mip_levels, GL_RG32F, width, height);
+    // 必须取最近点, 线性过滤会把遮挡深度平均掉
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+void HiZBuffer::build(unsigned int depth_texture, const glm::mat4& view_projection, int source_width, int source_height) {
+    // 源区域比第0层大时点采样会漏掉像素, 最大深度不再保守, 会错误地剔除可见的网格
+    if (source_width > width || source_height > height) {
+        allocate(std::max(width, source_width), std::max(height, source_height));
+    }
+    // 第0层: 从深度纹理拷贝, 尺寸不同时按比例取最近的像素
+    copy_shader.use();
+    copy_shader.setVec2("sourceScale", glm::vec2(
+        static_cast<float>(source_width > 0 ? source_width : width) / static_cast<float>(width),
+        static_cast<float>(source_height > 0 ? source_height : height) / static_cast<float>(height)));
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, depth_texture);
+    copy_shader.setInt("depthTexture", 0);
+    glBindImageTexture(0, texture, 0, GL_FALSE, 0, GL_WRITE_ONLY, GL_RG32F);
+    copy_shader.dispatch(groupCount(width, 8), groupCount(height, 8));
+
+    // 逐层做2x2最小/最大归约
+    reduce_shader.use();
+    int level_width = width, level_height = height;
+    for (int level = 1; level < mip_levels; level++) {
+        level_width = std::max(1, level_width / 2);
+        level_height = std::max(1, level_height / 2);
+        glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
+        glBindImageTexture(0, texture, level - 1, GL_FALSE, 0, GL_READ_ONLY, GL_RG32F);
+        glBindImageTexture(1, texture, level, GL_FALSE, 0, GL_WRITE_ONLY, GL_RG32F);
+        reduce_shader.dispatch(groupCount(level_width, 8), groupCount(level_height, 8));
+    }
+    glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT);
+
+    this->view_projection = view_projection;
+    valid = true;
+}
+
+void HiZBuffer::bind(const ShaderProgram& shader, int texture_unit) const {
+    glActiveTexture(GL_TEXTURE0 + texture_unit);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    shader.setInt("hizTexture", texture_unit);
+    shader.setMat4("hizViewProjection", view_projection);
+    shader.setVec2("hizSize", glm::vec2(static_cast<float>(width), static_cast<float>(height)));
+    shader.setInt("hizMipLevels", mip_levels);
+}
+
+OcclusionCuller::OcclusionCuller(unsigned int max_objects):cull_shader("", "", hiz_cull_shader), max_objects(max_objects) {
+    glGenBuffers(1, &bounds_buffer);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, bounds_buffer);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, max_objects * sizeof(glm::vec4) * 2, nullptr, GL_DYNAMIC_DRAW);
+
+    // 结果缓冲区分为ring_size段, 每帧写一段, CPU读取已经完成的那段
+    const GLbitfield flags = GL_MAP_READ_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+    const GLsizeiptr size = static_cast<GLsizeiptr>(ring_size) * max_objects * sizeof(unsigned int);
+    glGenBuffers(1, &visibility_buffer);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, visibility_buffer);
+    glBufferStorage(GL_SHADER_STORAGE_BUFFER, size, nullptr, flags);
+    mapped_visibility = static_cast<const unsigned int*>(glMapBufferRange(GL_SHADER_STORAGE_BUFFER, 0, size, flags));
+    if (!mapped_visibility) {
+        throw std::runtime_error("Failed to map occlusion visibility buffer");
+    }
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+}
+
+OcclusionCuller::~OcclusionCuller() {
+    for (auto& fence : fences) {
+        if (fence) glDeleteSync(fence);
+    }
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, visibility_buffer);
+    glUnmapBuffer(GL_SHADER_STORAGE_BUFFER);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+    glDeleteBuffers(1, &visibility_buffer);
+    glDeleteBuffers(1, &bounds_buffer);
+}
+
+void OcclusionCuller::cull(const HiZBuffer& hiz, const std::vector<AABB>& bounds) {
+    LUNAR_PROFILE_SCOPE("upload occlusion bounds");
+    if (!hiz.isValid() || bounds.empty()) return;
+    if (bounds.size() > max_objects) {
+        throw std::runtime_error("Too many objects for occlusion culling");
+    }
+
+    std::vector<glm::vec4> packed(bounds.size() * 2);
+    for (size_t i = 0; i < bounds.size(); i++) {
+        packed[i * 2] = glm::vec4(bounds[i].min, 1.0f);
+        packed[i * 2 + 1] = glm::vec4(bounds[i].max, 1.0f);
+    }
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, bounds_buffer);
+    glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, packed.size() * sizeof(glm::vec4), packed.data());
+    LUNAR_PROFILE_COUNT(Uploads, 1);
+    LUNAR_PROFILE_COUNT(UploadBytes, packed.size() * sizeof(glm::vec4));
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+    const unsigned int slot = frame % ring_size;
+    if (fences[slot]) {
+        glDeleteSync(fences[slot]);
+        fences[slot] = nullptr;
+    }
+
+    cull_shader.use();
+    hiz.bind(cull_shader, 0);
+    cull_shader.setUInt("objectCount", static_cast<unsigned int>(bounds.size()));
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, bounds_buffer);
+    glBindBufferRange(GL_SHADER_STORAGE_BUFFER, 1, visibility_buffer,
+                      static_cast<GLintptr>(slot) * max_objects * sizeof(unsigned int),
+                      static_cast<GLsizeiptr>(max_objects) * sizeof(unsigned int));
+    cull_shader.dispatch((static_cast<unsigned int>(bounds.size()) + 63) / 64);
+    glMemoryBarrier(GL_CLIENT_MAPPED_BUFFER_BARRIER_BIT);
+
+    fences[slot] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    object_counts[slot] = static_cast<unsigned int>(bounds.size());
+    frame++;
+}
+
+const std::vector<unsigned char>& OcclusionCuller::getVisibility() {
+    // 从最新提交的一段往回找第一个已完成的结果, 绝不等待GPU
+    for (unsigned int age = 1; age <= ring_size && age <= frame; age++) {
+        const unsigned int slot = (frame - age) % ring_size;
+        if (!fences[slot]) continue;
+        GLenum status = glClientWaitSync(fences[slot], 0, 0);
+        if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED) continue;
+
+        const unsigned int* result = mapped_visibility + static_cast<size_t>(slot) * max_objects;
+        visibility.assign(result, result + object_counts[slot]);
+        // 更旧的结果已经没有意义
+        for (unsigned int older = age; older <= ring_size && older <= frame; older++) {
+            const unsigned int older_slot = (frame - older) % ring_size;
+            if (fences[older_slot]) {
+                glDeleteSync(fences[older_slot]);
+                fences[older_slot] = nullptr;
+            }
+        }
+        break;
+    }
+    return visibility;
+}
+
+}
@@ -0,0 +1,73 @@
+#pragma once
+#include "shader.hpp"
+#include "model/bounds.hpp"
+#include <glm/glm.hpp>
+#include <vector>
+
+namespace lunar {
+
+// 由深度纹理构建的层级深度(Hi-Z)金字塔, 每层保存2x2区域的最小/最大深度
+class HiZBuffer {
+public:
+    HiZBuffer();
+    ~HiZBuffer();
+    HiZBuffer(const HiZBuffer&) = delete;
+    HiZBuffer& operator=(const HiZBuffer&) = delete;
+
+    // 窗口尺寸变化时调用, 尺寸不同时重新分配金字塔, 之前的内容失效
+    void resize(int width, int height);
+    // 在场景绘制完成后调用, view_projection为绘制这张深度图时使用的矩阵.
+    // 场景只画在深度纹理左下角source_width x source_height的区域时(动态分辨率)需要给出该尺寸, 0表示与金字塔同样大小.
+    // 第0层逐像素点采样, 只对不大于金字塔的区域是保守的, 区域更大时先扩大金字塔
+    void build(unsigned int depth_texture, const glm::mat4& view_projection, int source_width = 0, int source_height = 0);
+    // 设置glsllibs/hiz-test.glsl所需的纹理与uniform, shader需要处于使用状态
+    void bind(const ShaderProgram& shader, int texture_unit) const;
+
+    [[nodiscard]] bool isValid() const { return valid; }
+    [[nodiscard]] unsigned int getTexture() const { return texture; }
+    [[nodiscard]] int getMipLevels() const { return mip_levels; }
+    [[nodiscard]] int getWidth() const { return width; }
+    [[nodiscard]] int getHeight() const { return height; }
+    [[nodiscard]] const glm::mat4& getViewProjection() const { return view_projection; }
+
+private:
+    void allocate(int width, int height);
+
+    ShaderProgram copy_shader;
+    ShaderProgram reduce_shader;
+    unsigned int texture{0};
+    int width{0}, height{0};
+    int mip_levels{0};
+    glm::mat4 view_projection{1.0f};
+    bool valid{false};
+};
+
+// 用上一帧的Hi-Z金字塔测试包围盒, 结果经持久映射缓冲区在之后的帧里非阻塞读回
+class OcclusionCuller {
+public:
+    explicit OcclusionCuller(unsigned int max_objects = 4096);
+    ~OcclusionCuller();
+    OcclusionCuller(const OcclusionCuller&) = delete;
+    OcclusionCuller& operator=(const OcclusionCuller&) = delete;
+
+    // bounds的顺序需要在帧之间保持稳定, 结果按同样的下标给出
+    void cull(const HiZBuffer& hiz, const std::vector<AABB>& bounds);
+
+    // 最近一次已完成的剔除结果, 尚无结果时为空(调用方应视为全部可见)
+    [[nodiscard]] const std::vector<unsigned char>& getVisibility();
+
+    static constexpr unsigned int ring_size = 3;
+
+private:
+    ShaderProgram cull_shader;
+    unsigned int max_objects;
+    unsigned int bounds_buffer;
+    unsigned int visibility_buffer;
+    const unsigned int* mapped_visibility{nullptr};
+    GLsync fences[ring_size]{};
+    unsigned int object_counts[ring_size]{};
+    unsigned int frame{0};
+    std::vector<unsigned char> visibility;
+};
+
+}
@@ -0,0 +1,171 @@
+#include "image.hpp"
+#include "stb_image/stb_image.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <utility>
+
+namespace lunar {
+
+Image::Image(int width, int height, std::vector<unsigned char> pixels):
+    width(width), height(height), pixels(std::move(pixels)) {
+    if (this->pixels.size() != static_cast<size_t>(width) * static_cast<size_t>(height) * 4) {
+        throw std::runtime_error("Image data does not match its size");
+    }
+}
+
+void flipRows(std::vector<unsigned char>& pixels, int width, int height) {
+    const size_t row_size = static_cast<size_t>(width) * 4;
+    std::vector<unsigned char> row(row_size);
+    for (int y = 0; y < height / 2; y++) {
+        unsigned char* top = pixels.data() + static_cast<size_t>(y) * row_size;
+        unsigned char* bottom = pixels.data() + static_cast<size_t>(height - 1 - y) * row_size;
+        std::memcpy(row.data(), top, row_size);
+        std::memcpy(top, bottom, row_size);
+        std::memcpy(bottom, row.data(), row_size);
+    }
+}
+
+static uint32_t crc32(const unsigned char* data, size_t size, uint32_t crc = 0) {
+    static const std::array<uint32_t, 256> table = [] {
+        std::array<uint32_t, 256> result{};
+        for (uint32_t n = 0; n < 256; n++) {
+            uint32_t c = n;
+            for (int k = 0; k < 8; k++) c = (c & 1) ? 0xedb88320u ^ (c >> 1) : c >> 1;
+            result[n] = c;
+        }
+        return result;
+    }();
+    crc = ~crc;
+    for (size_t i = 0; i < size; i++) crc = table[(crc ^ data[i]) & 0xff] ^ (crc >> 8);
+    return ~crc;
+}
+
+static void appendBigEndian(std::vector<unsigned char>& out, uint32_t value) {
+    out.push_back(static_cast<unsigned char>(value >> 24));
+    out.push_back(static_cast<unsigned char>(value >> 16));
+    out.push_back(static_cast<unsigned char>(value >> 8));
+    out.push_back(static_cast<unsigned char>(value));
+}
+
+static void writeChunk(std::ofstream& file, const char type[4], const std::vector<unsigned char>& data) {
+    std::vector<unsigned char> chunk;
+    chunk.reserve(data.size() + 12);
+    appendBigEndian(chunk, static_cast<uint32_t>(data.size()));
+    chunk.insert(chunk.end(), type, type + 4);
+    chunk.insert(chunk.end(), data.begin(), data.end());
+    // CRC覆盖类型与数据, 不包括长度
+    appendBigEndian(chunk, crc32(chunk.data() + 4, chunk.size() - 4));
+    file.write(reinterpret_cast<const char*>(chunk.data()), static_cast<std::streamsize>(chunk.size()));
+}
+
+bool writePNG(const std::string& path, const Image& image) {
+    if (image.empty()) return false;
+    std::ofstream file(path, std::ios::binary);
+    if (!file) return false;
+    static const unsigned char signature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n'};
+    file.write(reinterpret_cast<const char*>(signature), sizeof(signature));
+
+    std::vector<unsigned char> header;
+    appendBigEndian(header, static_cast<uint32_t>(image.width));
+    appendBigEndian(header, static_cast<uint32_t>(image.height));
+    // 8位, RGBA, deflate, 自适应滤波, 不隔行
+    header.insert(header.end(), {8, 6, 0, 0, 0});
+    writeChunk(file, "IHDR", header);
+
+    // 每行前面加一个滤波类型字节(0, 不滤波), 整体作为zlib流写入不压缩的块
+    const size_t row_size = static_cast<size_t>(image.width) * 4;
+    std::vector<unsigned char> raw;
+    raw.reserve((row_size + 1) * static_cast<size_t>(image.height));
+    for (int y = 0; y < image.height; y++) {
+        raw.push_back(0);
+        const auto row = image.pixels.begin() + static_cast<std::ptrdiff_t>(row_size * static_cast<size_t>(y));
+        raw.insert(raw.end(), row, row + static_cast<std::ptrdiff_t>(row_size));
+    }
+    std::vector<unsigned char> compressed = {0x78, 0x01};
+    compressed.reserve(raw.size() + raw.size() / 65535 * 5 + 16);
+    constexpr size_t max_block = 65535;
+    for (size_t offset = 0;; offset += max_block) {
+        const size_t size = std::min(max_block, raw.size() - offset);
+        const bool last = offset + size >= raw.size();
+        compressed.push_back(last ? 1 : 0);
+        compressed.push_back(static_cast<unsigned char>(size & 0xff));
+        compressed.push_back(static_cast<unsigned char>(size >> 8));
+        compressed.push_back(static_cast<unsigned char>(~size & 0xff));
+        compressed.push_back(static_cast<unsigned char>((~size >> 8) & 0xff));
+        compressed.insert(compressed.end(), raw.begin() + static_cast<std::ptrdiff_t>(offset),
+                          raw.begin() + static_cast<std::ptrdiff_t>(offset + size));
+        if (last) break;
+    }
+    uint32_t a = 1, b = 0;
+    for (unsigned char c : raw) {
+        a = (a + c) % 65521;
+        b = (b + a) % 65521;
+    }
+    appendBigEndian(compressed, (b << 16) | a);
+    writeChunk(file, "IDAT", compressed);
+    writeChunk(file, "IEND", {});
+    return static_cast<bool>(file);
+}
+
+Image loadImage(const std::string& path) {
+    int width, height, channels;
+    stbi_set_flip_vertically_on_load(false);
+    unsigned char* data = stbi_load(path.c_str(), &width, &height, &channels, 4);
+    if (!data) {
+        throw std::runtime_error("Failed to load image: " + path);
+    }
+    Image image(width, height, std::vector<unsigned char>(data, data + static_cast<size_t>(width) * height * 4));
+    stbi_image_free(data);
+    return image;
+}
+
+// 半透明的像素先混合到白色背景上
+static void blendToWhite(const unsigned char* pixel, float rgb[3]) {
+    const float alpha = pixel[3] / 255.0f;
+    for (int i = 0; i < 3; i++) rgb[i] = 255.0f + (pixel[i] - 255.0f) * alpha;
+}
+
+ImageDiff compareImages(const Image& expected, const Image& actual, float threshold) {
+    if (expected.width != actual.width || expected.height != actual.height) {
+        throw std::runtime_error("Cannot compare images of different sizes");
+    }
+    // Kotsarenko & Ramos的YIQ色差, 黑与白之差为35215
+    constexpr float max_yiq_delta = 35215.0f;
+    ImageDiff result;
+    result.diff = Image(expected.width, expected.height, std::vector<unsigned char>(expected.pixels.size()));
+    double delta_sum = 0.0;
+    const size_t pixel_count = static_cast<size_t>(expected.width) * static_cast<size_t>(expected.height);
+    for (size_t i = 0; i < pixel_count; i++) {
+        float a[3], b[3];
+        blendToWhite(&expected.pixels[i * 4], a);
+        blendToWhite(&actual.pixels[i * 4], b);
+        const float dr = a[0] - b[0], dg = a[1] - b[1], db = a[2] - b[2];
+        const float y = dr * 0.29889531f + dg * 0.58662247f + db * 0.11448223f;
+        const float in_phase = dr * 0.59597799f - dg * 0.27417610f - db * 0.32180189f;
+        const float quadrature = dr * 0.21147017f - dg * 0.52261711f + db * 0.31114694f;
+        const float yiq = 0.5053f * y * y + 0.299f * in_phase * in_phase + 0.1957f * quadrature * quadrature;
+        const float delta = std::sqrt(std::min(yiq / max_yiq_delta, 1.0f));
+        delta_sum += delta;
+        result.max_delta = std::max(result.max_delta, delta);
+
+        unsigned char* out = &result.diff.pixels[i * 4];
+        if (delta > threshold) {
+            result.different_pixels++;
+            out[0] = 255;
+            out[1] = out[2] = 0;
+        } else {
+            const float gray = (a[0] * 0.29889531f + a[1] * 0.58662247f + a[2] * 0.11448223f) * 0.25f;
+            out[0] = out[1] = out[2] = static_cast<unsigned char>(gray);
+        }
+        out[3] = 255;
+    }
+    result.mean_delta = pixel_count ? static_cast<float>(delta_sum / static_cast<double>(pixel_count)) : 0.0f;
+    return result;
+}
+
+}
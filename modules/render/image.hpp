@@ -0,0 +1,43 @@
+#pragma once
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace lunar {
+
+// RGBA8图像, 第一行为图像顶部(与Window::readPixels一致)
+struct Image {
+    int width{0}, height{0};
+    std::vector<unsigned char> pixels;
+
+    Image() = default;
+    Image(int width, int height, std::vector<unsigned char> pixels);
+    [[nodiscard]] bool empty() const { return pixels.empty(); }
+};
+
+// 上下翻转RGBA8像素, 把GL读回的数据(第一行在底部)转为第一行在顶部
+void flipRows(std::vector<unsigned char>& pixels, int width, int height);
+
+// 写出PNG. 数据用不压缩的deflate块存储, 不依赖zlib, 写出很快但文件较大; 失败时返回false
+bool writePNG(const std::string& path, const Image& image);
+// 读取stb_image支持的格式并转为RGBA8, 失败时抛出异常
+Image loadImage(const std::string& path);
+
+struct ImageDiff {
+    size_t different_pixels{0};
+    // YIQ色差, 0为相同, 1为黑白之差
+    float max_delta{0.0f};
+    float mean_delta{0.0f};
+    // 相同的像素为变暗的灰度, 不同的像素为红色, 便于查看
+    Image diff;
+
+    [[nodiscard]] float getDifferentRatio(size_t pixel_count) const {
+        return pixel_count ? static_cast<float>(different_pixels) / static_cast<float>(pixel_count) : 0.0f;
+    }
+};
+
+// 按感知的色差比较两幅同样大小的图像, 色差超过threshold(0到1)的像素计为不同.
+// 色差在YIQ空间中计算, 亮度的权重最高, 与人眼的敏感程度接近; 尺寸不同时抛出异常
+ImageDiff compareImages(const Image& expected, const Image& actual, float threshold = 0.1f);
+
+}
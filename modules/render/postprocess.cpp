@@ -1,96 +1,159 @@
 #include "postprocess.hpp"
 #include "shader.hpp"
 #include "window.hpp"
+#include <algorithm>
+#include <cmath>
 #include <stdexcept>
 #include <iostream>
 
 namespace lunar {
 
-static const std::string postprocess_vertex_shader = 
-#include "glsllibs/postprocess-vs.glsl"
-;
-static std::string postprocess_fragment_shader = ShaderProgram::loadGLSLlib(
-    #include "glsllibs/postprocess-fs.glsl"
-    ,
-    #include "glsllibs/3shade2.glsl"
-);
-
-PostProcesser::PostProcesser():shader(postprocess_vertex_shader, postprocess_fragment_shader) {
+PostProcesser::PostProcesser(BlurMode blur_mode): blur_mode(blur_mode) {
     if (!Window::initialized) {
         throw std::runtime_error("Window not initialized");
     }
     Window& w = Window::getInstance();
+    width = w.getWidth();
+    height = w.getHeight();
     
     // 创建帧缓冲
     glGenFramebuffers(1, &framebuffer);
-    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
 
     // 创建颜色纹理
     glGenTextures(1, &colorTexture);
     glBindTexture(GL_TEXTURE_2D, colorTexture);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, w.getWidth(), w.getHeight(), 0, GL_RGB, GL_UNSIGNED_BYTE, NULL);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    // 模糊依靠双线性过滤一次采样两个像素
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, colorTexture, 0);
 
     // 创建深度纹理
     glGenTextures(1, &depthTexture);
     glBindTexture(GL_TEXTURE_2D, depthTexture);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT24, w.getWidth(), w.getHeight(), 0, GL_DEPTH_COMPONENT, GL_FLOAT, NULL);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
     float borderColor[] = { 1.0f, 1.0f, 1.0f, 1.0f };
     glTexParameterfv(GL_TEXTURE_2D, GL_TEXTURE_BORDER_COLOR, borderColor);
-    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, depthTexture, 0);
 
+    allocate(width, height);
+    updateRenderSize();
+
+    // 默认效果: 随深度变化的高斯模糊加描边, 描边是逐像素的, 会合并进竖直模糊
+    if (blur_mode == BlurMode::Compute) {
+        chain.addPass(PostProcessChain::createBuiltinPass("blur_compute"));
+    } else {
+        chain.addPass(PostProcessChain::createBuiltinPass("blur_horizontal"));
+        chain.addPass(PostProcessChain::createBuiltinPass("blur_vertical"));
+    }
+    chain.addPass(PostProcessChain::createBuiltinPass("outline"));
+}
+
+void PostProcesser::configure(const std::vector<PostProcessPassConfig>& passes) {
+    if (passes.empty()) return;
+    chain.clear();
+    for (const auto& pass : passes) {
+        chain.addPass(PostProcessChain::createBuiltinPass(pass.name, pass.params));
+        chain.setEnabled(pass.name, pass.enabled);
+    }
+}
+
+// 纹理对象不变, 只重新指定存储, 帧缓冲与其他地方持有的纹理名字都继续有效
+void PostProcesser::allocate(int texture_width, int texture_height) {
+    this->texture_width = texture_width;
+    this->texture_height = texture_height;
+    glBindTexture(GL_TEXTURE_2D, colorTexture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, texture_width, texture_height, 0, GL_RGB, GL_UNSIGNED_BYTE, NULL);
+    glBindTexture(GL_TEXTURE_2D, depthTexture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT24, texture_width, texture_height, 0, GL_DEPTH_COMPONENT, GL_FLOAT, NULL);
+    LUNAR_PROFILE_COUNT(Allocations, 2);
+    LUNAR_PROFILE_COUNT(AllocatedBytes, static_cast<uint64_t>(texture_width) * texture_height * (3 + 4));
+
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, colorTexture, 0);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, depthTexture, 0);
     // 检查帧缓冲是否完整
-    if(glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
         throw std::runtime_error("Framebuffer is not complete");
     }
-
-    // 解绑
     glBindFramebuffer(GL_FRAMEBUFFER, 0);
     glBindTexture(GL_TEXTURE_2D, 0);
 
-    shader.setVertices<4>({
-        {-1.0f,  1.0f,  0.0f, 1.0f},
-        {-1.0f, -1.0f,  0.0f, 0.0f},
-        { 1.0f, -1.0f,  1.0f, 0.0f},
-        {-1.0f,  1.0f,  0.0f, 1.0f},
-        { 1.0f, -1.0f,  1.0f, 0.0f},
-        { 1.0f,  1.0f,  1.0f, 1.0f}
-    });
-    shader.setVertexDataProperty({"position", "TexCoords"}, {2, 2});
-    shader.setIndices({0, 1, 2, 3, 4, 5});
+    // 池里旧尺寸的中间目标不会再被用到
+    chain.getPool().trim();
+    allocation_count++;
+}
+
+void PostProcesser::updateRenderSize() {
+    render_width = std::clamp(static_cast<int>(std::lround(static_cast<float>(width) * render_scale)), 1, width);
+    render_height = std::clamp(static_cast<int>(std::lround(static_cast<float>(height) * render_scale)), 1, height);
+}
+
+void PostProcesser::resize(int width, int height) {
+    // 最小化时窗口尺寸为0, 保持原样
+    if (width <= 0 || height <= 0 || (width == this->width && height == this->height)) return;
+    this->width = width;
+    this->height = height;
+    const bool grow = width > texture_width || height > texture_height;
+    const bool shrink = 2 * static_cast<long long>(width) * height < static_cast<long long>(texture_width) * texture_height;
+    if (grow || shrink) {
+        auto align = [](int size) { return (size + 63) / 64 * 64; };
+        allocate(grow ? std::max(align(width), texture_width) : align(width),
+                 grow ? std::max(align(height), texture_height) : align(height));
+    }
+    updateRenderSize();
+}
+
+void PostProcesser::setRenderScale(float scale) {
+    render_scale = std::clamp(scale, 0.01f, 1.0f);
+    updateRenderSize();
+}
+
+void PostProcesser::setAntiAliasing(AntiAliasing mode) {
+    chain.removePass("fxaa");
+    chain.removePass("smaa");
+    if (mode == AntiAliasing::FXAA) chain.addPass(PostProcessChain::createBuiltinPass("fxaa"));
+    else if (mode == AntiAliasing::SMAA) chain.addPass(PostProcessChain::createBuiltinPass("smaa"));
 }
 
 void PostProcesser::tobeDrawn() {
     glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    glViewport(0, 0, render_width, render_height);
     glEnable(GL_DEPTH_TEST);
     glClearColor(1.0f, 1.0f, 1.0f, 1.0f);
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 }
 
 void PostProcesser::toDraw() {
-    shader.use();
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
     glDisable(GL_DEPTH_TEST);
-    glClearColor(1.0f, 1.0f, 1.0f, 1.0f);
-    glClear(GL_COLOR_BUFFER_BIT);
-    
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, colorTexture);
-    shader.setInt("screenTexture", 0);
-    
-    glActiveTexture(GL_TEXTURE1);
-    glBindTexture(GL_TEXTURE_2D, depthTexture);
-    shader.setInt("depthTexture", 1);
 }
 
 void PostProcesser::draw() {
-    shader.draw();
+    const TextureExtent extent = getExtent();
+    // 窗口模式为默认帧缓冲, 无头模式为Window的离屏帧缓冲
+    const GLuint output = Window::getInstance().getFramebuffer();
+    if (render_width == width && render_height == height) {
+        chain.execute(colorTexture, depthTexture, extent, output);
+        return;
+    }
+    // 后处理在渲染分辨率下进行, 结果再放大到窗口
+    RenderTarget resolved = chain.getPool().acquire(GL_RGBA8, texture_width, texture_height);
+    chain.execute(colorTexture, depthTexture, extent, resolved.framebuffer);
+    upscaler.upscale(resolved.texture, extent, output, width, height, chain.getPool());
+    chain.getPool().release(resolved);
+}
+
+void PostProcesser::addPasses(RenderGraph& graph, RenderResource scene_color, RenderResource scene_depth, RenderResource output) {
+    const TextureExtent extent = getExtent();
+    if (render_width == width && render_height == height) {
+        chain.addPasses(graph, scene_color, scene_depth, extent, output);
+        return;
+    }
+    const RenderResource resolved = graph.createTexture("post_resolved", {GL_RGBA8, texture_width, texture_height});
+    chain.addPasses(graph, scene_color, scene_depth, extent, resolved);
+    upscaler.addPasses(graph, resolved, extent, output, width, height);
 }
 
 }
\ No newline at end of file
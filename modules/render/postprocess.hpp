@@ -1,21 +1,68 @@
 #pragma once
 #include "shader.hpp"
+#include "postprocess_chain.hpp"
+#include "upscaler.hpp"
+#include "settings.hpp"
+#include <vector>
 namespace lunar {
+
+// 默认模糊的实现方式: 两遍片段着色器, 或使用共享内存分块的计算着色器
+enum class BlurMode {
+    Fragment,
+    Compute
+};
+
+// 场景先绘制到这里的颜色与深度纹理, 再经过后处理链输出到屏幕.
+// 渲染分辨率可以低于窗口分辨率: 场景只画在纹理左下角, 后处理之后由SpatialUpscaler放大到窗口.
 class PostProcesser {
 public:
-    PostProcesser();
+    explicit PostProcesser(BlurMode blur_mode = BlurMode::Fragment);
+    // 用配置中的内置pass替换默认的后处理链, 为空时保持默认
+    void configure(const std::vector<PostProcessPassConfig>& passes);
+    // 在链的末尾, 也就是最终的LDR图像上做抗锯齿; 替换之前设置的模式
+    void setAntiAliasing(AntiAliasing mode);
     void tobeDrawn();
     void toDraw();
     void draw();
+    // 与draw相同, 但后处理链与放大都作为帧图中的pass, 中间结果是图的临时纹理; scene_color与scene_depth是导入的
+    // getColorTexture()与getDepthTexture(), output是窗口的帧缓冲
+    void addPasses(RenderGraph& graph, RenderResource scene_color, RenderResource scene_depth, RenderResource output);
+
+    // 输出(窗口)尺寸变化时调用, 尺寸不变时什么也不做.
+    // 纹理按64像素对齐增长, 缩小到面积的一半以下才重新分配, 拖动窗口边框时不会每帧都重新分配; 纹理对象保持不变
+    void resize(int width, int height);
+    // 渲染分辨率相对输出的比例, 限制在(0, 1]
+    void setRenderScale(float scale);
+    [[nodiscard]] float getRenderScale() const { return render_scale; }
+    [[nodiscard]] int getRenderWidth() const { return render_width; }
+    [[nodiscard]] int getRenderHeight() const { return render_height; }
+    [[nodiscard]] int getWidth() const { return width; }
+    [[nodiscard]] int getHeight() const { return height; }
+    [[nodiscard]] TextureExtent getExtent() const { return {render_width, render_height, texture_width, texture_height}; }
+    // 纹理重新分配的次数, 依赖这些纹理尺寸的对象据此跟着重新分配
+    [[nodiscard]] unsigned int getAllocationCount() const { return allocation_count; }
+
+    [[nodiscard]] unsigned int getFramebuffer() const { return framebuffer; }
+    [[nodiscard]] unsigned int getColorTexture() const { return colorTexture; }
+    [[nodiscard]] unsigned int getDepthTexture() const { return depthTexture; }
+    [[nodiscard]] BlurMode getBlurMode() const { return blur_mode; }
+    [[nodiscard]] PostProcessChain& getChain() { return chain; }
+    [[nodiscard]] SpatialUpscaler& getUpscaler() { return upscaler; }
 private:
-    ShaderProgram shader;
+    void allocate(int texture_width, int texture_height);
+    void updateRenderSize();
+
+    PostProcessChain chain;
+    SpatialUpscaler upscaler;
+    BlurMode blur_mode;
     unsigned int framebuffer;
     unsigned int colorTexture;
     unsigned int depthTexture;
-    unsigned int renderbuffer;
+    int width, height;
+    int texture_width{0}, texture_height{0};
+    int render_width, render_height;
+    float render_scale{1.0f};
+    unsigned int allocation_count{0};
 };
 
 }
-
-
-
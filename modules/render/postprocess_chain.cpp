@@ -0,0 +1,433 @@
+#include "postprocess_chain.hpp"
+#include <glm/glm.hpp>
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace lunar {
+
+static const std::string chain_vertex_shader =
+#include "glsllibs/postprocess-vs.glsl"
+;
+static const std::string blur_kernel_lib =
+#include "glsllibs/blur-kernel.glsl"
+;
+static const std::string toon_lib =
+#include "glsllibs/3shade2.glsl"
+;
+static const std::string blur_pass_source =
+#include "glsllibs/pp-blur.glsl"
+;
+static const std::string outline_pass_source =
+#include "glsllibs/pp-outline.glsl"
+;
+static const std::string toon_pass_source =
+#include "glsllibs/pp-toon.glsl"
+;
+static const std::string color_grading_pass_source =
+#include "glsllibs/pp-color-grading.glsl"
+;
+static const std::string fxaa_pass_source =
+#include "glsllibs/pp-fxaa.glsl"
+;
+static const std::string smaa_edge_shader =
+#include "glsllibs/smaa-edge-fs.glsl"
+;
+static const std::string smaa_weight_shader =
+#include "glsllibs/smaa-weight-fs.glsl"
+;
+static const std::string smaa_blend_shader =
+#include "glsllibs/smaa-blend-fs.glsl"
+;
+static const std::string blur_compute_shader_code = ShaderProgram::loadGLSLlib(
+    #include "glsllibs/blur-cs.glsl"
+    ,
+    blur_kernel_lib
+);
+
+// 与blur-kernel.glsl中的宏一致
+static constexpr int max_blur_radius = 5;
+static constexpr int blur_tap_stride = 4;
+static constexpr int blur_group_size = 128;
+
+static float getParam(const std::map<std::string, float>& params, const std::string& key, float fallback) {
+    auto it = params.find(key);
+    return it == params.end() ? fallback : it->second;
+}
+
+static std::unique_ptr<ShaderProgram> createFullscreenProgram(const std::string& fragment_shader) {
+    auto program = std::make_unique<ShaderProgram>(chain_vertex_shader, fragment_shader);
+    program->setVertices<4>({
+        {-1.0f,  1.0f,  0.0f, 1.0f},
+        {-1.0f, -1.0f,  0.0f, 0.0f},
+        { 1.0f, -1.0f,  1.0f, 0.0f},
+        {-1.0f,  1.0f,  0.0f, 1.0f},
+        { 1.0f, -1.0f,  1.0f, 0.0f},
+        { 1.0f,  1.0f,  1.0f, 1.0f}
+    });
+    program->setVertexDataProperty({"position", "TexCoords"}, {2, 2});
+    program->setIndices({0, 1, 2, 3, 4, 5});
+    return program;
+}
+
+// 按半径预先计算高斯权重并合并相邻的两个像素, 布局与blur-kernel.glsl一致
+static unsigned int createBlurKernelBuffer() {
+    glm::vec4 taps[(max_blur_radius + 1) * blur_tap_stride]{};
+    for (int radius = 0; radius <= max_blur_radius; radius++) {
+        glm::vec4* kernel = taps + radius * blur_tap_stride;
+        if (radius == 0) {
+            kernel[0].x = 1.0f;
+            continue;
+        }
+        // sigma取半径的一半
+        const float sigma = static_cast<float>(radius) / 2.0f;
+        float weights[max_blur_radius + 1];
+        float total = 0.0f;
+        for (int i = 0; i <= radius; i++) {
+            weights[i] = std::exp(-0.5f * static_cast<float>(i * i) / (sigma * sigma));
+            total += i == 0 ? weights[i] : 2.0f * weights[i];
+        }
+        kernel[0].x = weights[0] / total;
+        // 相邻两个像素合成一次双线性采样, 偏移按权重落在两者之间
+        for (int i = 1, tap = 1; i <= radius; i += 2, tap++) {
+            float w1 = weights[i] / total;
+            float w2 = i + 1 <= radius ? weights[i + 1] / total : 0.0f;
+            kernel[tap].x = (static_cast<float>(i) * w1 + static_cast<float>(i + 1) * w2) / (w1 + w2);
+            kernel[tap].y = w1 + w2;
+        }
+    }
+    unsigned int buffer;
+    glGenBuffers(1, &buffer);
+    glBindBuffer(GL_UNIFORM_BUFFER, buffer);
+    glBufferData(GL_UNIFORM_BUFFER, sizeof(taps), taps, GL_STATIC_DRAW);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    return buffer;
+}
+
+PostProcessChain::PostProcessChain(): kernel_buffer(createBlurKernelBuffer()) {}
+
+PostProcessChain::~PostProcessChain() {
+    glDeleteBuffers(1, &kernel_buffer);
+}
+
+void PostProcessChain::addPass(PostProcessPass pass) {
+    if (hasPass(pass.name)) {
+        throw std::runtime_error("Duplicate post process pass: " + pass.name);
+    }
+    if (pass.kind == PostProcessPass::Kind::Custom && !pass.execute) {
+        throw std::runtime_error("Custom post process pass without execute: " + pass.name);
+    }
+    passes.push_back(std::move(pass));
+    dirty = true;
+}
+
+void PostProcessChain::removePass(const std::string& name) {
+    auto it = std::remove_if(passes.begin(), passes.end(), [&](const PostProcessPass& pass) { return pass.name == name; });
+    if (it == passes.end()) return;
+    passes.erase(it, passes.end());
+    dirty = true;
+}
+
+void PostProcessChain::clear() {
+    passes.clear();
+    dirty = true;
+}
+
+void PostProcessChain::setEnabled(const std::string& name, bool enabled) {
+    for (auto& pass : passes) {
+        if (pass.name == name && pass.enabled != enabled) {
+            pass.enabled = enabled;
+            dirty = true;
+        }
+    }
+}
+
+bool PostProcessChain::hasPass(const std::string& name) const {
+    return std::any_of(passes.begin(), passes.end(), [&](const PostProcessPass& pass) { return pass.name == name; });
+}
+
+PostProcessPass PostProcessChain::createBuiltinPass(const std::string& name, const std::map<std::string, float>& params) {
+    PostProcessPass pass;
+    pass.name = name;
+    if (name == "blur_horizontal" || name == "blur_vertical") {
+        pass.kind = PostProcessPass::Kind::Neighborhood;
+        pass.function = name == "blur_horizontal" ? "blurHorizontal" : "blurVertical";
+        pass.source = blur_pass_source;
+    } else if (name == "blur_compute") {
+        pass.kind = PostProcessPass::Kind::Custom;
+        auto shader = std::make_shared<ShaderProgram>("", "", blur_compute_shader_code);
+        pass.execute = [shader](const PostProcessContext& context) {
+            // 水平: 输入 -> 中间目标, 竖直: 中间目标 -> 输出
+            RenderTarget temporary = context.pool.acquire(GL_RGBA8, context.texture_width, context.texture_height);
+            shader->use();
+            glUniform2i(glGetUniformLocation(shader->getID(), "imageExtent"), context.width, context.height);
+            shader->setInt("inputTexture", 0);
+            shader->setInt("depthTexture", 1);
+            shader->setInt("outputImage", 0);
+            glActiveTexture(GL_TEXTURE0);
+            glBindTexture(GL_TEXTURE_2D, context.input_texture);
+            glActiveTexture(GL_TEXTURE1);
+            glBindTexture(GL_TEXTURE_2D, context.depth_texture);
+            glUniform2i(glGetUniformLocation(shader->getID(), "blurAxis"), 1, 0);
+            glBindImageTexture(0, temporary.texture, 0, GL_FALSE, 0, GL_WRITE_ONLY, GL_RGBA8);
+            shader->dispatch((context.width + blur_group_size - 1) / blur_group_size, context.height);
+            glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT);
+
+            glActiveTexture(GL_TEXTURE0);
+            glBindTexture(GL_TEXTURE_2D, temporary.texture);
+            glUniform2i(glGetUniformLocation(shader->getID(), "blurAxis"), 0, 1);
+            glBindImageTexture(0, context.output.texture, 0, GL_FALSE, 0, GL_WRITE_ONLY, GL_RGBA8);
+            shader->dispatch((context.height + blur_group_size - 1) / blur_group_size, context.width);
+            glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT | GL_FRAMEBUFFER_BARRIER_BIT);
+            context.pool.release(temporary);
+        };
+    } else if (name == "outline") {
+        pass.function = "outline";
+        pass.source = outline_pass_source;
+        float threshold = getParam(params, "threshold", 0.04f);
+        float offset = getParam(params, "offset", 1.0f / 800.0f);
+        pass.setup = [threshold, offset](const ShaderProgram& shader) {
+            shader.setFloat("outlineThreshold", threshold);
+            shader.setFloat("outlineOffset", offset);
+        };
+    } else if (name == "toon") {
+        pass.function = "toon";
+        pass.source = toon_pass_source;
+        float levels = getParam(params, "levels", 2.0f);
+        pass.setup = [levels](const ShaderProgram& shader) {
+            shader.setFloat("toonLevels", levels);
+        };
+    } else if (name == "color_grading") {
+        pass.function = "colorGrading";
+        pass.source = color_grading_pass_source;
+        float exposure = getParam(params, "exposure", 1.0f);
+        float contrast = getParam(params, "contrast", 1.0f);
+        float saturation = getParam(params, "saturation", 1.0f);
+        pass.setup = [exposure, contrast, saturation](const ShaderProgram& shader) {
+            shader.setFloat("gradingExposure", exposure);
+            shader.setFloat("gradingContrast", contrast);
+            shader.setFloat("gradingSaturation", saturation);
+        };
+    } else if (name == "fxaa") {
+        pass.kind = PostProcessPass::Kind::Neighborhood;
+        pass.function = "fxaa";
+        pass.source = fxaa_pass_source;
+        float subpix = getParam(params, "subpix", 0.75f);
+        float edge_threshold = getParam(params, "edge_threshold", 0.166f);
+        float edge_threshold_min = getParam(params, "edge_threshold_min", 0.0833f);
+        pass.setup = [subpix, edge_threshold, edge_threshold_min](const ShaderProgram& shader) {
+            shader.setFloat("fxaaSubpix", subpix);
+            shader.setFloat("fxaaEdgeThreshold", edge_threshold);
+            shader.setFloat("fxaaEdgeThresholdMin", edge_threshold_min);
+        };
+    } else if (name == "smaa") {
+        // 边缘检测 -> 混合权重 -> 邻域混合, 前两步只在边上的像素做实际计算
+        pass.kind = PostProcessPass::Kind::Custom;
+        pass.renders_to_framebuffer = true;
+        std::shared_ptr<ShaderProgram> edge_program = createFullscreenProgram(smaa_edge_shader);
+        std::shared_ptr<ShaderProgram> weight_program = createFullscreenProgram(smaa_weight_shader);
+        std::shared_ptr<ShaderProgram> blend_program = createFullscreenProgram(smaa_blend_shader);
+        float threshold = getParam(params, "threshold", 0.1f);
+        pass.execute = [edge_program, weight_program, blend_program, threshold](const PostProcessContext& context) {
+            RenderTarget edges = context.pool.acquire(GL_RG8, context.texture_width, context.texture_height);
+            RenderTarget weights = context.pool.acquire(GL_RGBA8, context.texture_width, context.texture_height);
+            const GLint extent_x = context.width, extent_y = context.height;
+            glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+
+            glBindFramebuffer(GL_FRAMEBUFFER, edges.framebuffer);
+            glClear(GL_COLOR_BUFFER_BIT);
+            edge_program->use();
+            glActiveTexture(GL_TEXTURE0);
+            glBindTexture(GL_TEXTURE_2D, context.input_texture);
+            edge_program->setInt("inputTexture", 0);
+            edge_program->setFloat("edgeThreshold", threshold);
+            glUniform2i(glGetUniformLocation(edge_program->getID(), "imageExtent"), extent_x, extent_y);
+            edge_program->draw();
+
+            glBindFramebuffer(GL_FRAMEBUFFER, weights.framebuffer);
+            glClear(GL_COLOR_BUFFER_BIT);
+            weight_program->use();
+            glActiveTexture(GL_TEXTURE1);
+            glBindTexture(GL_TEXTURE_2D, edges.texture);
+            weight_program->setInt("edgeTexture", 1);
+            glUniform2i(glGetUniformLocation(weight_program->getID(), "imageExtent"), extent_x, extent_y);
+            weight_program->draw();
+
+            glBindFramebuffer(GL_FRAMEBUFFER, context.output.framebuffer);
+            blend_program->use();
+            glActiveTexture(GL_TEXTURE1);
+            glBindTexture(GL_TEXTURE_2D, weights.texture);
+            blend_program->setInt("inputTexture", 0);
+            blend_program->setInt("blendTexture", 1);
+            glUniform2i(glGetUniformLocation(blend_program->getID(), "imageExtent"), extent_x, extent_y);
+            blend_program->draw();
+
+            context.pool.release(edges);
+            context.pool.release(weights);
+        };
+    } else {
+        throw std::runtime_error("Unknown post process pass: " + name);
+    }
+    return pass;
+}
+
+std::unique_ptr<ShaderProgram> PostProcessChain::buildProgram(const std::vector<const PostProcessPass*>& stage_passes) const {
+    std::string code =
+        "#version 430 core\n"
+        "out vec4 FragColor;\n"
+        "in vec2 TexCoords;\n"
+        "uniform sampler2D inputTexture;\n"
+        "uniform sampler2D depthTexture;\n"
+        "uniform vec2 texelSize;\n"
+        "uniform vec2 uvMax;\n";
+    code += blur_kernel_lib + toon_lib;
+    // 多个pass可能共用同一段源码, 只拼接一次
+    std::vector<const std::string*> included;
+    for (const auto* pass : stage_passes) {
+        bool duplicate = std::any_of(included.begin(), included.end(), [&](const std::string* source) { return *source == pass->source; });
+        if (duplicate) continue;
+        code += pass->source;
+        included.push_back(&pass->source);
+    }
+
+    code += "void main()\n{\n";
+    size_t first = 0;
+    if (!stage_passes.empty() && stage_passes[0]->kind == PostProcessPass::Kind::Neighborhood) {
+        code += "    vec4 color = " + stage_passes[0]->function + "(TexCoords);\n";
+        first = 1;
+    } else {
+        code += "    vec4 color = texture(inputTexture, TexCoords);\n";
+    }
+    for (size_t i = first; i < stage_passes.size(); i++) {
+        code += "    color = " + stage_passes[i]->function + "(color, TexCoords);\n";
+    }
+    code += "    FragColor = color;\n}\n";
+
+    return createFullscreenProgram(code);
+}
+
+void PostProcessChain::compile() {
+    stages.clear();
+    for (const auto& pass : passes) {
+        if (!pass.enabled) continue;
+        switch (pass.kind) {
+            case PostProcessPass::Kind::Custom:
+                stages.push_back({.custom = &pass, .format = pass.format});
+                break;
+            case PostProcessPass::Kind::Neighborhood:
+                stages.push_back({.passes = {&pass}, .format = pass.format});
+                break;
+            case PostProcessPass::Kind::Pointwise:
+                // 接在着色器stage后面, 省去一次全屏读写
+                if (stages.empty() || stages.back().custom) {
+                    stages.push_back({.passes = {&pass}, .format = pass.format});
+                } else {
+                    stages.back().passes.push_back(&pass);
+                    stages.back().format = pass.format;
+                }
+                break;
+        }
+    }
+    // 一般的自定义pass只能写入池里的目标, 结尾或空链需要一次复制到输出
+    if (stages.empty() || (stages.back().custom && !stages.back().custom->renders_to_framebuffer)) {
+        stages.push_back({});
+    }
+    for (auto& stage : stages) {
+        if (!stage.custom) stage.program = buildProgram(stage.passes);
+    }
+    dirty = false;
+}
+
+size_t PostProcessChain::getStageCount() {
+    if (dirty) compile();
+    return stages.size();
+}
+
+void PostProcessChain::execute(unsigned int scene_color, unsigned int scene_depth, int width, int height, unsigned int output_framebuffer) {
+    execute(scene_color, scene_depth, {width, height, width, height}, output_framebuffer);
+}
+
+void PostProcessChain::execute(unsigned int scene_color, unsigned int scene_depth, const TextureExtent& extent, unsigned int output_framebuffer) {
+    if (dirty) compile();
+    unsigned int input = scene_color;
+    RenderTarget previous;
+    for (size_t i = 0; i < stages.size(); i++) {
+        const Stage& stage = stages[i];
+        const bool last = i + 1 == stages.size();
+        RenderTarget output{.framebuffer = output_framebuffer, .format = stage.format, .width = extent.width, .height = extent.height};
+        if (!last) output = pool.acquire(stage.format, extent.texture_width, extent.texture_height);
+        executeStage(stage, input, scene_depth, extent, output, last);
+
+        // 上一个中间目标已经读完, 归还后下一个stage就能拿到它, 形成乒乓
+        pool.release(previous);
+        previous = output;
+        input = output.texture;
+    }
+}
+
+void PostProcessChain::addPasses(RenderGraph& graph, RenderResource scene_color, RenderResource scene_depth, const TextureExtent& extent, RenderResource output) {
+    if (dirty) compile();
+    RenderResource input = scene_color;
+    for (size_t i = 0; i < stages.size(); i++) {
+        const Stage& stage = stages[i];
+        const bool last = i + 1 == stages.size();
+        std::string name = "post_copy";
+        if (stage.custom) {
+            name = "post_" + stage.custom->name;
+        } else if (!stage.passes.empty()) {
+            name = "post";
+            for (size_t j = 0; j < stage.passes.size(); j++) name += (j == 0 ? "_" : "+") + stage.passes[j]->name;
+        }
+        const RenderResource target = last ? output : graph.createTexture(name, {stage.format, extent.texture_width, extent.texture_height});
+        // 一般的自定义pass用imageStore写入, 其余的由图绑定帧缓冲
+        const Access write_access = stage.custom && !stage.custom->renders_to_framebuffer ? Access::ImageWrite : Access::ColorAttachment;
+        graph.addPass(name, [&](RenderPassBuilder& builder) {
+            builder.read(input);
+            builder.read(scene_depth);
+            builder.write(target, write_access);
+        }, [this, &stage, input, scene_depth, target, extent, last](const RenderPassContext& context) {
+            const RenderTarget output{.framebuffer = context.getFramebuffer(), .texture = context.getTexture(target),
+                                      .format = stage.format, .width = extent.width, .height = extent.height};
+            executeStage(stage, context.getTexture(input), context.getTexture(scene_depth), extent, output, last);
+        });
+        input = target;
+    }
+}
+
+void PostProcessChain::executeStage(const Stage& stage, unsigned int input, unsigned int depth, const TextureExtent& extent, const RenderTarget& output, bool last) {
+    const int width = extent.width, height = extent.height;
+    glDisable(GL_DEPTH_TEST);
+    glViewport(0, 0, width, height);
+    glBindBufferBase(GL_UNIFORM_BUFFER, 0, kernel_buffer);
+    if (stage.custom) {
+        stage.custom->execute({input, depth, width, height, extent.texture_width, extent.texture_height, pool, output});
+        return;
+    }
+
+    const glm::vec2 texture_size(static_cast<float>(extent.texture_width), static_cast<float>(extent.texture_height));
+    const glm::vec2 texel_size = 1.0f / texture_size;
+    const glm::vec2 uv_scale = glm::vec2(static_cast<float>(width), static_cast<float>(height)) / texture_size;
+    // 渲染缩放小于1时, 有效区域外是清屏的内容或者池中目标的旧内容
+    const glm::vec2 uv_max = (glm::vec2(static_cast<float>(width), static_cast<float>(height)) - 0.5f) / texture_size;
+    glBindFramebuffer(GL_FRAMEBUFFER, output.framebuffer);
+    if (last) {
+        glClearColor(1.0f, 1.0f, 1.0f, 1.0f);
+        glClear(GL_COLOR_BUFFER_BIT);
+    }
+    stage.program->use();
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, input);
+    stage.program->setInt("inputTexture", 0);
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_2D, depth);
+    stage.program->setInt("depthTexture", 1);
+    stage.program->setVec2("texelSize", texel_size);
+    stage.program->setVec2("uvScale", uv_scale);
+    stage.program->setVec2("uvMax", uv_max);
+    for (const auto* pass : stage.passes) {
+        if (pass->setup) pass->setup(*stage.program);
+    }
+    stage.program->draw();
+}
+
+}
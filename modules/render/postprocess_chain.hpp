@@ -0,0 +1,97 @@
+#pragma once
+#include "shader.hpp"
+#include "render_target.hpp"
+#include "render_graph.hpp"
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace lunar {
+
+// 自定义pass执行时能拿到的信息
+struct PostProcessContext {
+    unsigned int input_texture;
+    unsigned int depth_texture;
+    // 需要处理的区域, 纹理本身为texture_width x texture_height
+    int width, height;
+    int texture_width, texture_height;
+    RenderTargetPool& pool;
+    const RenderTarget& output;
+};
+
+// 后处理pass. 着色器pass的GLSL中可以使用inputTexture, depthTexture, texelSize, uvMax(有效区域最后一个像素中心的uv,
+// 读取邻域时用它限制采样位置), 以及glsllibs/blur-kernel.glsl和glsllibs/3shade2.glsl中的函数; uniform名字需要在整条链中唯一.
+struct PostProcessPass {
+    enum class Kind {
+        Pointwise,     // vec4 function(vec4 color, vec2 uv), 只依赖当前像素的颜色, 可以和前一个pass合并
+        Neighborhood,  // vec4 function(vec2 uv), 需要从inputTexture读取邻域
+        Custom         // 由execute自行完成, 例如计算着色器
+    };
+
+    std::string name;
+    Kind kind{Kind::Pointwise};
+    std::string function;
+    std::string source;
+    // 设置该pass的uniform, 着色器已处于使用状态
+    std::function<void(const ShaderProgram&)> setup;
+    std::function<void(const PostProcessContext&)> execute;
+    GLenum format{GL_RGBA8};
+    bool enabled{true};
+    // 自定义pass只通过output.framebuffer绘制时为true, 作为链的最后一个pass时可以直接写入输出, 省去一次复制
+    bool renders_to_framebuffer{false};
+};
+
+// 后处理链: 相邻的逐像素pass合并进同一个着色器, 中间结果来自渲染目标池并在pass之间来回复用.
+class PostProcessChain {
+public:
+    PostProcessChain();
+    ~PostProcessChain();
+    PostProcessChain(const PostProcessChain&) = delete;
+    PostProcessChain& operator=(const PostProcessChain&) = delete;
+
+    // pass名字不能重复
+    void addPass(PostProcessPass pass);
+    void removePass(const std::string& name);
+    void clear();
+    void setEnabled(const std::string& name, bool enabled);
+    [[nodiscard]] bool hasPass(const std::string& name) const;
+
+    // 内置pass: blur_horizontal, blur_vertical, blur_compute, outline, toon, color_grading, fxaa, smaa
+    static PostProcessPass createBuiltinPass(const std::string& name, const std::map<std::string, float>& params = {});
+
+    // 依次运行所有pass, 最后一个写入output_framebuffer
+    void execute(unsigned int scene_color, unsigned int scene_depth, int width, int height, unsigned int output_framebuffer = 0);
+    // 场景只占纹理一部分时, 所有pass都只处理extent描述的区域, 写入output_framebuffer左下角同样大小的区域;
+    // 中间目标按纹理尺寸申请, 区域变化时不需要重新分配
+    void execute(unsigned int scene_color, unsigned int scene_depth, const TextureExtent& extent, unsigned int output_framebuffer = 0);
+    // 把每个stage声明为帧图中的pass, 中间结果是图的临时纹理, 由图剔除, 别名并绑定帧缓冲; 最后一个stage写入output.
+    // 在图执行之前不能修改链
+    void addPasses(RenderGraph& graph, RenderResource scene_color, RenderResource scene_depth, const TextureExtent& extent, RenderResource output);
+
+    // 合并后实际的全屏绘制次数
+    [[nodiscard]] size_t getStageCount();
+    [[nodiscard]] RenderTargetPool& getPool() { return pool; }
+
+private:
+    // 一个stage对应一次全屏绘制: 可选的一个邻域pass, 后面跟着若干逐像素pass
+    struct Stage {
+        std::unique_ptr<ShaderProgram> program{};
+        std::vector<const PostProcessPass*> passes{};
+        const PostProcessPass* custom{nullptr};
+        GLenum format{GL_RGBA8};
+    };
+
+    void compile();
+    void executeStage(const Stage& stage, unsigned int input, unsigned int depth, const TextureExtent& extent, const RenderTarget& output, bool last);
+    std::unique_ptr<ShaderProgram> buildProgram(const std::vector<const PostProcessPass*>& passes) const;
+
+    std::vector<PostProcessPass> passes;
+    std::vector<Stage> stages;
+    bool dirty{true};
+    RenderTargetPool pool;
+    unsigned int kernel_buffer;
+};
+
+}
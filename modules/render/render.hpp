@@ -2,4 +2,24 @@
 #include "window.hpp"
 #include "shader.hpp"
 #include "camera.hpp"
+#include "camera_path.hpp"
 #include "postprocess.hpp"
+#include "postprocess_chain.hpp"
+#include "render_target.hpp"
+#include "hiz.hpp"
+#include "gpu_driven.hpp"
+#include "settings.hpp"
+#include "clustered.hpp"
+#include "shadow.hpp"
+#include "deferred.hpp"
+#include "render_graph.hpp"
+#include "upscaler.hpp"
+#include "dynamic_resolution.hpp"
+#include "debug_draw.hpp"
+#include "frame_capture.hpp"
+#include "scene_renderer.hpp"
+#include "engine.hpp"
+#include "profile/chrome_trace.hpp"
+#include "profile/gpu_profiler.hpp"
+#include "profile/hitch_recorder.hpp"
+#include "profile/profile_scope.hpp"
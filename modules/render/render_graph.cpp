@@ -0,0 +1,391 @@
+#include "render_graph.hpp"
+#include "render_target.hpp"
+#include "profile/gpu_profiler.hpp"
+#include "profile/profile_scope.hpp"
+#include <algorithm>
+#include <sstream>
+#include <stdexcept>
+
+namespace lunar {
+
+// 附件标识中的种类
+enum AttachmentKind {
+    color_slot = 0,
+    color_texture = 1,
+    depth_slot = 2,
+    depth_texture = 3,
+    imported_framebuffer = 4
+};
+
+static size_t getTextureBytes(const TextureDesc& desc) {
+    return RenderTargetPool::getBytesPerPixel(desc.format) * static_cast<size_t>(desc.width) * static_cast<size_t>(desc.height);
+}
+
+RenderResource RenderPassBuilder::read(RenderResource resource, Access access) {
+    if (resource >= graph.resources.size()) throw std::runtime_error("Invalid render graph resource");
+    graph.passes[pass].reads.push_back({resource, access});
+    return resource;
+}
+
+RenderResource RenderPassBuilder::write(RenderResource resource, Access access) {
+    if (resource >= graph.resources.size()) throw std::runtime_error("Invalid render graph resource");
+    if (access == Access::Sampled || access == Access::ImageRead) {
+        throw std::runtime_error("Render graph write with a read-only access");
+    }
+    graph.passes[pass].writes.push_back({resource, access});
+    return resource;
+}
+
+void RenderPassBuilder::setSideEffect() {
+    graph.passes[pass].side_effect = true;
+}
+
+unsigned int RenderPassContext::getTexture(RenderResource resource) const {
+    return graph.resolveTexture(resource);
+}
+
+const TextureDesc& RenderPassContext::getDesc(RenderResource resource) const {
+    return graph.resources[resource].desc;
+}
+
+unsigned int RenderPassContext::getFramebuffer() const {
+    return graph.pass_framebuffer;
+}
+
+RenderGraph::~RenderGraph() {
+    for (const auto& [key, framebuffer] : framebuffers) glDeleteFramebuffers(1, &framebuffer);
+    if (!slot_textures.empty()) glDeleteTextures(static_cast<GLsizei>(slot_textures.size()), slot_textures.data());
+}
+
+void RenderGraph::reset() {
+    resources.clear();
+    passes.clear();
+}
+
+RenderResource RenderGraph::createTexture(const std::string& name, const TextureDesc& desc) {
+    resources.push_back({name, ResourceKind::Transient, desc, 0});
+    return static_cast<RenderResource>(resources.size() - 1);
+}
+
+RenderResource RenderGraph::importTexture(const std::string& name, unsigned int texture, const TextureDesc& desc) {
+    resources.push_back({name, ResourceKind::Texture, desc, texture});
+    return static_cast<RenderResource>(resources.size() - 1);
+}
+
+RenderResource RenderGraph::importFramebuffer(const std::string& name, unsigned int framebuffer, const TextureDesc& desc) {
+    resources.push_back({name, ResourceKind::Framebuffer, desc, framebuffer});
+    return static_cast<RenderResource>(resources.size() - 1);
+}
+
+RenderResource RenderGraph::importExternal(const std::string& name) {
+    resources.push_back({name, ResourceKind::External, {}, 0});
+    return static_cast<RenderResource>(resources.size() - 1);
+}
+
+void RenderGraph::addPass(const std::string& name, const SetupCallback& setup, ExecuteCallback execute) {
+    passes.push_back({.name = name, .execute = std::move(execute)});
+    RenderPassBuilder builder(*this, static_cast<unsigned int>(passes.size() - 1));
+    setup(builder);
+}
+
+std::string RenderGraph::computeSignature() const {
+    // 导入对象的GL名字也算在内, 它们变化时帧缓冲需要重建
+    std::ostringstream signature;
+    for (const auto& resource : resources) {
+        signature << static_cast<int>(resource.kind) << ',' << resource.desc.format << ',' << resource.desc.width << ','
+                  << resource.desc.height << ',' << resource.handle << ';';
+    }
+    signature << '|';
+    for (const auto& pass : passes) {
+        signature << pass.name << (pass.side_effect ? "!" : "") << ':';
+        for (const auto& usage : pass.reads) signature << 'r' << usage.resource << '.' << static_cast<int>(usage.access);
+        for (const auto& usage : pass.writes) signature << 'w' << usage.resource << '.' << static_cast<int>(usage.access);
+        signature << ';';
+    }
+    return signature.str();
+}
+
+bool RenderGraph::compile() {
+    std::string signature = computeSignature();
+    if (signature == compiled_signature) return false;
+
+    Plan next;
+    const size_t pass_count = passes.size();
+    const size_t resource_count = resources.size();
+    next.culled.assign(pass_count, true);
+    next.physical_slot.assign(resource_count, -1);
+
+    // 从后往前剔除: 有副作用或写入导入资源的pass是根, 其余pass只有在输出被后面的pass读取时才保留
+    std::vector<bool> needed(resource_count, false);
+    for (size_t i = pass_count; i-- > 0;) {
+        const Pass& pass = passes[i];
+        bool live = pass.side_effect;
+        for (const auto& usage : pass.writes) {
+            if (resources[usage.resource].kind != ResourceKind::Transient || needed[usage.resource]) live = true;
+        }
+        if (!live) continue;
+        next.culled[i] = false;
+        for (const auto& usage : pass.reads) needed[usage.resource] = true;
+    }
+    for (unsigned int i = 0; i < pass_count; i++) {
+        if (!next.culled[i]) next.live_passes.push_back(i);
+    }
+
+    // 临时纹理在存活pass序列中的首次与末次使用
+    std::vector<int> first_use(resource_count, -1), last_use(resource_count, -1);
+    for (int order = 0; order < static_cast<int>(next.live_passes.size()); order++) {
+        const Pass& pass = passes[next.live_passes[order]];
+        auto touch = [&](const Usage& usage) {
+            if (resources[usage.resource].kind != ResourceKind::Transient) return;
+            if (first_use[usage.resource] < 0) first_use[usage.resource] = order;
+            last_use[usage.resource] = order;
+        };
+        for (const auto& usage : pass.reads) touch(usage);
+        for (const auto& usage : pass.writes) touch(usage);
+    }
+
+    // 按首次使用排序后贪心分配, 物理纹理在上一个使用者结束之后才能复用
+    std::vector<RenderResource> transients;
+    for (RenderResource r = 0; r < resource_count; r++) {
+        if (first_use[r] >= 0) transients.push_back(r);
+    }
+    std::stable_sort(transients.begin(), transients.end(), [&](RenderResource a, RenderResource b) { return first_use[a] < first_use[b]; });
+    std::vector<int> slot_free_after;
+    for (RenderResource r : transients) {
+        const TextureDesc& desc = resources[r].desc;
+        int chosen = -1;
+        for (size_t slot = 0; slot < next.slots.size(); slot++) {
+            if (next.slots[slot] == desc && slot_free_after[slot] < first_use[r]) {
+                chosen = static_cast<int>(slot);
+                break;
+            }
+        }
+        if (chosen < 0) {
+            chosen = static_cast<int>(next.slots.size());
+            next.slots.push_back(desc);
+            slot_free_after.push_back(-1);
+        }
+        slot_free_after[chosen] = last_use[r];
+        next.physical_slot[r] = chosen;
+        next.stats.unaliased_bytes += getTextureBytes(desc);
+    }
+    for (const auto& desc : next.slots) next.stats.allocated_bytes += getTextureBytes(desc);
+    for (int order = 0; order < static_cast<int>(next.live_passes.size()); order++) {
+        size_t live_bytes = 0;
+        for (RenderResource r : transients) {
+            if (first_use[r] <= order && order <= last_use[r]) live_bytes += getTextureBytes(resources[r].desc);
+        }
+        next.stats.peak_live_bytes = std::max(next.stats.peak_live_bytes, live_bytes);
+    }
+
+    // 屏障: imageStore之后的读写需要对应的位, 屏障是全局的, 发出一次即可覆盖所有资源
+    std::vector<bool> image_written(resource_count, false);
+    std::vector<GLbitfield> issued(resource_count, 0);
+    AttachmentKey previous_attachments;
+    for (unsigned int index : next.live_passes) {
+        const Pass& pass = passes[index];
+        GLbitfield bits = 0;
+        auto require = [&](RenderResource r, GLbitfield bit) {
+            if (image_written[r] && !(issued[r] & bit)) bits |= bit;
+        };
+        for (const auto& usage : pass.reads) {
+            if (usage.access == Access::Sampled) require(usage.resource, GL_TEXTURE_FETCH_BARRIER_BIT);
+            if (usage.access == Access::ImageRead) require(usage.resource, GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
+        }
+        for (const auto& usage : pass.writes) {
+            if (usage.access == Access::ImageWrite) require(usage.resource, GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
+            if (usage.access == Access::ColorAttachment || usage.access == Access::DepthAttachment) {
+                require(usage.resource, GL_FRAMEBUFFER_BARRIER_BIT);
+            }
+        }
+        if (bits) {
+            next.stats.barrier_count++;
+            for (RenderResource r = 0; r < resource_count; r++) issued[r] |= bits;
+        }
+        for (const auto& usage : pass.writes) {
+            if (usage.access == Access::ImageWrite) {
+                image_written[usage.resource] = true;
+                issued[usage.resource] = 0;
+            } else if (usage.access != Access::Manual) {
+                image_written[usage.resource] = false;
+            }
+        }
+        next.barriers.push_back(bits);
+
+        // 颜色附件按声明顺序, 深度附件放在最后
+        AttachmentKey attachments;
+        std::pair<int, unsigned int> depth{-1, 0};
+        for (const auto& usage : pass.writes) {
+            const Resource& resource = resources[usage.resource];
+            if (usage.access == Access::ColorAttachment) {
+                if (resource.kind == ResourceKind::Framebuffer) attachments.push_back({imported_framebuffer, resource.handle});
+                else if (resource.kind == ResourceKind::Transient) attachments.push_back({color_slot, next.physical_slot[usage.resource]});
+                else attachments.push_back({color_texture, resource.handle});
+            } else if (usage.access == Access::DepthAttachment) {
+                if (resource.kind == ResourceKind::Transient) depth = {depth_slot, next.physical_slot[usage.resource]};
+                else depth = {depth_texture, resource.handle};
+            }
+        }
+        if (depth.first >= 0) attachments.push_back(depth);
+        if (!attachments.empty() && attachments != previous_attachments) next.stats.framebuffer_bind_count++;
+        // Manual的pass可能绑定了别的帧缓冲, 之后需要重新绑定
+        bool manual = std::any_of(pass.writes.begin(), pass.writes.end(), [](const Usage& usage) { return usage.access == Access::Manual; });
+        previous_attachments = manual ? AttachmentKey{} : (attachments.empty() ? previous_attachments : attachments);
+        next.attachments.push_back(std::move(attachments));
+    }
+
+    next.stats.pass_count = pass_count;
+    next.stats.culled_pass_count = pass_count - next.live_passes.size();
+    next.stats.transient_count = transients.size();
+    next.stats.physical_count = next.slots.size();
+    plan = std::move(next);
+    compiled_signature = std::move(signature);
+    return true;
+}
+
+unsigned int RenderGraph::resolveTexture(RenderResource resource) const {
+    const Resource& r = resources[resource];
+    if (r.kind == ResourceKind::Transient) {
+        int slot = plan.physical_slot[resource];
+        return slot < 0 ? 0 : slot_textures[slot];
+    }
+    return r.kind == ResourceKind::Texture ? r.handle : 0;
+}
+
+void RenderGraph::realizeSlots() {
+    bool changed = false;
+    // 已有的物理纹理尽量保留, 只有规格变化时才重新分配
+    for (size_t slot = 0; slot < plan.slots.size(); slot++) {
+        if (slot < slot_textures.size() && slot_descs[slot] == plan.slots[slot]) continue;
+        if (slot < slot_textures.size()) {
+            glDeleteTextures(1, &slot_textures[slot]);
+        } else {
+            slot_textures.push_back(0);
+            slot_descs.push_back({});
+        }
+        const TextureDesc& desc = plan.slots[slot];
+        glGenTextures(1, &slot_textures[slot]);
+        glBindTexture(GL_TEXTURE_2D, slot_textures[slot]);
+        glTexStorage2D(GL_TEXTURE_2D, 1, desc.format, desc.width, desc.height);
+        LUNAR_PROFILE_COUNT(Allocations, 1);
+        LUNAR_PROFILE_COUNT(AllocatedBytes, RenderTargetPool::getBytesPerPixel(desc.format) * desc.width * desc.height);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        slot_descs[slot] = desc;
+        changed = true;
+    }
+    if (slot_textures.size() > plan.slots.size()) {
+        glDeleteTextures(static_cast<GLsizei>(slot_textures.size() - plan.slots.size()), slot_textures.data() + plan.slots.size());
+        slot_textures.resize(plan.slots.size());
+        slot_descs.resize(plan.slots.size());
+        changed = true;
+    }
+    glBindTexture(GL_TEXTURE_2D, 0);
+    if (changed) {
+        for (const auto& [key, framebuffer] : framebuffers) glDeleteFramebuffers(1, &framebuffer);
+        framebuffers.clear();
+    }
+}
+
+unsigned int RenderGraph::getFramebuffer(const AttachmentKey& key) {
+    if (key.size() == 1 && key[0].first == imported_framebuffer) return key[0].second;
+    auto it = framebuffers.find(key);
+    if (it != framebuffers.end()) return it->second;
+
+    unsigned int framebuffer;
+    glGenFramebuffers(1, &framebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    std::vector<GLenum> draw_buffers;
+    for (const auto& [kind, value] : key) {
+        unsigned int texture = (kind == color_slot || kind == depth_slot) ? slot_textures[value] : value;
+        if (kind == color_slot || kind == color_texture) {
+            GLenum attachment = GL_COLOR_ATTACHMENT0 + static_cast<GLenum>(draw_buffers.size());
+            glFramebufferTexture2D(GL_FRAMEBUFFER, attachment, GL_TEXTURE_2D, texture, 0);
+            draw_buffers.push_back(attachment);
+        } else if (kind == depth_slot || kind == depth_texture) {
+            glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, texture, 0);
+        } else {
+            throw std::runtime_error("Imported framebuffer must be the only attachment of a pass");
+        }
+    }
+    if (draw_buffers.empty()) glDrawBuffer(GL_NONE);
+    else glDrawBuffers(static_cast<GLsizei>(draw_buffers.size()), draw_buffers.data());
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+        throw std::runtime_error("Render graph framebuffer is not complete");
+    }
+    framebuffers[key] = framebuffer;
+    return framebuffer;
+}
+
+void RenderGraph::execute() {
+    compile();
+    realizeSlots();
+
+    const RenderPassContext context(*this);
+    // 图外的代码可能改变了绑定, 每帧第一次总是重新绑定
+    bool bound_valid = false;
+    unsigned int bound = 0;
+    for (size_t order = 0; order < plan.live_passes.size(); order++) {
+        const Pass& pass = passes[plan.live_passes[order]];
+        GpuProfiler::Scope scope(profiler, pass.name);
+        if (plan.barriers[order]) glMemoryBarrier(plan.barriers[order]);
+        const AttachmentKey& attachments = plan.attachments[order];
+        pass_framebuffer = 0;
+        if (!attachments.empty()) {
+            unsigned int framebuffer = getFramebuffer(attachments);
+            pass_framebuffer = framebuffer;
+            if (!bound_valid || framebuffer != bound) {
+                glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+                bound = framebuffer;
+                bound_valid = true;
+            }
+            // 视口取第一个附件的尺寸
+            const Usage* first = nullptr;
+            for (const auto& usage : pass.writes) {
+                if (usage.access == Access::ColorAttachment || usage.access == Access::DepthAttachment) {
+                    first = &usage;
+                    break;
+                }
+            }
+            const TextureDesc& desc = resources[first->resource].desc;
+            glViewport(0, 0, desc.width, desc.height);
+        }
+        if (pass.execute) pass.execute(context);
+        if (std::any_of(pass.writes.begin(), pass.writes.end(), [](const Usage& usage) { return usage.access == Access::Manual; })) {
+            bound_valid = false;
+        }
+    }
+}
+
+bool RenderGraph::isPassCulled(const std::string& name) const {
+    for (size_t i = 0; i < passes.size() && i < plan.culled.size(); i++) {
+        if (passes[i].name == name) return plan.culled[i];
+    }
+    return false;
+}
+
+int RenderGraph::getPhysicalSlot(RenderResource resource) const {
+    return resource < plan.physical_slot.size() ? plan.physical_slot[resource] : -1;
+}
+
+std::string RenderGraph::getReport() const {
+    const RenderGraphStats& stats = plan.stats;
+    auto megabytes = [](size_t bytes) { return static_cast<double>(bytes) / (1024.0 * 1024.0); };
+    std::ostringstream report;
+    report.setf(std::ios::fixed);
+    report.precision(2);
+    report << "render graph: " << stats.pass_count << " passes, " << stats.culled_pass_count << " culled\n";
+    for (size_t i = 0; i < passes.size() && i < plan.culled.size(); i++) {
+        report << "  " << (plan.culled[i] ? "[culled] " : "") << passes[i].name << "\n";
+    }
+    report << "transient textures: " << stats.transient_count << " -> " << stats.physical_count << " physical\n";
+    report << "transient memory: " << megabytes(stats.allocated_bytes) << " MB allocated, "
+           << megabytes(stats.unaliased_bytes) << " MB without aliasing, "
+           << megabytes(stats.peak_live_bytes) << " MB peak live\n";
+    report << "per frame: " << stats.barrier_count << " barriers, " << stats.framebuffer_bind_count << " framebuffer binds\n";
+    return report.str();
+}
+
+}
@@ -0,0 +1,162 @@
+#pragma once
+#include <glad/glad.h>
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace lunar {
+
+struct TextureDesc {
+    GLenum format{GL_RGBA8};
+    int width{0}, height{0};
+    bool operator==(const TextureDesc&) const = default;
+};
+
+// pass访问资源的方式, 决定需要的内存屏障与帧缓冲
+enum class Access {
+    Sampled,          // texture()采样
+    ImageRead,        // imageLoad
+    ImageWrite,       // imageStore, 之后的读取需要内存屏障
+    ColorAttachment,  // 作为颜色附件写入, 由图负责绑定帧缓冲
+    DepthAttachment,  // 作为深度附件写入
+    Manual            // pass自己负责绑定与同步, 图只记录依赖
+};
+
+using RenderResource = unsigned int;
+
+class RenderGraph;
+class GpuProfiler;
+
+// addPass的setup回调里声明读写的资源
+class RenderPassBuilder {
+public:
+    RenderResource read(RenderResource resource, Access access = Access::Sampled);
+    RenderResource write(RenderResource resource, Access access = Access::ColorAttachment);
+    // 即使输出没有被使用也不剔除
+    void setSideEffect();
+
+private:
+    friend class RenderGraph;
+    RenderPassBuilder(RenderGraph& graph, unsigned int pass): graph(graph), pass(pass) {}
+    RenderGraph& graph;
+    unsigned int pass;
+};
+
+// execute回调里用来取得资源对应的GL纹理
+class RenderPassContext {
+public:
+    [[nodiscard]] unsigned int getTexture(RenderResource resource) const;
+    [[nodiscard]] const TextureDesc& getDesc(RenderResource resource) const;
+    // 图为这个pass绑定的帧缓冲, 没有附件(包括只有Manual写入)时为0
+    [[nodiscard]] unsigned int getFramebuffer() const;
+
+private:
+    friend class RenderGraph;
+    explicit RenderPassContext(const RenderGraph& graph): graph(graph) {}
+    const RenderGraph& graph;
+};
+
+struct RenderGraphStats {
+    size_t pass_count{0};
+    size_t culled_pass_count{0};
+    size_t transient_count{0};        // 存活的临时纹理
+    size_t physical_count{0};         // 别名之后实际分配的纹理
+    size_t unaliased_bytes{0};        // 每个临时纹理单独分配时的总量
+    size_t allocated_bytes{0};        // 别名之后实际分配的总量
+    size_t peak_live_bytes{0};        // 任意时刻同时存活的临时纹理之和, 别名能达到的下限
+    size_t barrier_count{0};          // 每帧的glMemoryBarrier次数
+    size_t framebuffer_bind_count{0}; // 每帧由图发出的帧缓冲绑定次数
+};
+
+// 帧图: 每帧声明pass及其读写的资源, 编译时剔除输出无人使用的pass, 为生命周期不重叠的临时纹理分配同一块显存,
+// 并算出最少的内存屏障与帧缓冲切换. 图的结构与上一帧相同时直接复用编译结果.
+// OpenGL没有显式的显存别名, 因此只有格式与尺寸相同的临时纹理会共用同一个物理纹理.
+class RenderGraph {
+public:
+    using SetupCallback = std::function<void(RenderPassBuilder&)>;
+    using ExecuteCallback = std::function<void(const RenderPassContext&)>;
+
+    RenderGraph() = default;
+    ~RenderGraph();
+    RenderGraph(const RenderGraph&) = delete;
+    RenderGraph& operator=(const RenderGraph&) = delete;
+
+    // 每帧开始时清空声明, 编译结果与物理纹理保留
+    void reset();
+
+    RenderResource createTexture(const std::string& name, const TextureDesc& desc);
+    RenderResource importTexture(const std::string& name, unsigned int texture, const TextureDesc& desc);
+    // framebuffer为0时表示默认帧缓冲
+    RenderResource importFramebuffer(const std::string& name, unsigned int framebuffer, const TextureDesc& desc);
+    // 缓冲区等只需要排序依赖的外部资源
+    RenderResource importExternal(const std::string& name);
+
+    void addPass(const std::string& name, const SetupCallback& setup, ExecuteCallback execute);
+
+    // 结构变化时重新编译, 返回是否真的重新编译了; 不调用GL
+    bool compile();
+    void execute();
+    // 设置之后每个pass都以自己的名字计入GPU计时, 为空时不计时
+    void setProfiler(GpuProfiler* profiler) { this->profiler = profiler; }
+
+    [[nodiscard]] const RenderGraphStats& getStats() const { return plan.stats; }
+    [[nodiscard]] std::string getReport() const;
+    [[nodiscard]] bool isPassCulled(const std::string& name) const;
+    // 临时纹理被分配到的物理纹理编号, 导入的资源或被剔除时为-1
+    [[nodiscard]] int getPhysicalSlot(RenderResource resource) const;
+
+private:
+    friend class RenderPassBuilder;
+    friend class RenderPassContext;
+
+    enum class ResourceKind { Transient, Texture, Framebuffer, External };
+    struct Resource {
+        std::string name;
+        ResourceKind kind;
+        TextureDesc desc;
+        unsigned int handle{0};  // 导入的纹理或帧缓冲
+    };
+    struct Usage {
+        RenderResource resource;
+        Access access;
+    };
+    struct Pass {
+        std::string name{};
+        std::vector<Usage> reads{};
+        std::vector<Usage> writes{};
+        bool side_effect{false};
+        ExecuteCallback execute{};
+    };
+    // 附件的标识: (种类, 物理纹理编号或GL对象)
+    using AttachmentKey = std::vector<std::pair<int, unsigned int>>;
+    struct Plan {
+        std::vector<unsigned int> live_passes;
+        std::vector<bool> culled;
+        std::vector<int> physical_slot;
+        std::vector<TextureDesc> slots;
+        std::vector<GLbitfield> barriers;       // 按live_passes的顺序
+        std::vector<AttachmentKey> attachments; // 按live_passes的顺序, 为空表示不由图绑定
+        RenderGraphStats stats;
+    };
+
+    [[nodiscard]] std::string computeSignature() const;
+    [[nodiscard]] unsigned int resolveTexture(RenderResource resource) const;
+    unsigned int getFramebuffer(const AttachmentKey& key);
+    void realizeSlots();
+
+    std::vector<Resource> resources;
+    std::vector<Pass> passes;
+    std::string compiled_signature;
+    Plan plan;
+
+    std::vector<unsigned int> slot_textures;
+    std::vector<TextureDesc> slot_descs;
+    std::map<AttachmentKey, unsigned int> framebuffers;
+    unsigned int pass_framebuffer{0};  // execute中当前pass的帧缓冲
+    GpuProfiler* profiler{nullptr};
+};
+
+}
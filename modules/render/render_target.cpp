@@ -0,0 +1,80 @@
+#include "render_target.hpp"
+#include "profile/profile_scope.hpp"
+#include <stdexcept>
+
+namespace lunar {
+
+RenderTargetPool::~RenderTargetPool() {
+    trim();
+}
+
+size_t RenderTargetPool::getBytesPerPixel(GLenum format) {
+    switch (format) {
+        case GL_R8:                 return 1;
+        case GL_RG8:                return 2;
+        case GL_R16F:               return 2;
+        case GL_RG16:               return 4;
+        case GL_RGBA8:              return 4;
+        case GL_R32F:               return 4;
+        case GL_RG16F:              return 4;
+        case GL_R11F_G11F_B10F:     return 4;
+        case GL_DEPTH_COMPONENT24:  return 4;
+        case GL_DEPTH_COMPONENT32F: return 4;
+        case GL_RGBA16F:            return 8;
+        case GL_RG32F:              return 8;
+        case GL_RGBA32F:            return 16;
+        default:                    return 4;
+    }
+}
+
+RenderTarget RenderTargetPool::acquire(GLenum format, int width, int height) {
+    auto it = free_targets.find({format, width, height});
+    if (it != free_targets.end() && !it->second.empty()) {
+        RenderTarget target = it->second.back();
+        it->second.pop_back();
+        return target;
+    }
+
+    RenderTarget target{.format = format, .width = width, .height = height};
+    glGenTextures(1, &target.texture);
+    glBindTexture(GL_TEXTURE_2D, target.texture);
+    glTexStorage2D(GL_TEXTURE_2D, 1, format, width, height);
+    LUNAR_PROFILE_COUNT(Allocations, 1);
+    LUNAR_PROFILE_COUNT(AllocatedBytes, getBytesPerPixel(format) * width * height);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    glGenFramebuffers(1, &target.framebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, target.framebuffer);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, target.texture, 0);
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+        throw std::runtime_error("Pooled render target is not complete");
+    }
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    allocated_count++;
+    allocated_bytes += getBytesPerPixel(format) * static_cast<size_t>(width) * static_cast<size_t>(height);
+    return target;
+}
+
+void RenderTargetPool::release(const RenderTarget& target) {
+    if (target.texture == 0) return;
+    free_targets[{target.format, target.width, target.height}].push_back(target);
+}
+
+void RenderTargetPool::trim() {
+    for (auto& [key, targets] : free_targets) {
+        for (const auto& target : targets) {
+            glDeleteFramebuffers(1, &target.framebuffer);
+            glDeleteTextures(1, &target.texture);
+            allocated_count--;
+            allocated_bytes -= getBytesPerPixel(target.format) * static_cast<size_t>(target.width) * static_cast<size_t>(target.height);
+        }
+    }
+    free_targets.clear();
+}
+
+}
@@ -0,0 +1,48 @@
+#pragma once
+#include <glad/glad.h>
+#include <cstddef>
+#include <map>
+#include <tuple>
+#include <vector>
+
+namespace lunar {
+
+// 单个颜色附件的帧缓冲
+struct RenderTarget {
+    unsigned int framebuffer{0};
+    unsigned int texture{0};
+    GLenum format{GL_RGBA8};
+    int width{0}, height{0};
+};
+
+// 纹理中被使用的区域: 动态分辨率下画面只占纹理左下角width x height的部分, 纹理按窗口尺寸分配, 改变缩放时不重新分配
+struct TextureExtent {
+    int width{0}, height{0};
+    int texture_width{0}, texture_height{0};
+};
+
+// 按格式与尺寸复用的渲染目标池, 释放的目标留在池里等待下一次同规格的申请
+class RenderTargetPool {
+public:
+    RenderTargetPool() = default;
+    ~RenderTargetPool();
+    RenderTargetPool(const RenderTargetPool&) = delete;
+    RenderTargetPool& operator=(const RenderTargetPool&) = delete;
+
+    RenderTarget acquire(GLenum format, int width, int height);
+    void release(const RenderTarget& target);
+    // 删除所有空闲的目标, 例如窗口尺寸变化之后
+    void trim();
+
+    [[nodiscard]] size_t getAllocatedCount() const { return allocated_count; }
+    [[nodiscard]] size_t getAllocatedBytes() const { return allocated_bytes; }
+    static size_t getBytesPerPixel(GLenum format);
+
+private:
+    using Key = std::tuple<GLenum, int, int>;
+    std::map<Key, std::vector<RenderTarget>> free_targets;
+    size_t allocated_count{0};
+    size_t allocated_bytes{0};
+};
+
+}
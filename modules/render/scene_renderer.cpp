@@ -0,0 +1,335 @@
+#include "scene_renderer.hpp"
+#include "settings.hpp"
+#include "debug_draw.hpp"
+#include <glm/gtc/matrix_transform.hpp>
+#include <cmath>
+
+namespace lunar {
+
+static const std::string box_vertex_shader =
+#include "main/GLSL/box-vs.glsl"
+;
+static const std::string light_vertex_shader =
+#include "main/GLSL/light-vs.glsl"
+;
+static const std::string light_fragment_shader =
+#include "main/GLSL/light-fs.glsl"
+;
+
+static const std::vector<VertexData<3>> light_cube_vertices = {
+    {-0.5f, -0.5f, -0.5f},
+    { 0.5f, -0.5f, -0.5f},
+    { 0.5f,  0.5f, -0.5f},
+    { 0.5f,  0.5f, -0.5f},
+    {-0.5f,  0.5f, -0.5f},
+    {-0.5f, -0.5f, -0.5f},
+
+    {-0.5f, -0.5f,  0.5f},
+    { 0.5f, -0.5f,  0.5f},
+    { 0.5f,  0.5f,  0.5f},
+    { 0.5f,  0.5f,  0.5f},
+    {-0.5f,  0.5f,  0.5f},
+    {-0.5f, -0.5f,  0.5f},
+
+    {-0.5f,  0.5f,  0.5f},
+    {-0.5f,  0.5f, -0.5f},
+    {-0.5f, -0.5f, -0.5f},
+    {-0.5f, -0.5f, -0.5f},
+    {-0.5f, -0.5f,  0.5f},
+    {-0.5f,  0.5f,  0.5f},
+
+    { 0.5f,  0.5f,  0.5f},
+    { 0.5f,  0.5f, -0.5f},
+    { 0.5f, -0.5f, -0.5f},
+    { 0.5f, -0.5f, -0.5f},
+    { 0.5f, -0.5f,  0.5f},
+    { 0.5f,  0.5f,  0.5f},
+
+    {-0.5f, -0.5f, -0.5f},
+    { 0.5f, -0.5f, -0.5f},
+    { 0.5f, -0.5f,  0.5f},
+    { 0.5f, -0.5f,  0.5f},
+    {-0.5f, -0.5f,  0.5f},
+    {-0.5f, -0.5f, -0.5f},
+
+    {-0.5f,  0.5f, -0.5f},
+    { 0.5f,  0.5f, -0.5f},
+    { 0.5f,  0.5f,  0.5f},
+    { 0.5f,  0.5f,  0.5f},
+    {-0.5f,  0.5f,  0.5f},
+    {-0.5f,  0.5f, -0.5f},
+};
+
+static std::string getBoxFragmentShader(const RenderSettings& settings) {
+    // 延迟着色时几何阶段只写G-buffer, 光照相关的库都拼接到光照着色器里
+    if (settings.deferred_shading) return DeferredRenderer::getGeometryFragmentShader();
+    // 分簇光照时使用遍历簇内光源的片段着色器
+    std::string code = settings.clustered_lighting ?
+        ShaderProgram::loadGLSLlib(
+            #include "main/GLSL/box-clustered-fs.glsl"
+            ,
+            std::string(
+            #include "glsllibs/3shade2.glsl"
+            ) + ClusteredLighting::getShaderLibrary()) :
+        std::string(
+        #include "main/GLSL/box-fs.glsl"
+        );
+    // 开启阴影时再拼接级联阴影库
+    if (settings.shadow.enabled) code = ShaderProgram::loadGLSLlib(code, CascadedShadowMap::getShaderLibrary());
+    return code;
+}
+
+SceneRenderer::SceneRenderer(PostProcesser& postprocesser):
+    postprocesser(postprocesser),
+    box_shader_program(box_vertex_shader, getBoxFragmentShader(RenderSettings::getInstance())),
+    light_shader_program(light_vertex_shader, light_fragment_shader),
+    // 投射级联阴影的平行光
+    sun{
+        .direction = glm::normalize(glm::vec3(-0.4f, -1.0f, -0.3f)),
+        .ambient = glm::vec3(0.05f),
+        .diffuse = glm::vec3(0.4f),
+        .specular = glm::vec3(0.2f)
+    } {
+    const auto& settings = RenderSettings::getInstance();
+    box_shader_program.setVertexDataProperty({"position", "normal", "TexCoords"}, {3, 3, 2});
+    box_shader_program.setSequentialIndices();
+    light_shader_program.setVertexDataProperty({"position"}, {3});
+    light_shader_program.setVertices<3>(light_cube_vertices);
+    light_shader_program.setSequentialIndices();
+
+    const StrongPointLight light{
+        .position = glm::vec3(0.0f),
+        .color = glm::vec3(1.0f, 1.0f, 1.0f),
+        .ambient = glm::vec3(0.2f, 0.2f, 0.2f),
+        .diffuse = glm::vec3(0.5f, 0.5f, 0.5f),
+        .specular = glm::vec3(1.0f, 1.0f, 1.0f)
+    };
+    box_shader_program.use();
+    box_shader_program.setUniformStruct("light", light);
+    // GPU驱动模式下实例矩阵从SSBO读取, 片段着色器不变
+    if (settings.gpu_driven) {
+        gpu_driven_shader_program = std::make_unique<ShaderProgram>(
+            #include "glsllibs/gpu-driven-vs.glsl"
+            , getBoxFragmentShader(settings));
+        gpu_driven_shader_program->use();
+        gpu_driven_shader_program->setUniformStruct("light", light);
+        gpu_driven_renderer = std::make_unique<GpuDrivenRenderer>();
+    }
+    if (settings.deferred_shading) {
+        std::string lighting_lib;
+        if (settings.clustered_lighting) lighting_lib += ClusteredLighting::getShaderLibrary();
+        if (settings.shadow.enabled) lighting_lib += CascadedShadowMap::getShaderLibrary();
+        deferred_renderer = std::make_unique<DeferredRenderer>(postprocesser, lighting_lib);
+        deferred_renderer->getLightingShader().use();
+        deferred_renderer->getLightingShader().setUniformStruct("light", light);
+    }
+    if (settings.shadow.enabled) {
+        shadow_map = std::make_unique<CascadedShadowMap>(
+            settings.shadow.cascade_count, settings.shadow.resolution, settings.shadow.update_intervals,
+            settings.shadow.max_distance, settings.shadow.split_lambda);
+        box_shader_program.use();
+        box_shader_program.setUniformStruct("sun", sun);
+        if (gpu_driven_shader_program) {
+            gpu_driven_shader_program->use();
+            gpu_driven_shader_program->setUniformStruct("sun", sun);
+        }
+        if (deferred_renderer) {
+            deferred_renderer->getLightingShader().use();
+            deferred_renderer->getLightingShader().setUniformStruct("sun", sun);
+        }
+    }
+    if (settings.occlusion_culling) {
+        hiz_buffer = std::make_unique<HiZBuffer>();
+        occlusion_culling = !settings.gpu_driven;
+    }
+    if (settings.clustered_lighting) {
+        clustered_lighting = std::make_unique<ClusteredLighting>();
+        light_manager = std::make_unique<LightManager>();
+        for (int i = 0; i < settings.clustered_light_count; i++) {
+            // 余弦调色板上均匀取色, 衰减系数对应约7个单位的影响范围
+            float hue = 6.2831853f * static_cast<float>(i) / static_cast<float>(settings.clustered_light_count);
+            glm::vec3 color(0.5f + 0.5f * cos(hue), 0.5f + 0.5f * cos(hue - 2.0943951f), 0.5f + 0.5f * cos(hue + 2.0943951f));
+            point_lights.push_back({
+                .position = glm::vec3(0.0f),
+                .color = color,
+                .ambient = glm::vec3(0.02f),
+                .diffuse = glm::vec3(0.8f),
+                .specular = glm::vec3(1.0f),
+                .constant = 1.0f,
+                .linear = 0.7f,
+                .quadratic = 1.8f
+            });
+        }
+    }
+}
+
+void SceneRenderer::addModel(Model& model) {
+    models.push_back(&model);
+    model_bounds.push_back(model.getMeshBounds());
+    if (occlusion_culling) occlusion_cullers.push_back(std::make_unique<OcclusionCuller>());
+    if (gpu_driven_renderer) gpu_driven_renderer->addModel(model);
+    for (const auto& bounds : model_bounds.back()) scene_bounds.expand(bounds);
+}
+
+void SceneRenderer::resize(int width, int height) {
+    postprocesser.resize(width, height);
+    if (deferred_renderer) deferred_renderer->resize(postprocesser);
+    if (hiz_buffer) hiz_buffer->resize(width, height);
+}
+
+void SceneRenderer::addPasses(RenderGraph& graph, const Camera& camera, float alpha, float time, RenderResource output) {
+    // 摄像机位置在最近两次更新之间插值, 渲染帧率高于更新频率时移动仍然平滑
+    view = camera.computeViewMatrix(alpha);
+    projection = camera.computeProjectionMatrix();
+    view_pos = camera.getPosition(alpha);
+    near_plane = camera.getNearPlane();
+    far_plane = camera.getFarPlane();
+    this->time = time;
+    light_position = glm::vec3(2.0f * std::cos(time), 2.0f, 4.0f * std::sin(time));
+
+    auto& debug_draw = DebugDraw::getInstance();
+    if (debug_draw.isEnabled()) {
+        debug_draw.setCamera(view);
+        for (const auto& bounds : model_bounds) {
+            for (const auto& box : bounds) debug_draw.aabb(box);
+        }
+        debug_draw.sphere(light_position, 0.3f);
+        debug_draw.text3d(light_position + glm::vec3(0.0f, 0.4f, 0.0f), "light");
+    }
+
+    const TextureExtent extent = postprocesser.getExtent();
+    const TextureDesc screen_desc{GL_RGB8, extent.texture_width, extent.texture_height};
+    const RenderResource hiz = graph.importExternal("hiz");
+    const RenderResource visibility = graph.importExternal("occlusion_visibility");
+    const RenderResource shadow_cascades = graph.importExternal("shadow_cascades");
+    const RenderResource light_clusters = graph.importExternal("light_clusters");
+    const RenderResource scene_color = graph.importTexture("scene_color", postprocesser.getColorTexture(), screen_desc);
+    const RenderResource scene_depth = graph.importTexture("scene_depth", postprocesser.getDepthTexture(),
+        {GL_DEPTH_COMPONENT24, screen_desc.width, screen_desc.height});
+
+    // 用上一帧的深度金字塔剔除被遮挡的网格
+    if (occlusion_culling) {
+        graph.addPass("occlusion_cull", [=](RenderPassBuilder& builder) {
+            builder.read(hiz, Access::Manual);
+            builder.write(visibility, Access::Manual);
+        }, [this](const RenderPassContext&) {
+            for (size_t i = 0; i < models.size(); i++) occlusion_cullers[i]->cull(*hiz_buffer, model_bounds[i]);
+        });
+    }
+
+    // 阴影贴图在场景之前绘制, 只重绘过期的级联
+    if (shadow_map) {
+        graph.addPass("shadows", [=](RenderPassBuilder& builder) {
+            builder.write(shadow_cascades, Access::Manual);
+        }, [this](const RenderPassContext&) {
+            shadow_map->update(view, projection, near_plane, far_plane, sun, scene_bounds);
+            shadow_map->render([this](ShaderProgram& depth_shader, const Frustum& cascade_frustum) {
+                for (size_t i = 0; i < models.size(); i++) {
+                    shadow_visibility.resize(model_bounds[i].size());
+                    for (size_t j = 0; j < model_bounds[i].size(); j++) {
+                        shadow_visibility[j] = cascade_frustum.intersects(model_bounds[i][j]);
+                    }
+                    models[i]->Draw(depth_shader, shadow_visibility);
+                }
+            });
+        });
+    }
+
+    if (clustered_lighting) {
+        graph.addPass("light_clusters", [=](RenderPassBuilder& builder) {
+            builder.write(light_clusters, Access::Manual);
+        }, [this, extent](const RenderPassContext&) {
+            // 光源在模型周围的多层圆环上转动
+            for (size_t i = 0; i < point_lights.size(); i++) {
+                float angle = this->time * 0.5f + static_cast<float>(i) * 2.399963f;
+                float ring = 1.0f + static_cast<float>(i % 8);
+                point_lights[i].position = glm::vec3(ring * cos(angle), static_cast<float>(i % 5) - 2.0f, ring * sin(angle));
+            }
+            // 先在CPU上剔除视锥外的光源, 只上传可见的部分
+            light_manager->setLights(point_lights, {});
+            light_manager->update(Frustum::fromMatrix(projection * view));
+            visible_point_lights.clear();
+            for (unsigned int index : light_manager->getVisibleLights()) {
+                visible_point_lights.push_back(point_lights[index]);
+            }
+            clustered_lighting->setLights(visible_point_lights, {});
+            clustered_lighting->update(view, projection, near_plane, far_plane, extent.width, extent.height);
+        });
+    }
+
+    graph.addPass("scene", [=, this](RenderPassBuilder& builder) {
+        if (hiz_buffer) builder.read(occlusion_culling ? visibility : hiz, Access::Manual);
+        if (shadow_map) builder.read(shadow_cascades, Access::Manual);
+        if (clustered_lighting) builder.read(light_clusters, Access::Manual);
+        builder.write(scene_color, Access::Manual);
+        builder.write(scene_depth, Access::Manual);
+    }, [this](const RenderPassContext&) {
+        postprocesser.tobeDrawn();
+        if (deferred_renderer) deferred_renderer->beginGeometryPass();
+
+        // 渲染模型
+        if (gpu_driven_renderer) gpu_driven_renderer->cull(view, projection, view_pos, hiz_buffer.get());
+        ShaderProgram& shader = gpu_driven_renderer ? *gpu_driven_shader_program : box_shader_program;
+        shader.use();
+        shader.setVec3("light.position", light_position);
+        shader.setVec3("viewPos", view_pos);
+        shader.setMat4("view", view);
+        shader.setMat4("projection", projection);
+        if (clustered_lighting) clustered_lighting->bind(shader);
+        if (shadow_map) shadow_map->bind(shader);
+        if (gpu_driven_renderer) {
+            gpu_driven_renderer->draw(shader);
+        } else {
+            for (size_t i = 0; i < models.size(); i++) {
+                if (occlusion_culling) models[i]->Draw(shader, occlusion_cullers[i]->getVisibility());
+                else models[i]->Draw(shader);
+            }
+        }
+
+        if (deferred_renderer) {
+            ShaderProgram& lighting_shader = deferred_renderer->getLightingShader();
+            lighting_shader.use();
+            lighting_shader.setVec3("light.position", light_position);
+            if (clustered_lighting) clustered_lighting->bind(lighting_shader);
+            if (shadow_map) shadow_map->bind(lighting_shader);
+            deferred_renderer->lightingPass(view, projection, view_pos);
+        }
+    });
+
+    // 渲染光源立方体
+    graph.addPass("light_cube", [=](RenderPassBuilder& builder) {
+        builder.read(scene_depth, Access::Manual);
+        builder.write(scene_color, Access::Manual);
+    }, [this](const RenderPassContext&) {
+        glm::mat4 light_model = glm::translate(glm::mat4(1.0f), light_position);
+        light_model = glm::scale(light_model, glm::vec3(0.2f));
+        light_shader_program.use();
+        light_shader_program.setMat4("model", light_model);
+        light_shader_program.setMat4("view", view);
+        light_shader_program.setMat4("projection", projection);
+        light_shader_program.draw();
+    });
+
+    if (debug_draw.isEnabled()) {
+        graph.addPass("debug_draw", [=](RenderPassBuilder& builder) {
+            builder.read(scene_depth, Access::Manual);
+            builder.write(scene_color, Access::Manual);
+        }, [this](const RenderPassContext&) {
+            DebugDraw::getInstance().render(projection * view);
+        });
+    }
+
+    if (hiz_buffer) {
+        graph.addPass("hiz_build", [=](RenderPassBuilder& builder) {
+            builder.read(scene_depth, Access::Manual);
+            builder.write(hiz, Access::Manual);
+        }, [this, extent](const RenderPassContext&) {
+            hiz_buffer->build(postprocesser.getDepthTexture(), projection * view, extent.width, extent.height);
+        });
+    }
+
+    // 后处理的每个stage都是图中的pass, 中间目标是图的临时纹理
+    postprocesser.addPasses(graph, scene_color, scene_depth, output);
+}
+
+}
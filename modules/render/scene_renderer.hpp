@@ -0,0 +1,68 @@
+#pragma once
+#include "shader.hpp"
+#include "camera.hpp"
+#include "postprocess.hpp"
+#include "render_graph.hpp"
+#include "hiz.hpp"
+#include "gpu_driven.hpp"
+#include "clustered.hpp"
+#include "shadow.hpp"
+#include "deferred.hpp"
+#include "model/model.hpp"
+#include "model/light_manager.hpp"
+#include <glm/glm.hpp>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace lunar {
+
+// 主程序与lunar_bench共用的场景: 静态模型加上绕模型转动的光源立方体.
+// 阴影, 分簇光照, 遮挡剔除, GPU驱动与延迟着色按构造时的RenderSettings创建, 关闭的功能不分配GPU资源.
+// 每帧由addPasses声明成帧图中的pass, 最后接上后处理.
+class SceneRenderer {
+public:
+    explicit SceneRenderer(PostProcesser& postprocesser);
+    SceneRenderer(const SceneRenderer&) = delete;
+    SceneRenderer& operator=(const SceneRenderer&) = delete;
+
+    // 模型由调用者持有; 模型是静态的, 世界空间包围盒只在加入时计算一次
+    void addModel(Model& model);
+    // 窗口尺寸变化时渲染目标按需跟随
+    void resize(int width, int height);
+    // alpha为摄像机在两次更新之间的插值系数, time决定光源的位置; 图由调用者reset与执行
+    void addPasses(RenderGraph& graph, const Camera& camera, float alpha, float time, RenderResource output);
+
+private:
+    PostProcesser& postprocesser;
+    ShaderProgram box_shader_program;
+    ShaderProgram light_shader_program;
+    std::unique_ptr<ShaderProgram> gpu_driven_shader_program;
+    std::unique_ptr<DeferredRenderer> deferred_renderer;
+    std::unique_ptr<CascadedShadowMap> shadow_map;
+    std::unique_ptr<HiZBuffer> hiz_buffer;
+    std::unique_ptr<GpuDrivenRenderer> gpu_driven_renderer;
+    std::unique_ptr<ClusteredLighting> clustered_lighting;
+    std::unique_ptr<LightManager> light_manager;
+    // 在CPU上读回剔除结果, GPU驱动模式下为false
+    bool occlusion_culling{false};
+
+    std::vector<Model*> models;
+    std::vector<std::vector<AABB>> model_bounds;
+    std::vector<std::unique_ptr<OcclusionCuller>> occlusion_cullers;
+    std::vector<unsigned char> shadow_visibility;
+    AABB scene_bounds;
+    ParallelLight sun;
+    std::vector<PointLight> point_lights, visible_point_lights;
+
+    // addPasses时记下, pass执行时使用
+    glm::mat4 view{1.0f};
+    glm::mat4 projection{1.0f};
+    glm::vec3 view_pos{0.0f};
+    glm::vec3 light_position{0.0f};
+    float near_plane{0.0f};
+    float far_plane{0.0f};
+    float time{0.0f};
+};
+
+}
@@ -0,0 +1,72 @@
+#include "settings.hpp"
+#include <yaml-cpp/yaml.h>
+#include <iostream>
+
+namespace lunar {
+
+void RenderSettings::load(const std::string& config_path) {
+    try {
+        YAML::Node config = YAML::LoadFile(config_path);
+        if (!config["render_settings"]) return;
+        YAML::Node settings = config["render_settings"];
+        occlusion_culling = settings["occlusion_culling"].as<bool>(occlusion_culling);
+        gpu_driven = settings["gpu_driven"].as<bool>(gpu_driven);
+        clustered_lighting = settings["clustered_lighting"].as<bool>(clustered_lighting);
+        clustered_light_count = settings["clustered_light_count"].as<int>(clustered_light_count);
+        deferred_shading = settings["deferred_shading"].as<bool>(deferred_shading);
+        compute_blur = settings["compute_blur"].as<bool>(compute_blur);
+        debug_draw = settings["debug_draw"].as<bool>(debug_draw);
+        if (YAML::Node aa_node = settings["anti_aliasing"]) {
+            const std::string mode = aa_node.as<std::string>();
+            if (mode == "none") anti_aliasing = AntiAliasing::None;
+            else if (mode == "fxaa") anti_aliasing = AntiAliasing::FXAA;
+            else if (mode == "smaa") anti_aliasing = AntiAliasing::SMAA;
+            else std::cerr << "Unknown anti_aliasing mode: " << mode << std::endl;
+        }
+        if (YAML::Node shadow_node = settings["shadow"]) {
+            shadow.enabled = shadow_node["enabled"].as<bool>(shadow.enabled);
+            shadow.cascade_count = shadow_node["cascade_count"].as<int>(shadow.cascade_count);
+            shadow.resolution = shadow_node["resolution"].as<int>(shadow.resolution);
+            shadow.max_distance = shadow_node["max_distance"].as<float>(shadow.max_distance);
+            shadow.split_lambda = shadow_node["split_lambda"].as<float>(shadow.split_lambda);
+            shadow.update_intervals = shadow_node["update_intervals"].as<std::vector<unsigned int>>(shadow.update_intervals);
+        }
+        if (YAML::Node resolution_node = settings["dynamic_resolution"]) {
+            dynamic_resolution.enabled = resolution_node["enabled"].as<bool>(dynamic_resolution.enabled);
+            dynamic_resolution.target_ms = resolution_node["target_ms"].as<float>(dynamic_resolution.target_ms);
+            dynamic_resolution.min_scale = resolution_node["min_scale"].as<float>(dynamic_resolution.min_scale);
+            dynamic_resolution.max_scale = resolution_node["max_scale"].as<float>(dynamic_resolution.max_scale);
+            dynamic_resolution.sharpness = resolution_node["sharpness"].as<float>(dynamic_resolution.sharpness);
+        }
+        if (YAML::Node profiling_node = settings["profiling"]) {
+            profiling.gpu_profiler = profiling_node["gpu_profiler"].as<bool>(profiling.gpu_profiler);
+            profiling.cpu_tracer = profiling_node["cpu_tracer"].as<bool>(profiling.cpu_tracer);
+            profiling.report_interval = profiling_node["report_interval"].as<float>(profiling.report_interval);
+            profiling.trace_path = profiling_node["trace_path"].as<std::string>(profiling.trace_path);
+            profiling.hitch_threshold = profiling_node["hitch_threshold"].as<float>(profiling.hitch_threshold);
+            profiling.hitch_min_ms = profiling_node["hitch_min_ms"].as<float>(profiling.hitch_min_ms);
+            profiling.hitch_directory = profiling_node["hitch_directory"].as<std::string>(profiling.hitch_directory);
+        }
+        if (YAML::Node chain = settings["post_process"]) {
+            post_process.clear();
+            for (const auto& item : chain) {
+                PostProcessPassConfig pass;
+                if (item.IsScalar()) {
+                    pass.name = item.as<std::string>();
+                } else {
+                    for (const auto& entry : item) {
+                        const std::string key = entry.first.as<std::string>();
+                        if (key == "pass") pass.name = entry.second.as<std::string>();
+                        else if (key == "enabled") pass.enabled = entry.second.as<bool>();
+                        else pass.params[key] = entry.second.as<float>();
+                    }
+                }
+                post_process.push_back(pass);
+            }
+        }
+    } catch (const YAML::Exception& e) {
+        std::cerr << "Error loading render settings: " << e.what() << std::endl;
+    }
+}
+
+}
@@ -0,0 +1,85 @@
+#pragma once
+#include <map>
+#include <string>
+#include <vector>
+
+namespace lunar {
+
+// render_settings.shadow一节
+struct ShadowSettings {
+    bool enabled{false};
+    int cascade_count{4};
+    int resolution{2048};
+    float max_distance{50.0f};
+    float split_lambda{0.75f};
+    // 每个级联最少间隔多少帧重绘一次
+    std::vector<unsigned int> update_intervals{1, 1, 2, 4};
+};
+
+// render_settings.dynamic_resolution一节
+struct DynamicResolutionSettings {
+    bool enabled{false};
+    // GPU帧时间的预算, 毫秒
+    float target_ms{16.0f};
+    float min_scale{0.5f};
+    float max_scale{1.0f};
+    // 放大之后的锐化强度, 0到1
+    float sharpness{0.5f};
+};
+
+// render_settings.profiling一节
+struct ProfilingSettings {
+    // 用时间戳查询记录每个pass的GPU耗时
+    bool gpu_profiler{false};
+    // 收集LUNAR_PROFILE_SCOPE记录的CPU区间, 需要编译时打开LUNAR_PROFILING
+    bool cpu_tracer{false};
+    // 每隔多少秒在控制台打印一次统计, 0为不打印
+    float report_interval{0.0f};
+    // 退出时写出的Chrome trace文件, 为空时不写
+    std::string trace_path;
+    // 帧时间超过最近帧中位数的多少倍时写出卡顿前后的trace, 0为关闭
+    float hitch_threshold{0.0f};
+    // 短于此值的帧不算卡顿, 避免极高帧率下的正常波动
+    float hitch_min_ms{0.0f};
+    std::string hitch_directory{"."};
+};
+
+// 后处理链末尾的抗锯齿: FXAA开销最低, SMAA质量更高
+enum class AntiAliasing {
+    None,
+    FXAA,
+    SMAA
+};
+
+// render_settings.post_process中的一项, 除pass与enabled以外的键都作为该pass的参数
+struct PostProcessPassConfig {
+    std::string name;
+    bool enabled{true};
+    std::map<std::string, float> params;
+};
+
+// interface.yaml中render_settings一节, 缺省的键保持默认值
+struct RenderSettings {
+    bool occlusion_culling{true};
+    bool gpu_driven{false};
+    bool clustered_lighting{false};
+    int clustered_light_count{256};
+    bool deferred_shading{false};
+    bool compute_blur{false};
+    // 调试线框, 运行时可以用按键切换
+    bool debug_draw{false};
+    AntiAliasing anti_aliasing{AntiAliasing::None};
+    ShadowSettings shadow;
+    DynamicResolutionSettings dynamic_resolution;
+    ProfilingSettings profiling;
+    // 为空时使用PostProcesser的默认后处理链
+    std::vector<PostProcessPassConfig> post_process;
+
+    static RenderSettings& getInstance() {
+        static RenderSettings instance;
+        return instance;
+    }
+    void load(const std::string& config_path);
+};
+
+}
@@ -53,6 +53,15 @@ namespace lunar {
     void ShaderProgram::draw() const {
         glUseProgram(program_id);
         glDrawElements(GL_TRIANGLES, ebo_indices.size(), GL_UNSIGNED_INT, 0);
+        LUNAR_PROFILE_COUNT(DrawCalls, 1);
+        LUNAR_PROFILE_COUNT(Triangles, ebo_indices.size() / 3);
+    }
+
+    void ShaderProgram::dispatch(unsigned int groups_x, unsigned int groups_y, unsigned int groups_z) const {
+        if (!compute_shader) throw std::runtime_error("dispatch requires a compute shader");
+        glUseProgram(program_id);
+        glDispatchCompute(groups_x, groups_y, groups_z);
+        LUNAR_PROFILE_COUNT(Dispatches, 1);
     }
 
     void ShaderProgram::use() const {
@@ -145,6 +154,10 @@ namespace lunar {
         glUniform1i(glGetUniformLocation(program_id, name.c_str()), value);
     }
 
+    void ShaderProgram::setUInt(const std::string &name, unsigned int value) const {
+        glUniform1ui(glGetUniformLocation(program_id, name.c_str()), value);
+    }
+
     void ShaderProgram::setFloat(const std::string &name, float value) const {
         glUniform1f(glGetUniformLocation(program_id, name.c_str()), value);
     }
@@ -157,6 +170,10 @@ namespace lunar {
         glUniformMatrix3fv(glGetUniformLocation(program_id, name.c_str()), 1, GL_FALSE, glm::value_ptr(mat));
     }
 
+    void ShaderProgram::setVec2(const std::string &name, const glm::vec2 &vec) const {
+        glUniform2fv(glGetUniformLocation(program_id, name.c_str()), 1, glm::value_ptr(vec));
+    }
+
     void ShaderProgram::setVec3(const std::string &name, const glm::vec3 &vec) const {
         glUniform3fv(glGetUniformLocation(program_id, name.c_str()), 1, glm::value_ptr(vec));
     }
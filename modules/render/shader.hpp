@@ -5,6 +5,7 @@
 #include <glm/gtc/type_ptr.hpp> 
 #include <type_traits>
 #include "model/texture.hpp"
+#include "profile/profile_scope.hpp"
 
 namespace lunar {
 
@@ -35,6 +36,7 @@ public:
     ~ShaderProgram();
     void use() const;
     void draw() const;
+    void dispatch(unsigned int groups_x, unsigned int groups_y = 1, unsigned int groups_z = 1) const;
     static std::string loadGLSLlib(const std::string& source_code, const std::string& lib_code);
     void setIndices(std::vector<unsigned int> indices);
     void setSequentialIndices();
@@ -51,6 +53,7 @@ public:
     }
     void setVertexDataProperty(std::vector<std::string> names, std::vector<unsigned int> sizes);
     void setInt(const std::string &name, int value) const;
+    void setUInt(const std::string &name, unsigned int value) const;
     void setFloat(const std::string &name, float value) const;
     void setVec2(const std::string &name, const glm::vec2 &vec) const;
     void setVec3(const std::string &name, const glm::vec3 &vec) const;
@@ -65,6 +68,7 @@ public:
     // 通用结构体设置模板
     template<typename T>
     void setUniformStruct(const std::string& name, const T& data) {
+        LUNAR_PROFILE_SCOPE("upload uniform struct");
         if constexpr (std::is_same_v<T, Material>) {
             setVec3(name + ".ambient", data.ambient);
             setVec3(name + ".diffuse", data.diffuse);
@@ -83,6 +87,12 @@ public:
             setVec3(name + ".diffuse", data.diffuse);
             setVec3(name + ".specular", data.specular);
         }
+        else if constexpr (std::is_same_v<T, ParallelLight>) {
+            setVec3(name + ".direction", data.direction);
+            setVec3(name + ".ambient", data.ambient);
+            setVec3(name + ".diffuse", data.diffuse);
+            setVec3(name + ".specular", data.specular);
+        }
         else {
             static_assert(always_false<T>::value, "Unsupported uniform struct type");
         }
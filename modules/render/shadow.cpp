@@ -0,0 +1,206 @@
+#include "shadow.hpp"
+#include <glm/gtc/matrix_transform.hpp>
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace lunar {
+
+static const std::string shadow_depth_vertex_shader =
+#include "glsllibs/shadow-depth-vs.glsl"
+;
+static const std::string shadow_depth_fragment_shader =
+#include "glsllibs/shadow-depth-fs.glsl"
+;
+static const std::string csm_shadow_lib =
+#include "glsllibs/csm-shadow.glsl"
+;
+
+CascadedShadowMap::CascadedShadowMap(unsigned int cascade_count, unsigned int resolution,
+                                     std::vector<unsigned int> update_intervals, float max_distance, float split_lambda):
+    depth_shader(shadow_depth_vertex_shader, shadow_depth_fragment_shader),
+    resolution(resolution), max_distance(max_distance), split_lambda(split_lambda) {
+    if (cascade_count == 0 || cascade_count > max_cascades) {
+        throw std::runtime_error("Cascade count must be between 1 and " + std::to_string(max_cascades));
+    }
+    cascades.resize(cascade_count);
+    for (unsigned int i = 0; i < cascade_count; i++) {
+        if (i < update_intervals.size()) cascades[i].update_interval = std::max(update_intervals[i], 1u);
+    }
+
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, texture);
+    glTexStorage3D(GL_TEXTURE_2D_ARRAY, 1, GL_DEPTH_COMPONENT32F, resolution, resolution, cascade_count);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
+    float borderColor[] = { 1.0f, 1.0f, 1.0f, 1.0f };
+    glTexParameterfv(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_BORDER_COLOR, borderColor);
+    // 采样时由硬件比较深度
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_COMPARE_MODE, GL_COMPARE_REF_TO_TEXTURE);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_COMPARE_FUNC, GL_LEQUAL);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+
+    glGenFramebuffers(1, &framebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, texture, 0, 0);
+    glDrawBuffer(GL_NONE);
+    glReadBuffer(GL_NONE);
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+        throw std::runtime_error("Shadow framebuffer is not complete");
+    }
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+CascadedShadowMap::~CascadedShadowMap() {
+    glDeleteFramebuffers(1, &framebuffer);
+    glDeleteTextures(1, &texture);
+}
+
+std::string CascadedShadowMap::getShaderLibrary() {
+    return csm_shadow_lib;
+}
+
+void CascadedShadowMap::invalidate() {
+    for (auto& cascade : cascades) cascade.stale = true;
+}
+
+void CascadedShadowMap::update(const glm::mat4& view, const glm::mat4& projection, float z_near, float z_far,
+                               const ParallelLight& light, const AABB& scene_bounds) {
+    frame++;
+    if (glm::length(light.direction) == 0.0f) return;
+    const float shadow_far = std::min(z_far, max_distance);
+    const unsigned int count = getCascadeCount();
+
+    // 视锥8个角点: 前4个在近平面, 后4个在远平面
+    const glm::mat4 inverse_view_projection = glm::inverse(projection * view);
+    glm::vec3 near_corners[4], far_corners[4];
+    for (int i = 0; i < 4; i++) {
+        glm::vec2 ndc((i & 1) ? 1.0f : -1.0f, (i & 2) ? 1.0f : -1.0f);
+        glm::vec4 near_point = inverse_view_projection * glm::vec4(ndc, -1.0f, 1.0f);
+        glm::vec4 far_point = inverse_view_projection * glm::vec4(ndc, 1.0f, 1.0f);
+        near_corners[i] = glm::vec3(near_point) / near_point.w;
+        far_corners[i] = glm::vec3(far_point) / far_point.w;
+    }
+
+    // 光源空间只取决于光的方向, 与相机无关
+    const glm::vec3 direction = glm::normalize(light.direction);
+    const glm::vec3 up = std::abs(direction.y) > 0.99f ? glm::vec3(0.0f, 0.0f, 1.0f) : glm::vec3(0.0f, 1.0f, 0.0f);
+    const glm::mat4 light_view = glm::lookAt(glm::vec3(0.0f), direction, up);
+
+    // 深度范围覆盖整个场景, 视锥外但挡在光源前的物体也会被绘制
+    float scene_min_z = 0.0f, scene_max_z = 0.0f;
+    if (scene_bounds.isValid()) {
+        AABB light_space_bounds = scene_bounds.transform(light_view);
+        scene_min_z = light_space_bounds.min.z;
+        scene_max_z = light_space_bounds.max.z;
+    }
+
+    // 对数与均匀划分的混合
+    float split_near = z_near;
+    for (unsigned int i = 0; i < count; i++) {
+        float p = static_cast<float>(i + 1) / static_cast<float>(count);
+        float log_split = z_near * std::pow(shadow_far / z_near, p);
+        float uniform_split = z_near + (shadow_far - z_near) * p;
+        float split_far = split_lambda * log_split + (1.0f - split_lambda) * uniform_split;
+
+        // 角点沿视锥的棱线性插值
+        float t0 = (split_near - z_near) / (z_far - z_near);
+        float t1 = (split_far - z_near) / (z_far - z_near);
+        glm::vec3 corners[8];
+        glm::vec3 center(0.0f);
+        for (int j = 0; j < 4; j++) {
+            corners[j] = near_corners[j] + (far_corners[j] - near_corners[j]) * t0;
+            corners[j + 4] = near_corners[j] + (far_corners[j] - near_corners[j]) * t1;
+            center += corners[j] + corners[j + 4];
+        }
+        center /= 8.0f;
+        float radius = 0.0f;
+        for (const auto& corner : corners) radius = std::max(radius, glm::length(corner - center));
+        // 半径只与投影有关, 取整消除浮点误差, 保证相机旋转时尺寸不变
+        radius = std::ceil(radius * 16.0f) / 16.0f;
+
+        // 中心对齐到纹素网格, 相机平移时阴影边缘不会抖动
+        const float texel_size = 2.0f * radius / static_cast<float>(resolution);
+        glm::vec3 light_center = glm::vec3(light_view * glm::vec4(center, 1.0f));
+        light_center.x = std::floor(light_center.x / texel_size) * texel_size;
+        light_center.y = std::floor(light_center.y / texel_size) * texel_size;
+
+        float min_z = scene_min_z, max_z = scene_max_z;
+        if (!scene_bounds.isValid()) {
+            // 没有场景信息时按半径对齐, 减少矩阵变化
+            min_z = std::floor((light_center.z - radius) / radius) * radius;
+            max_z = std::ceil((light_center.z + radius) / radius) * radius;
+        }
+        const glm::mat4 light_projection = glm::ortho(light_center.x - radius, light_center.x + radius,
+                                                      light_center.y - radius, light_center.y + radius,
+                                                      -max_z - 0.5f, -min_z + 0.5f);
+
+        Cascade& cascade = cascades[i];
+        cascade.target = light_projection * light_view;
+        cascade.target_texel_size = texel_size;
+        cascade.split_far = split_far;
+        split_near = split_far;
+    }
+}
+
+bool CascadedShadowMap::needsRender(const Cascade& cascade) const {
+    // invalidate之后不等更新间隔, 下一次render就重绘
+    if (!cascade.valid || cascade.stale) return true;
+    if (cascade.target == cascade.light_view_projection) return false;
+    // 远处的级联可以降低更新频率
+    return frame - cascade.last_rendered_frame >= cascade.update_interval;
+}
+
+void CascadedShadowMap::render(const CasterCallback& draw_casters) {
+    rendered_cascades = 0;
+    int previous_framebuffer = 0;
+    int previous_viewport[4];
+    glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &previous_framebuffer);
+    glGetIntegerv(GL_VIEWPORT, previous_viewport);
+
+    for (unsigned int i = 0; i < getCascadeCount(); i++) {
+        Cascade& cascade = cascades[i];
+        if (!needsRender(cascade)) continue;
+        if (rendered_cascades == 0) {
+            glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+            glViewport(0, 0, resolution, resolution);
+            glEnable(GL_DEPTH_TEST);
+            glEnable(GL_POLYGON_OFFSET_FILL);
+            glPolygonOffset(2.0f, 4.0f);
+            depth_shader.use();
+        }
+        glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, texture, 0, i);
+        glClear(GL_DEPTH_BUFFER_BIT);
+        depth_shader.setMat4("lightViewProjection", cascade.target);
+        draw_casters(depth_shader, Frustum::fromMatrix(cascade.target));
+
+        cascade.light_view_projection = cascade.target;
+        cascade.texel_size = cascade.target_texel_size;
+        cascade.last_rendered_frame = frame;
+        cascade.valid = true;
+        cascade.stale = false;
+        rendered_cascades++;
+    }
+
+    if (rendered_cascades > 0) {
+        glDisable(GL_POLYGON_OFFSET_FILL);
+        glBindFramebuffer(GL_FRAMEBUFFER, previous_framebuffer);
+        glViewport(previous_viewport[0], previous_viewport[1], previous_viewport[2], previous_viewport[3]);
+    }
+}
+
+void CascadedShadowMap::bind(const ShaderProgram& shader, int texture_unit) const {
+    glActiveTexture(GL_TEXTURE0 + texture_unit);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, texture);
+    shader.setInt("shadowMap", texture_unit);
+    shader.setInt("shadowCascadeCount", static_cast<int>(getCascadeCount()));
+    for (unsigned int i = 0; i < getCascadeCount(); i++) {
+        const std::string index = "[" + std::to_string(i) + "]";
+        shader.setMat4("shadowMatrices" + index, cascades[i].light_view_projection);
+        shader.setFloat("shadowTexelSizes" + index, cascades[i].texel_size);
+    }
+}
+
+}
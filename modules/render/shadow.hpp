@@ -0,0 +1,77 @@
+#pragma once
+#include "shader.hpp"
+#include "model/bounds.hpp"
+#include "model/material.hpp"
+#include <glm/glm.hpp>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace lunar {
+
+// 平行光的级联阴影贴图, 所有级联存放在同一个深度纹理数组中.
+// 每个级联用包围球拟合视锥的一段, 并把中心对齐到纹素网格, 相机平移旋转时阴影不会闪烁;
+// 对齐后矩阵不变且静态投影物没有变化的级联不会重绘.
+// 片段着色器需要加载glsllibs/csm-shadow.glsl.
+class CascadedShadowMap {
+public:
+    static constexpr unsigned int max_cascades = 4;
+    // 用传入的深度着色器绘制视锥内的投影物, 着色器已处于使用状态, 需要设置的只有model矩阵
+    using CasterCallback = std::function<void(ShaderProgram& depth_shader, const Frustum& cascade_frustum)>;
+
+    // update_intervals[i]为第i个级联最少间隔多少帧重绘一次, 缺省为每帧
+    explicit CascadedShadowMap(unsigned int cascade_count = 4, unsigned int resolution = 2048,
+                               std::vector<unsigned int> update_intervals = {},
+                               float max_distance = 50.0f, float split_lambda = 0.75f);
+    ~CascadedShadowMap();
+    CascadedShadowMap(const CascadedShadowMap&) = delete;
+    CascadedShadowMap& operator=(const CascadedShadowMap&) = delete;
+
+    // 静态投影物移动或增删后调用, 所有级联都会重绘
+    void invalidate();
+    // 计算各级联的光源矩阵, scene_bounds为所有投影物的包围盒
+    void update(const glm::mat4& view, const glm::mat4& projection, float z_near, float z_far,
+                const ParallelLight& light, const AABB& scene_bounds);
+    // 重绘需要更新的级联, 会恢复之前的帧缓冲与视口
+    void render(const CasterCallback& draw_casters);
+    // 设置csm-shadow.glsl需要的纹理与uniform, shader需要处于使用状态
+    void bind(const ShaderProgram& shader, int texture_unit = 8) const;
+
+    [[nodiscard]] unsigned int getCascadeCount() const { return static_cast<unsigned int>(cascades.size()); }
+    [[nodiscard]] unsigned int getResolution() const { return resolution; }
+    [[nodiscard]] unsigned int getTexture() const { return texture; }
+    [[nodiscard]] const glm::mat4& getLightViewProjection(unsigned int cascade) const { return cascades[cascade].light_view_projection; }
+    [[nodiscard]] float getSplitDistance(unsigned int cascade) const { return cascades[cascade].split_far; }
+    // 上一次render中实际重绘的级联数
+    [[nodiscard]] unsigned int getRenderedCascadeCount() const { return rendered_cascades; }
+
+    // 片段着色器需要拼接的GLSL库
+    static std::string getShaderLibrary();
+
+private:
+    struct Cascade {
+        glm::mat4 light_view_projection{1.0f};  // 纹理中现有内容对应的矩阵
+        glm::mat4 target{1.0f};                 // 本帧计算出的矩阵
+        float split_far{0.0f};
+        float texel_size{0.0f};
+        float target_texel_size{0.0f};
+        unsigned int update_interval{1};
+        unsigned long long last_rendered_frame{0};
+        bool valid{false};
+        bool stale{true};                        // 静态投影物在上次绘制之后发生了变化
+    };
+
+    [[nodiscard]] bool needsRender(const Cascade& cascade) const;
+
+    ShaderProgram depth_shader;
+    unsigned int resolution;
+    float max_distance;
+    float split_lambda;
+    std::vector<Cascade> cascades;
+    unsigned long long frame{0};
+    unsigned int rendered_cascades{0};
+    unsigned int texture;
+    unsigned int framebuffer;
+};
+
+}
@@ -0,0 +1,99 @@
+#include "upscaler.hpp"
+#include <algorithm>
+#include <glm/glm.hpp>
+
+namespace lunar {
+
+static const std::string fullscreen_vertex_shader =
+#include "glsllibs/postprocess-vs.glsl"
+;
+static const std::string upscale_fragment_shader =
+#include "glsllibs/upscale-fs.glsl"
+;
+static const std::string sharpen_fragment_shader =
+#include "glsllibs/sharpen-fs.glsl"
+;
+
+static void setFullscreenQuad(ShaderProgram& program) {
+    program.setVertices<4>({
+        {-1.0f,  1.0f,  0.0f, 1.0f},
+        {-1.0f, -1.0f,  0.0f, 0.0f},
+        { 1.0f, -1.0f,  1.0f, 0.0f},
+        {-1.0f,  1.0f,  0.0f, 1.0f},
+        { 1.0f, -1.0f,  1.0f, 0.0f},
+        { 1.0f,  1.0f,  1.0f, 1.0f}
+    });
+    program.setVertexDataProperty({"position", "TexCoords"}, {2, 2});
+    program.setIndices({0, 1, 2, 3, 4, 5});
+}
+
+// 设置读取input有效区域所需的uniform, 着色器已处于使用状态
+static void bindInput(const ShaderProgram& program, unsigned int texture, const TextureExtent& extent) {
+    const glm::vec2 texture_size(static_cast<float>(extent.texture_width), static_cast<float>(extent.texture_height));
+    const glm::vec2 size(static_cast<float>(extent.width), static_cast<float>(extent.height));
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    program.setInt("inputTexture", 0);
+    program.setVec2("uvScale", size / texture_size);
+    program.setVec2("inputTexelSize", 1.0f / texture_size);
+    program.setVec2("inputUvMax", (size - 0.5f) / texture_size);
+}
+
+SpatialUpscaler::SpatialUpscaler(float sharpness):
+    upscale_shader(fullscreen_vertex_shader, upscale_fragment_shader),
+    sharpen_shader(fullscreen_vertex_shader, sharpen_fragment_shader),
+    sharpness(sharpness) {
+    setFullscreenQuad(upscale_shader);
+    setFullscreenQuad(sharpen_shader);
+}
+
+void SpatialUpscaler::upscale(unsigned int input_texture, const TextureExtent& input, unsigned int output_framebuffer,
+                              int output_width, int output_height, RenderTargetPool& pool) {
+    // 中间结果与输入同样按纹理尺寸申请, 窗口尺寸不变时总是命中池里的同一个目标
+    const int texture_width = std::max(input.texture_width, output_width);
+    const int texture_height = std::max(input.texture_height, output_height);
+    RenderTarget upscaled = pool.acquire(GL_RGBA8, texture_width, texture_height);
+    drawUpscale(input_texture, input, upscaled.framebuffer, output_width, output_height);
+    drawSharpen(upscaled.texture, {output_width, output_height, texture_width, texture_height}, output_framebuffer);
+    pool.release(upscaled);
+}
+
+void SpatialUpscaler::addPasses(RenderGraph& graph, RenderResource input_texture, const TextureExtent& input, RenderResource output,
+                                int output_width, int output_height) {
+    const TextureExtent upscaled_extent{output_width, output_height, std::max(input.texture_width, output_width),
+                                        std::max(input.texture_height, output_height)};
+    const RenderResource upscaled = graph.createTexture("upscaled", {GL_RGBA8, upscaled_extent.texture_width, upscaled_extent.texture_height});
+    graph.addPass("upscale", [&](RenderPassBuilder& builder) {
+        builder.read(input_texture);
+        builder.write(upscaled);
+    }, [this, input_texture, input, output_width, output_height](const RenderPassContext& context) {
+        drawUpscale(context.getTexture(input_texture), input, context.getFramebuffer(), output_width, output_height);
+    });
+    graph.addPass("sharpen", [&](RenderPassBuilder& builder) {
+        builder.read(upscaled);
+        builder.write(output);
+    }, [this, upscaled, upscaled_extent](const RenderPassContext& context) {
+        drawSharpen(context.getTexture(upscaled), upscaled_extent, context.getFramebuffer());
+    });
+}
+
+void SpatialUpscaler::drawUpscale(unsigned int input_texture, const TextureExtent& input, unsigned int framebuffer,
+                                  int output_width, int output_height) {
+    glDisable(GL_DEPTH_TEST);
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    glViewport(0, 0, output_width, output_height);
+    upscale_shader.use();
+    bindInput(upscale_shader, input_texture, input);
+    upscale_shader.draw();
+}
+
+void SpatialUpscaler::drawSharpen(unsigned int upscaled_texture, const TextureExtent& upscaled, unsigned int output_framebuffer) {
+    glBindFramebuffer(GL_FRAMEBUFFER, output_framebuffer);
+    glViewport(0, 0, upscaled.width, upscaled.height);
+    sharpen_shader.use();
+    bindInput(sharpen_shader, upscaled_texture, upscaled);
+    sharpen_shader.setFloat("sharpness", sharpness);
+    sharpen_shader.draw();
+}
+
+}
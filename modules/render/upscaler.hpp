@@ -0,0 +1,32 @@
+#pragma once
+#include "shader.hpp"
+#include "render_target.hpp"
+#include "render_graph.hpp"
+
+namespace lunar {
+
+// 空间放大: 边缘自适应的双三次放大到输出分辨率, 再做一次对比度自适应锐化补偿放大损失的细节
+class SpatialUpscaler {
+public:
+    explicit SpatialUpscaler(float sharpness = 0.5f);
+
+    // 把input的有效区域放大到output_framebuffer左下角output_width x output_height的区域, 中间结果来自pool
+    void upscale(unsigned int input_texture, const TextureExtent& input, unsigned int output_framebuffer,
+                 int output_width, int output_height, RenderTargetPool& pool);
+    // 同上, 放大与锐化作为帧图中的两个pass, 中间结果是图的临时纹理
+    void addPasses(RenderGraph& graph, RenderResource input_texture, const TextureExtent& input, RenderResource output,
+                   int output_width, int output_height);
+
+    void setSharpness(float sharpness) { this->sharpness = sharpness; }
+    [[nodiscard]] float getSharpness() const { return sharpness; }
+
+private:
+    void drawUpscale(unsigned int input_texture, const TextureExtent& input, unsigned int framebuffer, int output_width, int output_height);
+    void drawSharpen(unsigned int upscaled_texture, const TextureExtent& upscaled, unsigned int output_framebuffer);
+
+    ShaderProgram upscale_shader;
+    ShaderProgram sharpen_shader;
+    float sharpness;
+};
+
+}
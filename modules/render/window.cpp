@@ -1,10 +1,19 @@
 #include "window.hpp"
 #include <yaml-cpp/yaml.h>
 #include "interface/interface.hpp"
+#include "image.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
 #include <stdexcept>
 
 namespace lunar {
     Window::~Window() {
+        if (framebuffer) {
+            glDeleteFramebuffers(1, &framebuffer);
+            glDeleteRenderbuffers(1, &color_renderbuffer);
+            glDeleteRenderbuffers(1, &depth_renderbuffer);
+        }
         if (window) {
             glfwDestroyWindow(window);
         }
@@ -18,9 +27,11 @@ namespace lunar {
         this->height = height;
         this->title = title;
         this->isFullscreen = isFullscreen;
+        resolveBackend();
         initGLFW();
         initWindow();
         initGLAD();
+        initFramebuffer();
         initialized = true;
     }
 
@@ -30,20 +41,59 @@ namespace lunar {
         this->default_width = this->width = config["window_settings"]["width"].as<int>();
         this->default_height = this->height = config["window_settings"]["height"].as<int>();
         this->isFullscreen = config["window_settings"]["isFullscreen"].as<bool>();
+        if (config["window_settings"]["backend"]) {
+            this->backend = parseBackend(config["window_settings"]["backend"].as<std::string>());
+        }
+        resolveBackend();
         initGLFW();
         initWindow();
         initGLAD();
+        initFramebuffer();
         initialized = true;
     }
 
+    WindowBackend Window::parseBackend(const std::string& name) {
+        std::string lower = name;
+        std::transform(lower.begin(), lower.end(), lower.begin(), [](unsigned char c) { return std::tolower(c); });
+        if (lower == "glfw" || lower == "window" || lower == "0" || lower == "false") return WindowBackend::Glfw;
+        if (lower == "egl" || lower == "headless" || lower == "1" || lower == "true") return WindowBackend::HeadlessEGL;
+        if (lower == "osmesa") return WindowBackend::HeadlessOSMesa;
+        throw std::runtime_error("Unknown window backend: " + name);
+    }
+
+    void Window::resolveBackend() {
+        const char* env = std::getenv("LUNAR_HEADLESS");
+        if (env && *env) {
+            backend = parseBackend(env);
+        }
+        if (isHeadless()) {
+            // 离屏帧缓冲就是全部画面, 全屏没有意义
+            isFullscreen = false;
+        }
+    }
+
     void Window::initGLFW() {
+#if GLFW_VERSION_MAJOR > 3 || (GLFW_VERSION_MAJOR == 3 && GLFW_VERSION_MINOR >= 4)
+        // 空平台不连接任何显示服务器, 但时间, 输入回调等其余接口照常可用
+        glfwInitHint(GLFW_PLATFORM, isHeadless() ? GLFW_PLATFORM_NULL : GLFW_ANY_PLATFORM);
+#else
+        if (isHeadless()) {
+            throw std::runtime_error("Headless rendering requires GLFW 3.4 or newer");
+        }
+#endif
         if (!glfwInit()) {
-            throw std::runtime_error("Failed to initialize GLFW");
+            throw std::runtime_error(isHeadless() ? "Failed to initialize GLFW null platform" : "Failed to initialize GLFW");
         }
 
         glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
         glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
         glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+        if (isHeadless()) {
+            // EGL在空平台上使用EGL_MESA_platform_surfaceless; OSMesa完全在CPU上软件渲染
+            glfwWindowHint(GLFW_CONTEXT_CREATION_API,
+                backend == WindowBackend::HeadlessOSMesa ? GLFW_OSMESA_CONTEXT_API : GLFW_EGL_CONTEXT_API);
+            glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+        }
     }
 
     void Window::initWindow() {
@@ -56,9 +106,18 @@ namespace lunar {
         }
         if (!window) {
             glfwTerminate();
-            throw std::runtime_error("Failed to create GLFW window");
+            throw std::runtime_error(isHeadless() ? "Failed to create headless GL 4.3 context" : "Failed to create GLFW window");
         }
         glfwMakeContextCurrent(window);
+        // 以帧缓冲的实际尺寸为准, 高DPI屏幕上与窗口坐标不同; 渲染目标由PostProcesser::resize按需跟随
+        glfwGetFramebufferSize(window, &width, &height);
+        glfwSetFramebufferSizeCallback(window, [](GLFWwindow*, int width, int height) {
+            // 最小化时尺寸为0, 保留之前的尺寸
+            if (width <= 0 || height <= 0) return;
+            Window& instance = getInstance();
+            instance.width = width;
+            instance.height = height;
+        });
     }
 
     void Window::initGLAD() {
@@ -67,20 +126,70 @@ namespace lunar {
         }
     }
 
+    void Window::initFramebuffer() {
+        if (!isHeadless()) return;
+        // 渲染到与请求尺寸一致的离屏帧缓冲, 格式与窗口的默认帧缓冲相同
+        glGenRenderbuffers(1, &color_renderbuffer);
+        glBindRenderbuffer(GL_RENDERBUFFER, color_renderbuffer);
+        glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+        glGenRenderbuffers(1, &depth_renderbuffer);
+        glBindRenderbuffer(GL_RENDERBUFFER, depth_renderbuffer);
+        glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, width, height);
+        glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+        glGenFramebuffers(1, &framebuffer);
+        glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, color_renderbuffer);
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, depth_renderbuffer);
+        if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+            throw std::runtime_error("Headless framebuffer is not complete");
+        }
+        // 不经过PostProcesser直接绘制的程序(测试, 示例)也画到离屏帧缓冲里
+        glViewport(0, 0, width, height);
+    }
+
+    void Window::pollEvents() {
+        glfwPollEvents();
+        Interface::getInstance().flushMouseMotion();
+    }
+
+    std::vector<unsigned char> Window::readPixels() const {
+        std::vector<unsigned char> pixels(static_cast<size_t>(width) * static_cast<size_t>(height) * 4);
+        GLint previous_framebuffer = 0, previous_read_buffer = GL_BACK, previous_alignment = 4;
+        glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &previous_framebuffer);
+        glGetIntegerv(GL_PACK_ALIGNMENT, &previous_alignment);
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, framebuffer);
+        // 读缓冲是帧缓冲自身的状态, 在切回之前恢复
+        glGetIntegerv(GL_READ_BUFFER, &previous_read_buffer);
+        glReadBuffer(isHeadless() ? GL_COLOR_ATTACHMENT0 : GL_BACK);
+        glPixelStorei(GL_PACK_ALIGNMENT, 1);
+        glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+        glPixelStorei(GL_PACK_ALIGNMENT, previous_alignment);
+        glReadBuffer(static_cast<GLenum>(previous_read_buffer));
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, previous_framebuffer);
+        flipRows(pixels, width, height);
+        return pixels;
+    }
+
     void Window::fullscreen(const Event& event) {
+        if (isHeadless()) return;
         GLFWmonitor* monitor = glfwGetPrimaryMonitor();
         const GLFWvidmode* mode = glfwGetVideoMode(monitor);
         width = mode->width;
         height = mode->height;
         glfwSetWindowMonitor(window, monitor, 0, 0, mode->width, mode->height, mode->refreshRate);
+        glfwGetFramebufferSize(window, &width, &height);
         glViewport(0, 0, width, height);
         isFullscreen = true;
     }
 
     void Window::windowed(const Event& event) {
+        if (isHeadless()) return;
         width = default_width;
         height = default_height;
         glfwSetWindowMonitor(window, nullptr, 0, 0, width, height, GLFW_DONT_CARE);
+        glfwGetFramebufferSize(window, &width, &height);
+        glViewport(0, 0, width, height);
         isFullscreen = false;
     }
 } 
\ No newline at end of file
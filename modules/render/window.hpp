@@ -7,6 +7,15 @@
 
 namespace lunar {
     struct Event;
+
+    // Glfw为普通窗口; 两种无头模式不需要显示器, 在GLFW的空平台上通过EGL(surfaceless)或OSMesa创建上下文,
+    // 渲染到给定尺寸的离屏帧缓冲. 用于基准测试与回归测试
+    enum class WindowBackend {
+        Glfw,
+        HeadlessEGL,
+        HeadlessOSMesa
+    };
+
     class Window {
     public:
         Window(const Window&) = delete;
@@ -22,14 +31,30 @@ namespace lunar {
         void init(int width, int height, const std::string& title, bool isFullscreen = false);
         void init(std::string config_path);
 
+        // 在init之前调用; 环境变量LUNAR_HEADLESS(egl, osmesa, window)优先于这里与配置文件中的设置
+        void setBackend(WindowBackend backend) { this->backend = backend; }
+        [[nodiscard]] WindowBackend getBackend() const { return backend; }
+        [[nodiscard]] bool isHeadless() const { return backend != WindowBackend::Glfw; }
+        // "glfw"/"window", "egl", "osmesa"; 无法识别时抛出异常
+        static WindowBackend parseBackend(const std::string& name);
+
         [[nodiscard]] bool shouldClose() const { return glfwWindowShouldClose(window); }
-        void swapBuffers() const { glfwSwapBuffers(window); }
+        // 无头模式没有可交换的缓冲区, 只提交命令
+        void swapBuffers() const {
+            if (isHeadless()) glFlush();
+            else glfwSwapBuffers(window);
+        }
 
-        void pollEvents() { glfwPollEvents();}
+        // 处理窗口系统的事件, 并把这次累积的鼠标移动合并成一个事件放入Interface的队列
+        void pollEvents();
 
         [[nodiscard]] GLFWwindow* getHandle() const { return window; }
         int getWidth() const { return width; }
         int getHeight() const { return height; }
+        // 最终画面输出到的帧缓冲: 窗口模式为0(默认帧缓冲), 无头模式为离屏帧缓冲
+        [[nodiscard]] GLuint getFramebuffer() const { return framebuffer; }
+        // 读回最终画面, RGBA8, 第一行为图像顶部; 需在swapBuffers之前调用
+        [[nodiscard]] std::vector<unsigned char> readPixels() const;
 
         inline static bool initialized = false;
         void close(const Event& event) {glfwSetWindowShouldClose(getInstance().getHandle(), true);}
@@ -41,8 +66,13 @@ namespace lunar {
         void initGLFW();
         void initWindow();
         void initGLAD();
+        void initFramebuffer();
+        void resolveBackend();
 
+        WindowBackend backend{WindowBackend::Glfw};
         GLFWwindow* window{nullptr};
+        GLuint framebuffer{0};
+        GLuint color_renderbuffer{0}, depth_renderbuffer{0};
         int default_width{2560}, default_height{1600};
         int width{default_width}, height{default_height};
         std::string title;
@@ -1,7 +1,7 @@
 #include "render/window.hpp"
 #include "render/shader.hpp"
 #include "render/camera.hpp"
-#include "render/texture.hpp"
+#include "render/engine.hpp"
 #include "interface/interface.hpp"
 #include "model/model.hpp"
 #include <iostream>
@@ -149,15 +149,19 @@ int main() {
 
     glm::mat4 box_model = glm::mat4(1.0f);
     box_model = glm::rotate(box_model, glm::radians(45.0f), glm::vec3(0.0f, 1.0f, 0.0f));
-    glm::mat3 box_normal_matrix = lunar::Model::getNormalMatrix(box_model);
+    glm::mat3 box_normal_matrix = lunar::General::getNormalMatrix(box_model);
 
     glEnable(GL_DEPTH_TEST);
-    while (!window.shouldClose()) {
+    lunar::Engine engine;
+    engine.addHook(lunar::FramePhase::Update, [&](const lunar::FrameContext& context) {
+        camera.update(interface, static_cast<float>(context.fixed_delta));
+    });
+    engine.addHook(lunar::FramePhase::Render, [&](const lunar::FrameContext& context) {
         glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
         // 计算光源位置
-        float time = static_cast<float>(glfwGetTime());
+        float time = static_cast<float>(context.getRenderTime());
         glm::vec3 lightPos(
             2.0f * cos(time),  // x坐标
             0.8f,             // y坐标保持不变
@@ -174,9 +178,9 @@ int main() {
         box_shader_program.setVec3("objectColor", glm::vec3(1.0f, 0.5f, 0.31f));
         box_shader_program.setVec3("lightColor", glm::vec3(1.0f, 1.0f, 1.0f));
         box_shader_program.setVec3("lightPos", lightPos);  // 使用更新后的光源位置
-        box_shader_program.setVec3("viewPos", camera.getPosition());
+        box_shader_program.setVec3("viewPos", camera.getPosition(context.alpha));
 
-        glm::mat4 view = camera.computeViewMatrix();
+        glm::mat4 view = camera.computeViewMatrix(context.alpha);
         glm::mat4 projection = camera.computeProjectionMatrix();
         
         box_shader_program.setMat4("model", box_model);
@@ -192,10 +196,8 @@ int main() {
         light_shader_program.setMat4("view", view);
         light_shader_program.setMat4("projection", projection);
         light_shader_program.draw();
-
-        window.swapBuffers();
-        window.pollEvents();
-    }
+    });
+    engine.run();
 
     return 0;
 }
\ No newline at end of file
@@ -1,7 +1,8 @@
 #include "render/window.hpp"
 #include "render/shader.hpp"
 #include "render/camera.hpp"
-#include "render/texture.hpp"
+#include "render/engine.hpp"
+#include "model/texture.hpp"
 #include "interface/interface.hpp"
 #include <iostream>
 #include <functional>
@@ -67,12 +68,16 @@ int main() {
     });
     shader_program.setSequentialIndices();
 
-    lunar::Texture texture1("../assets/container.jpg", 0);
-    lunar::Texture texture2("../assets/awesomeface.png", 1);
-    
+    lunar::Texture texture1("../assets/container.jpg", lunar::TextureType::Diffuse, GL_REPEAT, GL_LINEAR, GL_LINEAR, true, true);
+    lunar::Texture texture2("../assets/awesomeface.png", lunar::TextureType::Diffuse, GL_REPEAT, GL_LINEAR, GL_LINEAR, true, true);
+
     shader_program.use();
-    shader_program.useTexture(texture1);
-    shader_program.useTexture(texture2);
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, texture1.id);
+    shader_program.setInt("texture1", 0);
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_2D, texture2.id);
+    shader_program.setInt("texture2", 1);
 
     lunar::Camera camera(glm::vec3(0.0f, 0.0f, 3.0f));
 
@@ -93,18 +98,23 @@ int main() {
     interface.bindAllCallbacks("../modules/config/interface.yaml", window.getHandle());
 
     glEnable(GL_DEPTH_TEST);
-    while (!window.shouldClose()) {
+    lunar::Engine engine;
+    engine.addHook(lunar::FramePhase::Update, [&](const lunar::FrameContext& context) {
+        camera.update(interface, static_cast<float>(context.fixed_delta));
+    });
+    engine.addHook(lunar::FramePhase::Render, [&](const lunar::FrameContext& context) {
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
+        // 旋转角取渲染时刻对应的模拟时间
+        const double time = context.getRenderTime();
         glm::mat4 model = glm::mat4(1.0f);
-        model = glm::rotate(model, static_cast<float>(glfwGetTime()), glm::vec3(0.5f, 1.0f, 0.0f));
+        model = glm::rotate(model, static_cast<float>(time), glm::vec3(0.5f, 1.0f, 0.0f));
 
         shader_program.use();
-        shader_program.setMat4("transform", camera.computeProjectionMatrix() * camera.computeViewMatrix() * model);
+        shader_program.setMat4("transform", camera.computeProjectionMatrix() * camera.computeViewMatrix(context.alpha) * model);
         shader_program.draw();
-        window.swapBuffers();
-        window.pollEvents();
-    }
+    });
+    engine.run();
 
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,74 @@
+#include "bench/bench_report.hpp"
+#include "render/camera_path.hpp"
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <fstream>
+
+using namespace lunar;
+
+TEST(BenchReportTest, ComputesPercentiles) {
+    std::vector<float> samples;
+    for (int i = 100; i >= 1; i--) samples.push_back(static_cast<float>(i));
+    const BenchStats stats = BenchStats::compute(samples);
+    EXPECT_EQ(stats.count, 100u);
+    EXPECT_FLOAT_EQ(stats.p50, 50.0f);
+    EXPECT_FLOAT_EQ(stats.p95, 95.0f);
+    EXPECT_FLOAT_EQ(stats.p99, 99.0f);
+    EXPECT_FLOAT_EQ(stats.max, 100.0f);
+    EXPECT_FLOAT_EQ(stats.mean, 50.5f);
+    EXPECT_EQ(BenchStats::compute({}).count, 0u);
+}
+
+TEST(BenchReportTest, RoundTripsAndDetectsRegressions) {
+    BenchReport baseline;
+    baseline.setInfo("scene", "test \"scene\"");
+    baseline.setInfo("width", 1280);
+    baseline.addMetric("cpu_ms", BenchStats::compute({1.0f, 2.0f, 3.0f, 4.0f}));
+    baseline.addMetric("draw_calls", BenchStats::compute({10.0f, 10.0f}));
+    const std::string path = "test_bench_baseline.json";
+    {
+        std::ofstream file(path);
+        baseline.writeJSON(file);
+    }
+    const BenchReport loaded = BenchReport::load(path);
+    std::remove(path.c_str());
+    ASSERT_NE(loaded.findMetric("cpu_ms"), nullptr);
+    EXPECT_FLOAT_EQ(loaded.findMetric("cpu_ms")->p95, 4.0f);
+    EXPECT_EQ(loaded.findMetric("draw_calls")->count, 2u);
+
+    BenchReport current;
+    current.addMetric("cpu_ms", BenchStats::compute({1.0f, 2.0f, 3.0f, 4.2f}));
+    current.addMetric("draw_calls", BenchStats::compute({10.0f, 11.0f}));
+    const std::vector<BenchComparison> comparisons = current.compare(loaded, {
+        {"cpu_ms", "p95", 0.10f, 0.0f},   // 涨了5%, 在阈值之内
+        {"cpu_ms", "max", 0.01f, 0.5f},   // 超过比例但绝对差太小
+        {"draw_calls", "max", 0.0f, 0.0f},
+        {"gpu_ms", "p95", 0.10f, 0.0f},   // 基线中没有
+    });
+    ASSERT_EQ(comparisons.size(), 4u);
+    EXPECT_FALSE(comparisons[0].regressed);
+    EXPECT_FALSE(comparisons[1].regressed);
+    EXPECT_TRUE(comparisons[2].regressed);
+    EXPECT_TRUE(comparisons[3].missing);
+    EXPECT_FALSE(comparisons[3].regressed);
+}
+
+TEST(CameraPathTest, PassesThroughKeyframes) {
+    CameraPath path({
+        {glm::vec3(0.0f, 0.0f, 5.0f), glm::vec3(0.0f)},
+        {glm::vec3(5.0f, 0.0f, 0.0f), glm::vec3(0.0f)},
+        {glm::vec3(0.0f, 2.0f, -5.0f), glm::vec3(0.0f, 1.0f, 0.0f)},
+    });
+    const auto expectNear = [](const glm::vec3& a, const glm::vec3& b) {
+        EXPECT_NEAR(a.x, b.x, 1e-5f);
+        EXPECT_NEAR(a.y, b.y, 1e-5f);
+        EXPECT_NEAR(a.z, b.z, 1e-5f);
+    };
+    expectNear(path.evaluate(0.0f).position, glm::vec3(0.0f, 0.0f, 5.0f));
+    expectNear(path.evaluate(0.5f).position, glm::vec3(5.0f, 0.0f, 0.0f));
+    expectNear(path.evaluate(1.0f).position, glm::vec3(0.0f, 2.0f, -5.0f));
+    expectNear(path.evaluate(1.0f).target, glm::vec3(0.0f, 1.0f, 0.0f));
+    // 闭合时终点回到起点
+    path.setLoop(true);
+    expectNear(path.evaluate(1.0f).position, glm::vec3(0.0f, 0.0f, 5.0f));
+}
@@ -0,0 +1,47 @@
+#include <gtest/gtest.h>
+#include "render/dynamic_resolution.hpp"
+
+using namespace lunar;
+
+// 假设GPU时间与像素数, 也就是缩放的平方成正比
+static float simulate(DynamicResolutionController& controller, float full_resolution_ms, int frames) {
+    for (int i = 0; i < frames; i++) {
+        float scale = controller.getScale();
+        controller.update(full_resolution_ms * scale * scale);
+    }
+    return controller.getScale();
+}
+
+TEST(DynamicResolutionTest, ConvergesUnderBudget) {
+    DynamicResolutionController controller(16.0f, 0.5f, 1.0f);
+    float scale = simulate(controller, 32.0f, 200);
+    // 满分辨率需要32ms, sqrt(16 / 32)约为0.707
+    EXPECT_LE(32.0f * scale * scale, 16.0f);
+    EXPECT_GE(scale, 0.6f);
+    // 稳定之后不再来回跳动
+    EXPECT_FLOAT_EQ(simulate(controller, 32.0f, 100), scale);
+}
+
+TEST(DynamicResolutionTest, ClampsToRange) {
+    DynamicResolutionController controller(16.0f, 0.5f, 1.0f);
+    EXPECT_FLOAT_EQ(simulate(controller, 200.0f, 200), 0.5f);
+    // 负载消失后回到满分辨率
+    EXPECT_FLOAT_EQ(simulate(controller, 4.0f, 400), 1.0f);
+}
+
+TEST(DynamicResolutionTest, HoldsInsideHysteresisBand) {
+    DynamicResolutionController controller(16.0f, 0.5f, 1.0f);
+    controller.reset(0.8f);
+    // 0.8下为15ms, 在预算内但高于上调阈值
+    const float full_resolution_ms = 15.0f / 0.64f;
+    EXPECT_FLOAT_EQ(simulate(controller, full_resolution_ms, 100), 0.8f);
+}
+
+TEST(DynamicResolutionTest, ReactsToSpikeWithinCooldown) {
+    DynamicResolutionController controller(16.0f, 0.5f, 1.0f);
+    simulate(controller, 10.0f, 50);
+    ASSERT_FLOAT_EQ(controller.getScale(), 1.0f);
+    // 负载突然翻倍, 平滑之后几帧内开始下调
+    float scale = simulate(controller, 30.0f, 6);
+    EXPECT_LT(scale, 1.0f);
+}
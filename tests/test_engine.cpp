@@ -0,0 +1,86 @@
+#include "render/engine.hpp"
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace lunar;
+
+TEST(EngineTest, AccumulatesFixedSteps) {
+    Engine engine(60.0);
+    std::vector<uint64_t> updates;
+    std::vector<float> alphas;
+    engine.addHook(FramePhase::Update, [&](const FrameContext& context) { updates.push_back(context.update); });
+    engine.addHook(FramePhase::Render, [&](const FrameContext& context) { alphas.push_back(context.alpha); });
+    // 渲染是更新的两倍频率, 每两帧更新一次, 中间一帧的画面在两次更新之间
+    for (int i = 0; i < 4; i++) engine.step(1.0 / 120.0);
+    EXPECT_EQ(updates, (std::vector<uint64_t>{0, 1}));
+    ASSERT_EQ(alphas.size(), 4u);
+    EXPECT_FLOAT_EQ(alphas[0], 0.5f);
+    EXPECT_FLOAT_EQ(alphas[1], 0.0f);
+    EXPECT_FLOAT_EQ(alphas[2], 0.5f);
+    EXPECT_FLOAT_EQ(alphas[3], 0.0f);
+    EXPECT_EQ(engine.getFrameCount(), 4u);
+    EXPECT_DOUBLE_EQ(engine.getContext().time, 2.0 / 60.0);
+
+    // 渲染比更新慢时一帧追赶多次
+    engine.step(3.5 / 60.0);
+    EXPECT_EQ(engine.getUpdateCount(), 5u);
+    EXPECT_NEAR(engine.getContext().alpha, 0.5f, 1e-5f);
+    EXPECT_NEAR(engine.getContext().getRenderTime(), 4.5 / 60.0, 1e-9);
+}
+
+TEST(EngineTest, DropsBacklogPastMaxUpdates) {
+    Engine engine(60.0);
+    engine.setMaxUpdatesPerFrame(5);
+    int updates = 0;
+    engine.addHook(FramePhase::Update, [&](const FrameContext&) { updates++; });
+    // 一秒的长帧只追赶5次, 其余丢弃, 下一帧正常
+    engine.step(1.0);
+    EXPECT_EQ(updates, 5);
+    EXPECT_EQ(engine.getSkippedUpdateCount(), 55u);
+    EXPECT_LT(engine.getContext().alpha, 1e-3f);
+    engine.step(1.0 / 60.0);
+    EXPECT_EQ(updates, 6);
+
+    EXPECT_THROW(engine.setUpdateRate(0.0), std::runtime_error);
+    EXPECT_THROW(engine.setMaxUpdatesPerFrame(0), std::runtime_error);
+}
+
+TEST(EngineTest, RunsPhasesInOrderByPriority) {
+    Engine engine(60.0);
+    std::vector<std::string> calls;
+    const auto record = [&calls](const char* name) {
+        return [&calls, name](const FrameContext&) { calls.emplace_back(name); };
+    };
+    engine.addHook(FramePhase::Present, record("present"), Engine::builtin_priority - 1);
+    engine.addHook(FramePhase::Render, record("render"));
+    engine.addHook(FramePhase::Update, record("update"));
+    const Engine::HookId removed = engine.addHook(FramePhase::Update, record("removed"));
+    engine.addHook(FramePhase::Input, record("input"));
+    engine.addHook(FramePhase::Render, record("render first"), 10);
+    engine.addHook(FramePhase::Input, record("input first"), Engine::builtin_priority + 1);
+    engine.removeHook(removed);
+
+    engine.step(1.0 / 60.0);
+    EXPECT_EQ(calls, (std::vector<std::string>{"input first", "input", "update", "render first", "render", "present"}));
+
+    // 不到一个步长的帧不更新, 但仍然渲染与呈现
+    calls.clear();
+    engine.step(0.25 / 60.0);
+    EXPECT_EQ(calls, (std::vector<std::string>{"input first", "input", "render first", "render", "present"}));
+}
+
+TEST(EngineTest, FixedFrameTimeIgnoresClock) {
+    Engine engine(30.0);
+    engine.setFixedFrameTime(1.0 / 60.0);
+    // 每两帧更新一次, 第二次更新(第4帧)时要求停止, 远早于循环的上限
+    engine.addHook(FramePhase::Update, [&engine](const FrameContext& context) {
+        if (context.update == 1) engine.requestStop();
+    });
+    for (int i = 0; i < 20 && !engine.isStopRequested(); i++) engine.step();
+    EXPECT_TRUE(engine.isStopRequested());
+    EXPECT_EQ(engine.getFrameCount(), 4u);
+    EXPECT_EQ(engine.getUpdateCount(), 2u);
+    EXPECT_DOUBLE_EQ(engine.getContext().time, 2.0 / 30.0);
+}
@@ -0,0 +1,273 @@
+#include "render/render.hpp"
+#include "render/image.hpp"
+#include "model/model.hpp"
+#include <gtest/gtest.h>
+#include <yaml-cpp/yaml.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <mutex>
+
+// 黄金图像与性能预算测试: 在固定分辨率下渲染几个典型场景, 读回画面与tests/golden中的PNG比较,
+// 中位帧时间超过budgets.yaml中的预算时失败.
+//   LUNAR_UPDATE_GOLDEN=1         用当前画面覆盖黄金图像
+//   LUNAR_PERF_BUDGET_SCALE=2.0   在较慢的机器上放宽预算
+// 黄金图像不存在或比较失败都算失败; 比较失败时把实际画面与差异图写到当前目录
+namespace {
+
+constexpr int golden_width = 320, golden_height = 240;
+// 单个像素允许的色差, 以及允许不同的像素比例, 用来吸收不同驱动光栅化与浮点精度的细微差别
+constexpr float pixel_threshold = 0.1f;
+constexpr float max_different_ratio = 0.005f;
+constexpr int timed_frames = 20;
+
+const std::string source_dir = LUNAR_SOURCE_DIR;
+const std::string golden_dir = source_dir + "/tests/golden";
+
+bool isEnvironmentSet(const char* name) {
+    const char* value = std::getenv(name);
+    return value && *value && std::string(value) != "0";
+}
+
+class GoldenImageTest : public ::testing::Test {
+protected:
+    static void SetUpTestSuite() {
+        auto& window = lunar::Window::getInstance();
+        if (!lunar::Window::initialized) {
+            // 默认无头运行, LUNAR_HEADLESS=window时打开真正的窗口
+            window.setBackend(lunar::WindowBackend::HeadlessEGL);
+            window.init(golden_width, golden_height, "lunar golden test");
+        }
+    }
+
+    void SetUp() override {
+        const auto& window = lunar::Window::getInstance();
+        if (window.getWidth() != golden_width || window.getHeight() != golden_height) {
+            GTEST_SKIP() << "Framebuffer is " << window.getWidth() << "x" << window.getHeight()
+                         << ", golden images need " << golden_width << "x" << golden_height;
+        }
+    }
+
+    // 画一帧并读回最终画面
+    static lunar::Image renderFrame(const std::function<void()>& draw) {
+        auto& window = lunar::Window::getInstance();
+        bindOutput();
+        draw();
+        lunar::Image image(window.getWidth(), window.getHeight(), window.readPixels());
+        window.swapBuffers();
+        return image;
+    }
+
+    // 每帧都等GPU完成, 返回中位数, 毫秒
+    static float measureFrameMs(const std::function<void()>& draw) {
+        std::vector<float> samples;
+        for (int i = 0; i < timed_frames; i++) {
+            const auto begin = std::chrono::steady_clock::now();
+            bindOutput();
+            draw();
+            glFinish();
+            samples.push_back(std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - begin).count());
+        }
+        std::nth_element(samples.begin(), samples.begin() + timed_frames / 2, samples.end());
+        return samples[timed_frames / 2];
+    }
+
+    static void expectMatchesGolden(const std::string& name, const lunar::Image& image) {
+        ASSERT_EQ(glGetError(), static_cast<GLenum>(GL_NO_ERROR));
+        const std::string golden_path = golden_dir + "/" + name + ".png";
+        if (isEnvironmentSet("LUNAR_UPDATE_GOLDEN")) {
+            ASSERT_TRUE(lunar::writePNG(golden_path, image)) << "Failed to write " << golden_path;
+            return;
+        }
+        if (!std::filesystem::exists(golden_path)) {
+            FAIL() << "No golden image " << golden_path << ", run with LUNAR_UPDATE_GOLDEN=1 to create it";
+        }
+        const lunar::Image golden = lunar::loadImage(golden_path);
+        ASSERT_EQ(golden.width, image.width);
+        ASSERT_EQ(golden.height, image.height);
+        const lunar::ImageDiff diff = lunar::compareImages(golden, image, pixel_threshold);
+        const float ratio = diff.getDifferentRatio(static_cast<size_t>(image.width) * image.height);
+        if (ratio > max_different_ratio) {
+            lunar::writePNG(name + "-actual.png", image);
+            lunar::writePNG(name + "-diff.png", diff.diff);
+        }
+        EXPECT_LE(ratio, max_different_ratio) << name << ": " << diff.different_pixels << " pixels differ, max delta "
+            << diff.max_delta << "; wrote " << name << "-actual.png and " << name << "-diff.png";
+    }
+
+    static void expectWithinBudget(const std::string& name, float frame_ms) {
+        const YAML::Node budgets = YAML::LoadFile(golden_dir + "/budgets.yaml");
+        if (!budgets[name]) return;
+        float scale = 1.0f;
+        if (const char* value = std::getenv("LUNAR_PERF_BUDGET_SCALE")) scale = std::max(std::strtof(value, nullptr), 0.0f);
+        const float budget = budgets[name].as<float>() * (scale > 0.0f ? scale : 1.0f);
+        EXPECT_LE(frame_ms, budget) << name << " took " << frame_ms << " ms per frame, budget " << budget << " ms";
+    }
+
+    static void bindOutput() {
+        const auto& window = lunar::Window::getInstance();
+        glBindFramebuffer(GL_FRAMEBUFFER, window.getFramebuffer());
+        glViewport(0, 0, window.getWidth(), window.getHeight());
+    }
+};
+
+// 冯氏光照的立方体, 与main-phong-shading相同的着色器, 光源固定
+class PhongBox {
+public:
+    PhongBox(): shader(
+        #include "phong-shading/phong-shading-box-vs.glsl"
+        ,
+        #include "phong-shading/phong-shading-box-fs.glsl"
+        ), camera(glm::vec3(0.0f, 1.0f, 3.0f)) {
+        shader.setVertexDataProperty({"position", "normal"}, {3, 3});
+        std::vector<lunar::VertexData<6>> box_vertices = {
+            {-0.5f, -0.5f, -0.5f,  0.0f,  0.0f, -1.0f},
+            { 0.5f, -0.5f, -0.5f,  0.0f,  0.0f, -1.0f},
+            { 0.5f,  0.5f, -0.5f,  0.0f,  0.0f, -1.0f},
+            { 0.5f,  0.5f, -0.5f,  0.0f,  0.0f, -1.0f},
+            {-0.5f,  0.5f, -0.5f,  0.0f,  0.0f, -1.0f},
+            {-0.5f, -0.5f, -0.5f,  0.0f,  0.0f, -1.0f},
+            {-0.5f, -0.5f,  0.5f,  0.0f,  0.0f,  1.0f},
+            { 0.5f, -0.5f,  0.5f,  0.0f,  0.0f,  1.0f},
+            { 0.5f,  0.5f,  0.5f,  0.0f,  0.0f,  1.0f},
+            { 0.5f,  0.5f,  0.5f,  0.0f,  0.0f,  1.0f},
+            {-0.5f,  0.5f,  0.5f,  0.0f,  0.0f,  1.0f},
+            {-0.5f, -0.5f,  0.5f,  0.0f,  0.0f,  1.0f},
+            {-0.5f,  0.5f,  0.5f, -1.0f,  0.0f,  0.0f},
+            {-0.5f,  0.5f, -0.5f, -1.0f,  0.0f,  0.0f},
+            {-0.5f, -0.5f, -0.5f, -1.0f,  0.0f,  0.0f},
+            {-0.5f, -0.5f, -0.5f, -1.0f,  0.0f,  0.0f},
+            {-0.5f, -0.5f,  0.5f, -1.0f,  0.0f,  0.0f},
+            {-0.5f,  0.5f,  0.5f, -1.0f,  0.0f,  0.0f},
+            { 0.5f,  0.5f,  0.5f,  1.0f,  0.0f,  0.0f},
+            { 0.5f,  0.5f, -0.5f,  1.0f,  0.0f,  0.0f},
+            { 0.5f, -0.5f, -0.5f,  1.0f,  0.0f,  0.0f},
+            { 0.5f, -0.5f, -0.5f,  1.0f,  0.0f,  0.0f},
+            { 0.5f, -0.5f,  0.5f,  1.0f,  0.0f,  0.0f},
+            { 0.5f,  0.5f,  0.5f,  1.0f,  0.0f,  0.0f},
+            {-0.5f, -0.5f, -0.5f,  0.0f, -1.0f,  0.0f},
+            { 0.5f, -0.5f, -0.5f,  0.0f, -1.0f,  0.0f},
+            { 0.5f, -0.5f,  0.5f,  0.0f, -1.0f,  0.0f},
+            { 0.5f, -0.5f,  0.5f,  0.0f, -1.0f,  0.0f},
+            {-0.5f, -0.5f,  0.5f,  0.0f, -1.0f,  0.0f},
+            {-0.5f, -0.5f, -0.5f,  0.0f, -1.0f,  0.0f},
+            {-0.5f,  0.5f, -0.5f,  0.0f,  1.0f,  0.0f},
+            { 0.5f,  0.5f, -0.5f,  0.0f,  1.0f,  0.0f},
+            { 0.5f,  0.5f,  0.5f,  0.0f,  1.0f,  0.0f},
+            { 0.5f,  0.5f,  0.5f,  0.0f,  1.0f,  0.0f},
+            {-0.5f,  0.5f,  0.5f,  0.0f,  1.0f,  0.0f},
+            {-0.5f,  0.5f, -0.5f,  0.0f,  1.0f,  0.0f}
+        };
+        shader.setVertices<6>(box_vertices);
+        shader.setSequentialIndices();
+        camera.lookAt(glm::vec3(0.0f, 1.0f, 3.0f), glm::vec3(0.0f));
+    }
+
+    void draw() {
+        glEnable(GL_DEPTH_TEST);
+        glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        const glm::mat4 model = glm::rotate(glm::mat4(1.0f), glm::radians(45.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+        shader.use();
+        shader.setVec3("objectColor", glm::vec3(1.0f, 0.5f, 0.31f));
+        shader.setVec3("lightColor", glm::vec3(1.0f));
+        shader.setVec3("lightPos", glm::vec3(1.2f, 1.0f, 2.0f));
+        shader.setVec3("viewPos", camera.getPosition());
+        shader.setMat4("model", model);
+        shader.setMat4("view", camera.computeViewMatrix());
+        shader.setMat4("projection", camera.computeProjectionMatrix());
+        shader.setMat3("normalMatrix", glm::transpose(glm::inverse(glm::mat3(model))));
+        shader.draw();
+    }
+
+private:
+    lunar::ShaderProgram shader;
+    lunar::Camera camera;
+};
+
+}
+
+TEST_F(GoldenImageTest, PhongBox) {
+    PhongBox scene;
+    expectMatchesGolden("phong_box", renderFrame([&] { scene.draw(); }));
+    expectWithinBudget("phong_box", measureFrameMs([&] { scene.draw(); }));
+}
+
+TEST_F(GoldenImageTest, ToonPostProcess) {
+    PhongBox scene;
+    lunar::PostProcesser postprocesser;
+    postprocesser.configure({{.name = "toon", .enabled = true, .params = {}}});
+    postprocesser.setAntiAliasing(lunar::AntiAliasing::None);
+    const auto draw = [&] {
+        postprocesser.tobeDrawn();
+        scene.draw();
+        postprocesser.toDraw();
+        postprocesser.draw();
+    };
+    expectMatchesGolden("toon_post_process", renderFrame(draw));
+    expectWithinBudget("toon_post_process", measureFrameMs(draw));
+}
+
+TEST_F(GoldenImageTest, Backpack) {
+    const std::string model_path = source_dir + "/assets/backpack/backpack.obj";
+    if (!std::filesystem::exists(model_path)) {
+        GTEST_SKIP() << "Model not found: " << model_path;
+    }
+    lunar::ShaderProgram shader(
+        #include "main/GLSL/box-vs.glsl"
+        ,
+        #include "main/GLSL/box-fs.glsl"
+    );
+    lunar::Model backpack(model_path);
+    lunar::Camera camera(glm::vec3(0.0f));
+    camera.lookAt(glm::vec3(1.5f, 1.0f, 4.0f), glm::vec3(0.0f));
+    const lunar::StrongPointLight light{
+        .position = glm::vec3(2.0f, 2.0f, 4.0f),
+        .color = glm::vec3(1.0f),
+        .ambient = glm::vec3(0.2f),
+        .diffuse = glm::vec3(0.5f),
+        .specular = glm::vec3(1.0f)
+    };
+    shader.use();
+    shader.setUniformStruct("light", light);
+    const auto draw = [&] {
+        glEnable(GL_DEPTH_TEST);
+        glClearColor(1.0f, 1.0f, 1.0f, 1.0f);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        shader.use();
+        shader.setVec3("viewPos", camera.getPosition());
+        shader.setMat4("view", camera.computeViewMatrix());
+        shader.setMat4("projection", camera.computeProjectionMatrix());
+        backpack.Draw(shader);
+    };
+    expectMatchesGolden("backpack", renderFrame(draw));
+    expectWithinBudget("backpack", measureFrameMs(draw));
+}
+
+TEST_F(GoldenImageTest, AsyncCaptureMatchesReadPixels) {
+    PhongBox scene;
+    std::vector<lunar::CapturedFrame> captured;
+    std::mutex mutex;
+    {
+        lunar::FrameCapture capture;
+        capture.setCallback([&](const lunar::CapturedFrame& frame) {
+            std::lock_guard<std::mutex> lock(mutex);
+            captured.push_back(frame);
+        });
+        // 比环更多的帧, 覆盖环满之后的回收
+        for (int i = 0; i < 6; i++) {
+            bindOutput();
+            scene.draw();
+            capture.capture();
+        }
+        capture.flush();
+        EXPECT_EQ(capture.getDroppedCount(), 0u);
+    }
+    ASSERT_EQ(captured.size(), 6u);
+    for (size_t i = 0; i < captured.size(); i++) EXPECT_EQ(captured[i].index, i);
+    const lunar::Image expected = renderFrame([&] { scene.draw(); });
+    EXPECT_EQ(captured.back().image.pixels, expected.pixels);
+}
@@ -0,0 +1,169 @@
+#include "interface/interface.hpp"
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace lunar;
+
+TEST(EventQueueTest, KeepsOrderAndDropsWhenFull) {
+    SpscQueue<int, 4> queue;
+    for (int i = 0; i < 6; i++) queue.push(i);
+    EXPECT_EQ(queue.size(), 4u);
+    EXPECT_EQ(queue.getDroppedCount(), 2u);
+    int out[8];
+    ASSERT_EQ(queue.pop(out, 3), 3u);
+    EXPECT_EQ(out[0], 0);
+    EXPECT_EQ(out[2], 2);
+    // 取出之后又有空位
+    EXPECT_TRUE(queue.push(10));
+    ASSERT_EQ(queue.pop(out, 8), 2u);
+    EXPECT_EQ(out[0], 3);
+    EXPECT_EQ(out[1], 10);
+    EXPECT_TRUE(queue.empty());
+}
+
+TEST(EventQueueTest, TransfersEventsAcrossThreads) {
+    static_assert(sizeof(Event) == 16);
+    constexpr int total = 20000;
+    SpscQueue<Event, 256> queue;
+    std::thread producer([&] {
+        for (int i = 0; i < total; i++) {
+            Event event{.type = EventType::MOUSE_SCROLL, .mods = 0, .data = {.mouse_scroll = {.xoffset = 0, .yoffset = 1}}};
+            event.timestamp = static_cast<uint32_t>(i);
+            while (!queue.push(event)) std::this_thread::yield();
+        }
+    });
+    std::vector<uint32_t> received;
+    received.reserve(total);
+    Event batch[32];
+    while (received.size() < static_cast<size_t>(total)) {
+        const size_t count = queue.pop(batch, 32);
+        for (size_t i = 0; i < count; i++) received.push_back(batch[i].timestamp);
+    }
+    producer.join();
+    for (int i = 0; i < total; i++) ASSERT_EQ(received[i], static_cast<uint32_t>(i));
+}
+
+TEST(InterfaceTest, DispatchesListenersByPriority) {
+    auto& interface = Interface::getInstance();
+    interface.clearCallbacks();
+    std::vector<int> calls;
+    const EventIdentifier key = GLFW_KEY_W;
+    interface.bindCallback(key, [&calls](const Event&) { calls.push_back(0); });
+    interface.bindCallback(key, [&calls](const Event&) { calls.push_back(1); }, 0, 10);
+    interface.bindCallback(key, [&calls](const Event&) { calls.push_back(2); }, GLFW_MOD_CONTROL, 5);
+    interface.bindCallback(key, [&calls](const Event&) { calls.push_back(3); });
+    ASSERT_EQ(interface.getListeners(key).size(), 4u);
+
+    Event event{.type = EventType::KEY, .mods = 0, .data = {.key = {.key = key, .scancode = 0, .action = GLFW_PRESS, .mods = 0}}};
+    ASSERT_TRUE(interface.pushEvent(event));
+    event.mods = GLFW_MOD_CONTROL;
+    ASSERT_TRUE(interface.pushEvent(event));
+    EXPECT_EQ(interface.dispatchEvents(), 2u);
+    // 没有按Ctrl时跳过需要Ctrl的回调; 相同优先级按绑定的顺序
+    EXPECT_EQ(calls, (std::vector<int>{1, 0, 3, 1, 2, 0, 3}));
+    interface.clearCallbacks();
+}
+
+TEST(InterfaceTest, DelegateCopiesNonTrivialCallables) {
+    auto counter = std::make_shared<int>(0);
+    EventCallbackFunction delegate = [counter](const Event&) { (*counter)++; };
+    {
+        const EventCallbackFunction copy = delegate;
+        EXPECT_EQ(counter.use_count(), 3);
+        copy(Event{});
+    }
+    EXPECT_EQ(counter.use_count(), 2);
+    delegate(Event{});
+    EXPECT_EQ(*counter, 2);
+    delegate.reset();
+    EXPECT_FALSE(delegate);
+    EXPECT_EQ(counter.use_count(), 1);
+}
+
+TEST(InterfaceTest, TracksKeysAndAxes) {
+    auto& interface = Interface::getInstance();
+    interface.clearCallbacks();
+    interface.addAxis("forward", {GLFW_KEY_W}, {GLFW_KEY_S});
+    const auto pushKey = [&interface](int key, int action) {
+        interface.pushEvent({.type = EventType::KEY, .mods = 0, .data = {.key = {.key = (unsigned short)key, .scancode = 0, .action = (unsigned short)action, .mods = 0}}});
+    };
+    pushKey(GLFW_KEY_W, GLFW_PRESS);
+    pushKey(GLFW_KEY_W, GLFW_REPEAT);
+    interface.dispatchEvents();
+    EXPECT_TRUE(interface.isKeyDown(GLFW_KEY_W));
+    EXPECT_FLOAT_EQ(interface.getAxis("forward"), 1.0f);
+    pushKey(GLFW_KEY_S, GLFW_PRESS);
+    interface.dispatchEvents();
+    EXPECT_FLOAT_EQ(interface.getAxis("forward"), 0.0f);
+    pushKey(GLFW_KEY_W, GLFW_RELEASE);
+    interface.dispatchEvents();
+    EXPECT_FALSE(interface.isKeyDown(GLFW_KEY_W));
+    EXPECT_FLOAT_EQ(interface.getAxis("forward"), -1.0f);
+    EXPECT_FLOAT_EQ(interface.getAxis("undeclared"), 0.0f);
+    interface.clearCallbacks();
+    EXPECT_FALSE(interface.isKeyDown(GLFW_KEY_S));
+}
+
+TEST(InterfaceTest, ReplaysRecordedFramesDeterministically) {
+    auto& interface = Interface::getInstance();
+    interface.clearCallbacks();
+    std::vector<std::pair<uint64_t, float>> live, replayed;
+    std::vector<std::pair<uint64_t, float>>* log = &live;
+    uint64_t frame = 0;
+    interface.bindCallback(static_cast<EventIdentifier>(LUNAR_EVENT::LUNAR_MOUSE_SCROLL),
+                           [&](const Event& event) { log->push_back({frame, event.data.mouse_scroll.yoffset}); });
+    const std::string path = "test_input_recording.bin";
+    interface.startRecording(path);
+    for (frame = 0; frame < 5; frame++) {
+        // 第1帧没有事件, 第3帧有两个
+        if (frame != 1) interface.pushEvent({.type = EventType::MOUSE_SCROLL, .mods = 0, .data = {.mouse_scroll = {.xoffset = 0.0f, .yoffset = 0.5f * frame}}});
+        if (frame == 3) interface.pushEvent({.type = EventType::MOUSE_SCROLL, .mods = 0, .data = {.mouse_scroll = {.xoffset = 0.0f, .yoffset = -1.0f}}});
+        interface.dispatchEvents();
+    }
+    interface.stopRecording();
+
+    log = &replayed;
+    interface.startReplay(path);
+    std::remove(path.c_str());
+    EXPECT_EQ(interface.getReplayFrameCount(), 5u);
+    for (frame = 0; interface.isReplaying(); frame++) {
+        // 回放时实际的输入被忽略
+        interface.pushEvent({.type = EventType::MOUSE_SCROLL, .mods = 0, .data = {.mouse_scroll = {.xoffset = 0.0f, .yoffset = 100.0f}}});
+        interface.dispatchEvents();
+    }
+    EXPECT_EQ(frame, 5u);
+    EXPECT_EQ(replayed, live);
+    interface.clearCallbacks();
+}
+
+TEST(InterfaceTest, ReplayRebuildsModifierAndMouseState) {
+    auto& interface = Interface::getInstance();
+    interface.clearCallbacks();
+    double start_x = 0.0, start_y = 0.0;
+    interface.getMousePosition(start_x, start_y);
+    const std::string path = "test_input_state.bin";
+    interface.startRecording(path);
+    interface.pushEvent({.type = EventType::KEY, .mods = 0, .data = {.key = {.key = GLFW_KEY_LEFT_SHIFT, .scancode = 0, .action = GLFW_PRESS, .mods = 0}}});
+    interface.pushEvent({.type = EventType::MOUSE_MOVE, .mods = GLFW_MOD_SHIFT, .data = {.mouse_move = {.xoffset = 3.0f, .yoffset = -4.0f, .mouse_button_state = 1}}});
+    interface.dispatchEvents();
+    interface.dispatchEvents();
+    interface.stopRecording();
+
+    interface.startReplay(path);
+    std::remove(path.c_str());
+    EXPECT_EQ(interface.getModifierState(), 0);
+    interface.dispatchEvents();
+    ASSERT_TRUE(interface.isReplaying());
+    double x = 0.0, y = 0.0;
+    interface.getMousePosition(x, y);
+    EXPECT_DOUBLE_EQ(x, start_x + 3.0);
+    EXPECT_DOUBLE_EQ(y, start_y - 4.0);
+    EXPECT_EQ(interface.getModifierState(), GLFW_MOD_SHIFT);
+    EXPECT_EQ(interface.getMouseButtonState(), 1);
+    interface.dispatchEvents();
+    EXPECT_FALSE(interface.isReplaying());
+    interface.clearCallbacks();
+}
@@ -0,0 +1,89 @@
+#include <gtest/gtest.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include "model/light_manager.hpp"
+
+using namespace lunar;
+
+static PointLight makePointLight(const glm::vec3& position) {
+    return {
+        .position = position,
+        .color = glm::vec3(1.0f),
+        .ambient = glm::vec3(0.05f),
+        .diffuse = glm::vec3(0.8f),
+        .specular = glm::vec3(1.0f),
+        .constant = 1.0f,
+        .linear = 0.7f,
+        .quadratic = 1.8f
+    };
+}
+
+TEST(AttenuationTest, TableLookup) {
+    // 表中的点精确返回
+    auto [linear, quadratic] = General::getPointAttenuationFactor(7.0f);
+    EXPECT_FLOAT_EQ(linear, 0.7f);
+    EXPECT_FLOAT_EQ(quadratic, 1.8f);
+
+    // 两点之间单调
+    auto [mid_linear, mid_quadratic] = General::getPointAttenuationFactor(10.0f);
+    EXPECT_LT(mid_linear, 0.7f);
+    EXPECT_GT(mid_linear, 0.35f);
+    EXPECT_LT(mid_quadratic, 1.8f);
+    EXPECT_GT(mid_quadratic, 0.44f);
+}
+
+TEST(AttenuationTest, BatchMatchesScalar) {
+    const float distances[] = {0.0f, 0.1f, 5.0f, 13.0f, 50.0f, 600.0f, 3250.0f, 5000.0f};
+    constexpr size_t count = sizeof(distances) / sizeof(float);
+    float linear[count], quadratic[count];
+    General::getPointAttenuationFactors(distances, linear, quadratic, count);
+    for (size_t i = 0; i < count; i++) {
+        auto [l, q] = General::getPointAttenuationFactor(distances[i]);
+        EXPECT_FLOAT_EQ(linear[i], l);
+        EXPECT_FLOAT_EQ(quadratic[i], q);
+        EXPECT_GE(linear[i], 0.0f);
+        EXPECT_GE(quadratic[i], 0.0f);
+    }
+}
+
+TEST(LightManagerTest, RadiusFromAttenuation) {
+    LightManager manager;
+    manager.setLights({makePointLight(glm::vec3(0.0f))}, {});
+    float radius = manager.getRadius(0);
+    // 半径处亮度应恰好降到阈值
+    float attenuation = 1.0f / (1.0f + 0.7f * radius + 1.8f * radius * radius);
+    EXPECT_NEAR(attenuation, 5.0f / 256.0f, 1e-4f);
+}
+
+TEST(LightManagerTest, CullAndAssign) {
+    std::vector<PointLight> lights;
+    for (int i = 0; i < 16; i++) {
+        lights.push_back(makePointLight(glm::vec3(static_cast<float>(i) * 0.5f, 0.0f, -5.0f)));
+    }
+    // 相机背后的光源
+    lights.push_back(makePointLight(glm::vec3(0.0f, 0.0f, 50.0f)));
+
+    LightManager manager(4);
+    manager.setLights(lights, {});
+    glm::mat4 projection = glm::perspective(glm::radians(60.0f), 1.0f, 0.1f, 100.0f);
+    manager.update(Frustum::fromMatrix(projection));
+    EXPECT_EQ(manager.getVisibleLights().size(), 16u);
+
+    AABB object;
+    object.expand(glm::vec3(-0.5f, -0.5f, -5.5f));
+    object.expand(glm::vec3(0.5f, 0.5f, -4.5f));
+    std::vector<unsigned int> assigned;
+    manager.assignLights(object, assigned);
+    ASSERT_EQ(assigned.size(), 4u);
+    // 离物体最近的光源贡献最大
+    EXPECT_TRUE(assigned[0] == 0 || assigned[0] == 1);
+    for (unsigned int light : assigned) {
+        EXPECT_LT(light, 4u);
+    }
+
+    AABB far_object;
+    far_object.expand(glm::vec3(100.0f));
+    far_object.expand(glm::vec3(101.0f));
+    manager.assignLights(far_object, assigned);
+    EXPECT_TRUE(assigned.empty());
+}
@@ -1,7 +1,8 @@
 #include "render/window.hpp"
 #include "render/shader.hpp"
 #include "render/camera.hpp"
-#include "render/texture.hpp"
+#include "render/engine.hpp"
+#include "model/texture.hpp"
 #include "interface/interface.hpp"
 #include <gtest/gtest.h>
 #include <memory>
@@ -10,7 +11,11 @@ class SmilingBoxTest : public ::testing::Test {
 protected:
     void SetUp() override {
         window = &lunar::Window::getInstance();
-        window->init(1800, 1200, "OpenGL Test");
+        // 默认无头运行, 不需要显示器; LUNAR_HEADLESS=window时打开真正的窗口
+        if (!lunar::Window::initialized) {
+            window->setBackend(lunar::WindowBackend::HeadlessEGL);
+            window->init(1800, 1200, "OpenGL Test");
+        }
         
         const std::string vertex_shader_code = 
         #include "smiling-box/smiling-box-vs.glsl"
@@ -86,12 +91,21 @@ protected:
     }
 
     void setupTextures() {
-        texture1 = std::make_unique<lunar::Texture>("../assets/container.jpg", 0);
-        texture2 = std::make_unique<lunar::Texture>("../assets/awesomeface.png", 1);
-        
+        texture1 = std::make_unique<lunar::Texture>("../assets/container.jpg", lunar::TextureType::Diffuse,
+            GL_REPEAT, GL_LINEAR, GL_LINEAR, true, true);
+        texture2 = std::make_unique<lunar::Texture>("../assets/awesomeface.png", lunar::TextureType::Diffuse,
+            GL_REPEAT, GL_LINEAR, GL_LINEAR, true, true);
+        bindTextures();
+    }
+
+    void bindTextures() {
         shader_program->use();
-        shader_program->useTexture(*texture1);
-        shader_program->useTexture(*texture2);
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, texture1->id);
+        shader_program->setInt("texture1", 0);
+        glActiveTexture(GL_TEXTURE1);
+        glBindTexture(GL_TEXTURE_2D, texture2->id);
+        shader_program->setInt("texture2", 1);
     }
 
     void setupCallbacks() {
@@ -131,25 +145,34 @@ TEST_F(SmilingBoxTest, InitializationTest) {
 }
 
 TEST_F(SmilingBoxTest, RenderOneFrame) {
-    EXPECT_NO_THROW({
+    lunar::Engine engine;
+    engine.addHook(lunar::FramePhase::Render, [&](const lunar::FrameContext& context) {
+        glBindFramebuffer(GL_FRAMEBUFFER, window->getFramebuffer());
+        glViewport(0, 0, window->getWidth(), window->getHeight());
+        glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
         glEnable(GL_DEPTH_TEST);
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
         glm::mat4 model = glm::mat4(1.0f);
-        model = glm::rotate(model, static_cast<float>(glfwGetTime()), glm::vec3(0.5f, 1.0f, 0.0f));
+        model = glm::rotate(model, static_cast<float>(context.getRenderTime()), glm::vec3(0.5f, 1.0f, 0.0f));
 
         shader_program->use();
-        shader_program->setMat4("transform", camera->computeProjectionMatrix() * camera->computeViewMatrix() * model);
+        shader_program->setMat4("transform", camera->computeProjectionMatrix() * camera->computeViewMatrix(context.alpha) * model);
         shader_program->draw();
-        window->swapBuffers();
-        window->pollEvents();
     });
+    // 在交换缓冲区之前读回画面
+    std::vector<unsigned char> pixels;
+    engine.addHook(lunar::FramePhase::Present, [&](const lunar::FrameContext&) {
+        pixels = window->readPixels();
+    }, lunar::Engine::builtin_priority + 1);
+    EXPECT_NO_THROW(engine.step(1.0 / 60.0));
+    EXPECT_EQ(engine.getFrameCount(), 1u);
+    // 盒子在画面中央, 中心像素不再是清屏的黑色
+    ASSERT_EQ(pixels.size(), static_cast<size_t>(window->getWidth()) * window->getHeight() * 4);
+    const size_t center = (static_cast<size_t>(window->getHeight() / 2) * window->getWidth() + window->getWidth() / 2) * 4;
+    EXPECT_GT(pixels[center] + pixels[center + 1] + pixels[center + 2], 0);
 }
 
 TEST_F(SmilingBoxTest, TextureBinding) {
-    EXPECT_NO_THROW({
-        shader_program->use();
-        shader_program->useTexture(*texture1);
-        shader_program->useTexture(*texture2);
-    });
+    EXPECT_NO_THROW(bindTextures());
 }
\ No newline at end of file
@@ -0,0 +1,167 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <thread>
+#include <vector>
+#include "profile/timing_history.hpp"
+#include "profile/chrome_trace.hpp"
+#include "profile/cpu_tracer.hpp"
+#include "profile/hitch_recorder.hpp"
+#include "profile/profile_scope.hpp"
+
+using namespace lunar;
+
+TEST(TimingHistoryTest, Percentiles) {
+    TimingHistory history(100);
+    for (int i = 1; i <= 100; i++) history.add(static_cast<float>(i));
+    EXPECT_FLOAT_EQ(history.percentile(50.0f), 50.0f);
+    EXPECT_FLOAT_EQ(history.percentile(95.0f), 95.0f);
+    EXPECT_FLOAT_EQ(history.percentile(99.0f), 99.0f);
+    EXPECT_FLOAT_EQ(history.percentile(100.0f), 100.0f);
+    EXPECT_FLOAT_EQ(history.max(), 100.0f);
+    EXPECT_FLOAT_EQ(history.average(), 50.5f);
+}
+
+TEST(TimingHistoryTest, KeepsOnlyRecentSamples) {
+    TimingHistory history(4);
+    EXPECT_FLOAT_EQ(history.percentile(50.0f), 0.0f);
+    for (int i = 1; i <= 6; i++) history.add(static_cast<float>(i));
+    // 只剩3, 4, 5, 6
+    EXPECT_EQ(history.size(), 4u);
+    EXPECT_FLOAT_EQ(history.latest(), 6.0f);
+    EXPECT_FLOAT_EQ(history.average(), 4.5f);
+    EXPECT_FLOAT_EQ(history.percentile(0.0f), 3.0f);
+}
+
+TEST(ChromeTraceTest, WritesEscapedEvents) {
+    std::ostringstream out;
+    {
+        ChromeTraceWriter writer(out);
+        writer.setThreadName(1, 2, "GPU");
+        writer.addComplete("shadow \"cascade\"", 1, 2, 12345678.5, 250.0);
+        writer.addCounter("gpu ms", 1, 12345678.5, 3.25);
+    }
+    const std::string json = out.str();
+    EXPECT_EQ(json.rfind("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[", 0), 0u);
+    EXPECT_NE(json.find("\"name\":\"shadow \\\"cascade\\\"\""), std::string::npos);
+    // 长时间戳不能变成科学计数法
+    EXPECT_NE(json.find("\"ts\":12345678.500"), std::string::npos);
+    EXPECT_NE(json.find("\"dur\":250.000"), std::string::npos);
+    EXPECT_EQ(json.substr(json.size() - 4), "\n]}\n");
+}
+
+TEST(CpuTracerTest, RingDropsWhenFull) {
+    auto ring = std::make_unique<CpuScopeRing>();
+    for (size_t i = 0; i < CpuScopeRing::capacity; i++) EXPECT_TRUE(ring->push("scope", i, i + 1));
+    EXPECT_FALSE(ring->push("scope", 0, 1));
+    EXPECT_EQ(ring->getDroppedCount(), 1u);
+
+    std::vector<CpuScopeEvent> events;
+    EXPECT_EQ(ring->drain(events), CpuScopeRing::capacity);
+    EXPECT_EQ(events.back().begin, CpuScopeRing::capacity - 1);
+    // 取出之后又可以写入
+    EXPECT_TRUE(ring->push("scope", 7, 8));
+    events.clear();
+    EXPECT_EQ(ring->drain(events), 1u);
+    EXPECT_EQ(events[0].begin, 7u);
+}
+
+TEST(CpuTracerTest, CollectsScopesFromThreads) {
+    CpuTracer& tracer = CpuTracer::getInstance();
+    tracer.clear();
+    // 收集线程与工作线程同时运行
+    tracer.start("", std::chrono::milliseconds(1));
+    std::vector<std::thread> workers;
+    for (int t = 0; t < 4; t++) {
+        workers.emplace_back([] {
+            CpuTracer::setThreadName("worker");
+            for (int i = 0; i < 1000; i++) {
+                CpuProfileScope scope("work");
+            }
+        });
+    }
+    for (std::thread& worker : workers) worker.join();
+    tracer.stop();
+    EXPECT_EQ(tracer.getEventCount(), 4000u);
+
+    std::ostringstream out;
+    {
+        ChromeTraceWriter writer(out);
+        tracer.writeChromeTrace(writer, 1, 16);
+    }
+    EXPECT_NE(out.str().find("\"name\":\"work\""), std::string::npos);
+    EXPECT_NE(out.str().find("\"name\":\"worker\""), std::string::npos);
+    tracer.clear();
+}
+
+TEST(CpuTracerTest, ScopeOverhead) {
+    CpuTracer& tracer = CpuTracer::getInstance();
+    tracer.collect();
+    // 每轮不超过缓冲容量, 只测写入路径而不是写满后的丢弃路径
+    constexpr int rounds = 32, iterations = static_cast<int>(CpuScopeRing::capacity / 2);
+    double record_ns = 0.0, scope_ns = 0.0;
+    for (int round = 0; round < rounds; round++) {
+        auto begin = std::chrono::steady_clock::now();
+        for (int i = 0; i < iterations; i++) CpuTracer::record("overhead", i, i + 1);
+        record_ns += std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - begin).count();
+        tracer.collect();
+        begin = std::chrono::steady_clock::now();
+        for (int i = 0; i < iterations; i++) {
+            CpuProfileScope scope("overhead");
+        }
+        scope_ns += std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - begin).count();
+        tracer.collect();
+    }
+    tracer.clear();
+    record_ns /= rounds * iterations;
+    scope_ns /= rounds * iterations;
+#if defined(__OPTIMIZE__)
+    // 未优化的调试构建里内联函数不展开, 只在优化构建中检查. 完整的作用域还包括两次读时钟,
+    // 虚拟机里rdtsc可能被截获而慢得多, 与黄金图像测试一样可以用LUNAR_PERF_BUDGET_SCALE放宽
+    double scale = 1.0;
+    if (const char* value = std::getenv("LUNAR_PERF_BUDGET_SCALE")) scale = std::max(std::strtod(value, nullptr), 0.0);
+    const double budget_ns = 20.0 * (scale > 0.0 ? scale : 1.0);
+    EXPECT_LT(record_ns, budget_ns) << "CpuTracer::record took " << record_ns << " ns";
+    EXPECT_LT(scope_ns, budget_ns) << "CpuProfileScope took " << scope_ns << " ns, budget " << budget_ns << " ns";
+#else
+    (void)record_ns;
+    (void)scope_ns;
+#endif
+}
+
+TEST(HitchRecorderTest, DumpsWindowOnSpike) {
+    const std::filesystem::path directory = std::filesystem::temp_directory_path() / "lunar-hitch-test";
+    std::filesystem::remove_all(directory);
+    std::filesystem::create_directories(directory);
+
+    HitchRecorder recorder(100);
+    recorder.setThreshold(2.0f, 10.0f);
+    recorder.setOutputDirectory(directory.string());
+    recorder.setDumpDelay(0);
+    for (size_t i = 0; i < HitchRecorder::warmup_frames; i++) {
+        recorder.beginFrame();
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        EXPECT_FALSE(recorder.endFrame());
+    }
+    EXPECT_EQ(recorder.getDumpCount(), 0u);
+
+    recorder.beginFrame();
+    FrameCounters::add(FrameCounter::DrawCalls, 5);
+    std::this_thread::sleep_for(std::chrono::milliseconds(30));
+    EXPECT_TRUE(recorder.endFrame());
+
+    const HitchFrameRecord& frame = recorder.getFrame(0);
+    EXPECT_TRUE(frame.hitch);
+    EXPECT_EQ(frame.counters[static_cast<size_t>(FrameCounter::DrawCalls)], 5u);
+    EXPECT_GT(frame.frame_ms, 2.0f * frame.median_ms);
+    ASSERT_EQ(recorder.getDumpCount(), 1u);
+    std::ifstream file(recorder.getLastDumpPath());
+    const std::string json((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    EXPECT_NE(json.find("HITCH frame " + std::to_string(frame.index)), std::string::npos);
+    std::filesystem::remove_all(directory);
+}
@@ -0,0 +1,85 @@
+#include <gtest/gtest.h>
+#include "render/render_graph.hpp"
+
+using namespace lunar;
+
+// 只测试编译阶段, 不需要OpenGL上下文
+class RenderGraphTest : public ::testing::Test {
+protected:
+    static constexpr TextureDesc full{GL_RGBA8, 1920, 1080};
+
+    // scene -> blur_a -> blur_b -> present, 外加一个输出没人用的debug pass
+    void declareFrame(RenderGraph& graph) {
+        graph.reset();
+        RenderResource backbuffer = graph.importFramebuffer("backbuffer", 0, full);
+        RenderResource scene = graph.createTexture("scene", full);
+        RenderResource blur_a = graph.createTexture("blur_a", full);
+        RenderResource blur_b = graph.createTexture("blur_b", full);
+        RenderResource debug = graph.createTexture("debug", full);
+        graph.addPass("scene", [&](RenderPassBuilder& builder) { builder.write(scene); }, nullptr);
+        graph.addPass("debug", [&](RenderPassBuilder& builder) {
+            builder.read(scene);
+            builder.write(debug);
+        }, nullptr);
+        graph.addPass("blur_a", [&](RenderPassBuilder& builder) {
+            builder.read(scene);
+            builder.write(blur_a, Access::ImageWrite);
+        }, nullptr);
+        graph.addPass("blur_b", [&](RenderPassBuilder& builder) {
+            builder.read(blur_a);
+            builder.write(blur_b);
+        }, nullptr);
+        graph.addPass("present", [&](RenderPassBuilder& builder) {
+            builder.read(blur_b);
+            builder.write(backbuffer);
+        }, nullptr);
+        resources = {scene, blur_a, blur_b, debug};
+    }
+
+    std::vector<RenderResource> resources;
+};
+
+TEST_F(RenderGraphTest, CullsUnusedPasses) {
+    RenderGraph graph;
+    declareFrame(graph);
+    EXPECT_TRUE(graph.compile());
+    EXPECT_TRUE(graph.isPassCulled("debug"));
+    EXPECT_FALSE(graph.isPassCulled("scene"));
+    EXPECT_FALSE(graph.isPassCulled("present"));
+    EXPECT_EQ(graph.getStats().culled_pass_count, 1u);
+    EXPECT_EQ(graph.getPhysicalSlot(resources[3]), -1);
+}
+
+TEST_F(RenderGraphTest, AliasesDisjointLifetimes) {
+    RenderGraph graph;
+    declareFrame(graph);
+    graph.compile();
+    const RenderGraphStats& stats = graph.getStats();
+    // scene在blur_a之后不再使用, blur_b可以复用它的纹理
+    EXPECT_EQ(stats.transient_count, 3u);
+    EXPECT_EQ(stats.physical_count, 2u);
+    EXPECT_EQ(graph.getPhysicalSlot(resources[0]), graph.getPhysicalSlot(resources[2]));
+    EXPECT_NE(graph.getPhysicalSlot(resources[0]), graph.getPhysicalSlot(resources[1]));
+    const size_t texture_bytes = 4u * 1920u * 1080u;
+    EXPECT_EQ(stats.unaliased_bytes, 3 * texture_bytes);
+    EXPECT_EQ(stats.allocated_bytes, 2 * texture_bytes);
+    EXPECT_EQ(stats.peak_live_bytes, 2 * texture_bytes);
+}
+
+TEST_F(RenderGraphTest, MinimalBarriersAndCaching) {
+    RenderGraph graph;
+    declareFrame(graph);
+    EXPECT_TRUE(graph.compile());
+    // 只有imageStore之后的采样需要屏障; blur_b与scene共用同一个纹理, 不需要重新绑定帧缓冲
+    EXPECT_EQ(graph.getStats().barrier_count, 1u);
+    EXPECT_EQ(graph.getStats().framebuffer_bind_count, 2u);
+
+    // 结构不变时复用编译结果
+    declareFrame(graph);
+    EXPECT_FALSE(graph.compile());
+    graph.reset();
+    RenderResource backbuffer = graph.importFramebuffer("backbuffer", 0, full);
+    graph.addPass("present", [&](RenderPassBuilder& builder) { builder.write(backbuffer); }, nullptr);
+    EXPECT_TRUE(graph.compile());
+    EXPECT_EQ(graph.getStats().transient_count, 0u);
+}